@@ -3,9 +3,11 @@
 
 #include <base/vmath.h>
 
+#include <atomic>
+
 enum
 {
-	ANTIBOT_ABI_VERSION = 9,
+	ANTIBOT_ABI_VERSION = 10,
 
 	ANTIBOT_MSGFLAG_NONVITAL = 1,
 	ANTIBOT_MSGFLAG_FLUSH = 2,
@@ -67,6 +69,7 @@ struct CAntibotVersion
 	int m_SizeInputData;
 	int m_SizeMapData;
 	int m_SizeRoundData;
+	int m_SizeEvent;
 };
 
 #define ANTIBOT_VERSION \
@@ -79,6 +82,7 @@ struct CAntibotVersion
 			sizeof(CAntibotInputData), \
 			sizeof(CAntibotMapData), \
 			sizeof(CAntibotRoundData), \
+			sizeof(CAntibotEvent), \
 	}
 
 struct CAntibotData
@@ -102,4 +106,77 @@ struct CAntibotRoundData
 	CAntibotMapData m_Map;
 };
 
+enum
+{
+	ANTIBOT_EVENT_PLAYER_INIT,
+	ANTIBOT_EVENT_PLAYER_DESTROY,
+	ANTIBOT_EVENT_SPAWN,
+	ANTIBOT_EVENT_HAMMER_FIRE_RELOADING,
+	ANTIBOT_EVENT_HAMMER_FIRE,
+	ANTIBOT_EVENT_HAMMER_HIT,
+	ANTIBOT_EVENT_DIRECT_INPUT,
+	ANTIBOT_EVENT_CHARACTER_TICK,
+	ANTIBOT_EVENT_HOOK_ATTACH,
+	ANTIBOT_EVENT_ENGINE_CLIENT_JOIN,
+	ANTIBOT_EVENT_ENGINE_CLIENT_DROP,
+	ANTIBOT_EVENT_ENGINE_SERVER_MESSAGE,
+
+	ANTIBOT_EVENT_DATA_SIZE = 64,
+};
+
+struct CAntibotEvent
+{
+	int m_Type;
+	int m_ClientId;
+	int m_Tick;
+	// Target id for hammer hits, whether a player was hooked, whether the
+	// client uses 0.7 on join or the message size for server messages.
+	int m_Arg;
+	// ANTIBOT_MSGFLAG_* for server messages.
+	int m_Flags;
+	// State of the character after the event, only for character events.
+	CAntibotCharacterData m_Character;
+	// Start of the server message or the drop reason, truncated.
+	unsigned char m_aData[ANTIBOT_EVENT_DATA_SIZE];
+};
+
+// Single-producer single-consumer ring the engine appends events to on the
+// tick thread. New events are published once per engine tick, right before
+// AntibotOnEngineTick is called, the module can consume them on any thread.
+// Events that don't fit into the ring are dropped and counted.
+struct CAntibotEventRing
+{
+	CAntibotEvent *m_pEvents;
+	unsigned m_Size; // power of two
+
+	std::atomic<unsigned> m_Published; // written by the engine
+	std::atomic<unsigned> m_Consumed; // written by the module
+	std::atomic<unsigned> m_NumDropped;
+	unsigned m_Pending; // only used by the engine
+
+	// Engine side, returns the event to fill or null if the ring is full.
+	CAntibotEvent *Push()
+	{
+		if(m_Pending - m_Consumed.load(std::memory_order_acquire) >= m_Size)
+		{
+			m_NumDropped.fetch_add(1, std::memory_order_relaxed);
+			return nullptr;
+		}
+		return &m_pEvents[m_Pending++ & (m_Size - 1)];
+	}
+	void Publish() { m_Published.store(m_Pending, std::memory_order_release); }
+
+	// Module side, calls Consumer for every published event.
+	template<typename F>
+	unsigned Consume(F &&Consumer)
+	{
+		const unsigned Consumed = m_Consumed.load(std::memory_order_relaxed);
+		const unsigned Published = m_Published.load(std::memory_order_acquire);
+		for(unsigned i = Consumed; i != Published; i++)
+			Consumer(m_pEvents[i & (m_Size - 1)]);
+		m_Consumed.store(Published, std::memory_order_release);
+		return Published - Consumed;
+	}
+};
+
 #endif // ANTIBOT_ANTIBOT_DATA_H
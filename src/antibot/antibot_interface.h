@@ -12,6 +12,12 @@ extern "C" {
 
 ANTIBOTAPI int AntibotAbiVersion();
 ANTIBOTAPI void AntibotInit(CAntibotData *pCallbackData);
+// Returns true if the module consumes the events from the ring instead of
+// getting the synchronous player, character, client join/drop and server
+// message callbacks. Client messages are still filtered synchronously and
+// AntibotOnEngineTick is still called once the events of a tick are
+// published. The round data is then only updated for the synchronous calls.
+ANTIBOTAPI bool AntibotInitEvents(CAntibotEventRing *pRing);
 ANTIBOTAPI void AntibotRoundStart(CAntibotRoundData *pRoundData);
 ANTIBOTAPI void AntibotRoundEnd(void);
 ANTIBOTAPI void AntibotUpdateData(void);
@@ -17,6 +17,7 @@ void AntibotInit(CAntibotData *pData)
 	g_pData = pData;
 	g_pData->m_pfnLog("null antibot initialized", g_pData->m_pUser);
 }
+bool AntibotInitEvents(CAntibotEventRing * /*pRing*/) { return false; }
 void AntibotRoundStart(CAntibotRoundData *pRoundData){};
 void AntibotRoundEnd(void){};
 void AntibotUpdateData(void) {}
@@ -1,5 +1,6 @@
 /* (c) Magnus Auvinen. See licence.txt in the root of the distribution for more information. */
 /* If you are missing that file, acquire a complete release at teeworlds.com.                */
+#include <algorithm>
 #include <atomic>
 #include <cctype>
 #include <charconv>
@@ -9,10 +10,12 @@
 #include <cstdarg>
 #include <cstdio>
 #include <cstring>
+#include <deque>
 #include <iomanip> // std::get_time
 #include <iterator> // std::size
 #include <sstream> // std::istringstream
 #include <string_view>
+#include <vector>
 
 #include "lock.h"
 #include "logger.h"
@@ -29,6 +32,7 @@
 #include <locale>
 #include <sys/stat.h>
 #include <sys/time.h>
+#include <sys/uio.h>
 #include <sys/utsname.h>
 #include <sys/wait.h>
 #include <unistd.h>
@@ -44,6 +48,11 @@
 
 #include <dirent.h>
 
+#if defined(CONF_PLATFORM_LINUX)
+#include <sys/epoll.h>
+#include <sys/timerfd.h>
+#endif
+
 #if defined(CONF_PLATFORM_MACOS)
 // some lock and pthread functions are already defined in headers
 // included from Carbon.h
@@ -446,23 +455,26 @@ int io_sync(IOHANDLE io)
 }
 
 #define ASYNC_BUFSIZE (8 * 1024)
-#define ASYNC_LOCAL_BUFSIZE (64 * 1024)
 
 struct ASYNCIO
 {
 	CLock lock;
 	IOHANDLE io;
-	SEMAPHORE sphore;
-	void *thread;
+	SEMAPHORE done_sphore;
 
 	unsigned char *buffer;
 	unsigned int buffer_size;
 	unsigned int read_pos;
 	unsigned int write_pos;
 
+	// buffer the worker is currently writing from, it must not be freed when growing the buffer
+	unsigned char *writing_buffer;
+
 	int error;
 	unsigned char finish;
 	unsigned char refcount;
+	bool queued;
+	bool done;
 };
 
 enum
@@ -472,6 +484,14 @@ enum
 	ASYNCIO_EXIT,
 };
 
+// all handles share a single thread which writes the queued handles in turn
+struct ASYNCIO_WORKER
+{
+	CLock lock;
+	SEMAPHORE sphore;
+	std::deque<ASYNCIO *> queue GUARDED_BY(lock);
+};
+
 struct BUFFERS
 {
 	unsigned char *buf1;
@@ -507,104 +527,178 @@ static void aio_handle_free_and_unlock(ASYNCIO *aio) RELEASE(aio->lock)
 	if(do_free)
 	{
 		free(aio->buffer);
-		sphore_destroy(&aio->sphore);
+		sphore_destroy(&aio->done_sphore);
 		delete aio;
 	}
 }
 
-static void aio_thread(void *user)
+static int aio_write_buffers(IOHANDLE io, const struct BUFFERS *buffers)
 {
-	ASYNCIO *aio = (ASYNCIO *)user;
+#if defined(CONF_FAMILY_UNIX)
+	// write both parts of the ring buffer with one syscall, without copying them first
+	struct iovec iov[2] = {{buffers->buf1, buffers->len1}, {buffers->buf2, buffers->len2}};
+	struct iovec *cur = iov;
+	int count = buffers->buf2 ? 2 : 1;
+	const int fd = fileno((FILE *)io);
+	while(count > 0)
+	{
+		ssize_t written = writev(fd, cur, count);
+		if(written < 0)
+		{
+			if(errno == EINTR)
+				continue;
+			return errno;
+		}
+		while(count > 0 && (size_t)written >= cur->iov_len)
+		{
+			written -= cur->iov_len;
+			cur++;
+			count--;
+		}
+		if(count > 0)
+		{
+			cur->iov_base = (unsigned char *)cur->iov_base + written;
+			cur->iov_len -= written;
+		}
+	}
+	return 0;
+#else
+	io_write(io, buffers->buf1, buffers->len1);
+	if(buffers->buf2)
+		io_write(io, buffers->buf2, buffers->len2);
+	io_flush(io);
+	return io_error(io);
+#endif
+}
 
-	aio->lock.lock();
+static void aio_worker_thread(void *user);
+
+static ASYNCIO_WORKER *aio_worker()
+{
+	// never freed, handles might still be written while the program exits
+	static ASYNCIO_WORKER *worker = []() -> ASYNCIO_WORKER * {
+		ASYNCIO_WORKER *new_worker = new ASYNCIO_WORKER;
+		sphore_init(&new_worker->sphore);
+		void *thread = thread_init(aio_worker_thread, new_worker, "aio");
+		if(!thread)
+		{
+			sphore_destroy(&new_worker->sphore);
+			delete new_worker;
+			return nullptr;
+		}
+		thread_detach(thread);
+		return new_worker;
+	}();
+	return worker;
+}
+
+// queues the handle for the worker if it has anything to do
+static void aio_schedule(ASYNCIO *aio) REQUIRES(aio->lock)
+{
+	if(aio->queued || aio->done)
+		return;
+	if(aio->read_pos == aio->write_pos && aio->finish == ASYNCIO_RUNNING)
+		return;
+
+	aio->queued = true;
+	ASYNCIO_WORKER *worker = aio_worker();
+	{
+		CLockScope ls(worker->lock);
+		worker->queue.push_back(aio);
+	}
+	sphore_signal(&worker->sphore);
+}
+
+static void aio_worker_thread(void *user)
+{
+	ASYNCIO_WORKER *worker = (ASYNCIO_WORKER *)user;
 	while(true)
 	{
-		struct BUFFERS buffers;
-		int result_io_error;
-		unsigned char local_buffer[ASYNC_LOCAL_BUFSIZE];
-		unsigned int local_buffer_len = 0;
+		sphore_wait(&worker->sphore);
+		ASYNCIO *aio;
+		{
+			CLockScope ls(worker->lock);
+			if(worker->queue.empty())
+				continue;
+			aio = worker->queue.front();
+			worker->queue.pop_front();
+		}
 
-		if(aio->read_pos == aio->write_pos)
+		aio->lock.lock();
+		aio->queued = false;
+		if(aio->read_pos != aio->write_pos)
 		{
-			if(aio->finish != ASYNCIO_RUNNING)
-			{
-				if(aio->finish == ASYNCIO_CLOSE)
-				{
-					io_close(aio->io);
-				}
-				aio_handle_free_and_unlock(aio);
-				break;
-			}
+			struct BUFFERS buffers;
+			buffer_ptrs(aio, &buffers);
+			aio->writing_buffer = aio->buffer;
 			aio->lock.unlock();
-			sphore_wait(&aio->sphore);
+
+			const int result_io_error = aio_write_buffers(aio->io, &buffers);
+
 			aio->lock.lock();
-			continue;
+			if(aio->writing_buffer != aio->buffer)
+			{
+				// the buffer grew while writing, its contents were moved to the new buffer
+				free(aio->writing_buffer);
+			}
+			aio->writing_buffer = nullptr;
+			aio->read_pos = (aio->read_pos + buffers.len1 + buffers.len2) % aio->buffer_size;
+			if(result_io_error)
+				aio->error = result_io_error;
 		}
 
-		buffer_ptrs(aio, &buffers);
-		if(buffers.buf1)
+		if(aio->read_pos == aio->write_pos && aio->finish != ASYNCIO_RUNNING)
 		{
-			if(buffers.len1 > sizeof(local_buffer) - local_buffer_len)
+			if(aio->finish == ASYNCIO_CLOSE)
 			{
-				buffers.len1 = sizeof(local_buffer) - local_buffer_len;
-			}
-			mem_copy(local_buffer + local_buffer_len, buffers.buf1, buffers.len1);
-			local_buffer_len += buffers.len1;
-			if(buffers.buf2)
-			{
-				if(buffers.len2 > sizeof(local_buffer) - local_buffer_len)
-				{
-					buffers.len2 = sizeof(local_buffer) - local_buffer_len;
-				}
-				mem_copy(local_buffer + local_buffer_len, buffers.buf2, buffers.len2);
-				local_buffer_len += buffers.len2;
+				io_close(aio->io);
 			}
+			aio->done = true;
+			sphore_signal(&aio->done_sphore);
+			aio_handle_free_and_unlock(aio);
+			continue;
 		}
-		aio->read_pos = (aio->read_pos + buffers.len1 + buffers.len2) % aio->buffer_size;
-		aio->lock.unlock();
 
-		io_write(aio->io, local_buffer, local_buffer_len);
-		io_flush(aio->io);
-		result_io_error = io_error(aio->io);
-
-		aio->lock.lock();
-		aio->error = result_io_error;
+		// write other handles before the rest of this one
+		aio_schedule(aio);
+		aio->lock.unlock();
 	}
 }
 
 ASYNCIO *aio_new(IOHANDLE io)
 {
+	if(!aio_worker())
+	{
+		return 0;
+	}
+
 	ASYNCIO *aio = new ASYNCIO;
 	if(!aio)
 	{
 		return 0;
 	}
 	aio->io = io;
-	sphore_init(&aio->sphore);
-	aio->thread = 0;
+	sphore_init(&aio->done_sphore);
 
 	aio->buffer = (unsigned char *)malloc(ASYNC_BUFSIZE);
 	if(!aio->buffer)
 	{
-		sphore_destroy(&aio->sphore);
+		sphore_destroy(&aio->done_sphore);
 		delete aio;
 		return 0;
 	}
 	aio->buffer_size = ASYNC_BUFSIZE;
 	aio->read_pos = 0;
 	aio->write_pos = 0;
+	aio->writing_buffer = nullptr;
 	aio->error = 0;
 	aio->finish = ASYNCIO_RUNNING;
 	aio->refcount = 2;
+	aio->queued = false;
+	aio->done = false;
 
-	aio->thread = thread_init(aio_thread, aio, "aio");
-	if(!aio->thread)
-	{
-		free(aio->buffer);
-		sphore_destroy(&aio->sphore);
-		delete aio;
-		return 0;
-	}
+	// the worker writes to the file directly, data buffered before must come first
+	io_flush(io);
 	return aio;
 }
 
@@ -636,8 +730,8 @@ void aio_lock(ASYNCIO *aio) ACQUIRE(aio->lock)
 
 void aio_unlock(ASYNCIO *aio) RELEASE(aio->lock)
 {
+	aio_schedule(aio);
 	aio->lock.unlock();
-	sphore_signal(&aio->sphore);
 }
 
 void aio_write_unlocked(ASYNCIO *aio, const void *buffer, unsigned size)
@@ -682,7 +776,10 @@ void aio_write_unlocked(ASYNCIO *aio, const void *buffer, unsigned size)
 		mem_copy(next_buffer + next_len, buffer, size);
 		next_len += size;
 
-		free(aio->buffer);
+		if(aio->buffer != aio->writing_buffer)
+		{
+			free(aio->buffer);
+		}
 		aio->buffer = next_buffer;
 		aio->buffer_size = next_size;
 		aio->read_pos = 0;
@@ -722,37 +819,29 @@ int aio_error(ASYNCIO *aio)
 void aio_free(ASYNCIO *aio)
 {
 	aio->lock.lock();
-	if(aio->thread)
-	{
-		thread_detach(aio->thread);
-		aio->thread = 0;
-	}
 	aio_handle_free_and_unlock(aio);
 }
 
 void aio_close(ASYNCIO *aio)
 {
-	{
-		CLockScope ls(aio->lock);
-		aio->finish = ASYNCIO_CLOSE;
-	}
-	sphore_signal(&aio->sphore);
+	CLockScope ls(aio->lock);
+	aio->finish = ASYNCIO_CLOSE;
+	aio_schedule(aio);
 }
 
 void aio_wait(ASYNCIO *aio)
 {
-	void *thread;
 	{
 		CLockScope ls(aio->lock);
-		thread = aio->thread;
-		aio->thread = 0;
 		if(aio->finish == ASYNCIO_RUNNING)
 		{
 			aio->finish = ASYNCIO_EXIT;
 		}
+		aio_schedule(aio);
 	}
-	sphore_signal(&aio->sphore);
-	thread_wait(thread);
+	sphore_wait(&aio->done_sphore);
+	// let further waits return immediately
+	sphore_signal(&aio->done_sphore);
 }
 
 struct THREAD_RUN
@@ -2597,6 +2686,172 @@ int net_socket_read_wait(NETSOCKET sock, int time)
 	return 0;
 }
 
+struct NETWAIT_INTERNAL
+{
+	std::vector<int> fds;
+#if defined(CONF_PLATFORM_LINUX)
+	int epoll_fd;
+	int timer_fd;
+	std::vector<int> registered;
+	std::vector<epoll_event> events;
+#endif
+};
+
+NETWAIT *net_wait_create()
+{
+	NETWAIT *wait = new NETWAIT;
+#if defined(CONF_PLATFORM_LINUX)
+	wait->epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+	wait->timer_fd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+	if(wait->epoll_fd < 0 || wait->timer_fd < 0)
+	{
+		dbg_msg("net", "failed to create epoll or timer fd (%d '%s')", errno, strerror(errno));
+	}
+	else
+	{
+		epoll_event event = {};
+		event.events = EPOLLIN;
+		event.data.fd = wait->timer_fd;
+		epoll_ctl(wait->epoll_fd, EPOLL_CTL_ADD, wait->timer_fd, &event);
+	}
+#endif
+	return wait;
+}
+
+void net_wait_free(NETWAIT *wait)
+{
+#if defined(CONF_PLATFORM_LINUX)
+	if(wait->timer_fd >= 0)
+		close(wait->timer_fd);
+	if(wait->epoll_fd >= 0)
+		close(wait->epoll_fd);
+#endif
+	delete wait;
+}
+
+void net_wait_add_socket(NETWAIT *wait, NETSOCKET sock)
+{
+	if(sock->ipv4sock >= 0)
+		wait->fds.push_back(sock->ipv4sock);
+	if(sock->ipv6sock >= 0)
+		wait->fds.push_back(sock->ipv6sock);
+#if defined(CONF_WEBSOCKETS)
+	if(sock->web_ipv4sock >= 0)
+		websocket_fds(sock->web_ipv4sock, wait->fds);
+#endif
+}
+
+#if defined(CONF_FAMILY_UNIX)
+void net_wait_add_fd(NETWAIT *wait, int fd)
+{
+	if(fd >= 0)
+		wait->fds.push_back(fd);
+}
+#endif
+
+static int net_wait_select(NETWAIT *wait, int64_t deadline)
+{
+	fd_set readfds;
+	FD_ZERO(&readfds);
+	int maxfd = -1;
+	for(int fd : wait->fds)
+	{
+		FD_SET(fd, &readfds);
+		if(fd > maxfd)
+			maxfd = fd;
+	}
+
+	struct timeval tv;
+	struct timeval *timeout = nullptr;
+	if(deadline >= 0)
+	{
+		// round up so we don't wake up right before the deadline
+		int64_t us = (deadline - time_get_impl() + 999) / 1000;
+		if(us < 0)
+			us = 0;
+		tv.tv_sec = us / 1000000;
+		tv.tv_usec = us % 1000000;
+		timeout = &tv;
+	}
+	return select(maxfd + 1, &readfds, NULL, NULL, timeout);
+}
+
+int net_wait(NETWAIT *wait, int64_t deadline)
+{
+	std::sort(wait->fds.begin(), wait->fds.end());
+	wait->fds.erase(std::unique(wait->fds.begin(), wait->fds.end()), wait->fds.end());
+
+#if defined(CONF_PLATFORM_LINUX)
+	if(wait->epoll_fd < 0 || wait->timer_fd < 0)
+	{
+		const int result = net_wait_select(wait, deadline);
+		wait->fds.clear();
+		return result;
+	}
+
+	for(int fd : wait->registered)
+	{
+		if(!std::binary_search(wait->fds.begin(), wait->fds.end(), fd))
+			epoll_ctl(wait->epoll_fd, EPOLL_CTL_DEL, fd, nullptr);
+	}
+	// sockets can be closed and their fd reused between two waits, in which
+	// case the kernel already removed them, so re-add every fd
+	for(int fd : wait->fds)
+	{
+		epoll_event event = {};
+		event.events = EPOLLIN;
+		event.data.fd = fd;
+		if(epoll_ctl(wait->epoll_fd, EPOLL_CTL_ADD, fd, &event) != 0 && errno != EEXIST)
+			dbg_msg("net", "failed to add fd to epoll (%d '%s')", errno, strerror(errno));
+	}
+	std::swap(wait->registered, wait->fds);
+	wait->fds.clear();
+
+	itimerspec timer = {};
+	int timeout = -1;
+	if(deadline >= 0)
+	{
+		const int64_t remaining = deadline - time_get_impl();
+		if(remaining <= 0)
+			timeout = 0;
+		timespec now;
+		clock_gettime(CLOCK_MONOTONIC, &now);
+		const int64_t expiry = now.tv_sec * (int64_t)1000000000 + now.tv_nsec + remaining;
+		timer.it_value.tv_sec = expiry / 1000000000;
+		timer.it_value.tv_nsec = expiry % 1000000000;
+	}
+	// an all-zero timer disarms it, setting the timer also discards expirations
+	// that weren't read yet
+	if(timeout != 0)
+		timerfd_settime(wait->timer_fd, TFD_TIMER_ABSTIME, &timer, nullptr);
+
+	wait->events.resize(wait->registered.size() + 1);
+	const int num_events = epoll_wait(wait->epoll_fd, wait->events.data(), wait->events.size(), timeout);
+	if(num_events < 0)
+		return errno == EINTR ? 0 : -1;
+
+	int readable = 0;
+	for(int i = 0; i < num_events; i++)
+	{
+		if(wait->events[i].data.fd == wait->timer_fd)
+		{
+			uint64_t expirations;
+			if(read(wait->timer_fd, &expirations, sizeof(expirations)) < 0 && errno != EAGAIN)
+				dbg_msg("net", "failed to read timer fd (%d '%s')", errno, strerror(errno));
+		}
+		else
+		{
+			readable++;
+		}
+	}
+	return readable;
+#else
+	const int result = net_wait_select(wait, deadline);
+	wait->fds.clear();
+	return result;
+#endif
+}
+
 int64_t time_timestamp()
 {
 	return time(0);
@@ -2112,6 +2112,56 @@ int net_would_block();
 
 int net_socket_read_wait(NETSOCKET sock, int time);
 
+/**
+ * Creates a waiter which blocks until one of several sockets or files becomes
+ * readable or a deadline is reached.
+ *
+ * @ingroup Network-General
+ *
+ * @return The new waiter, free it with @link net_wait_free @endlink.
+ *
+ * @remark Uses epoll and a timerfd on Linux, which wake up at the deadline with
+ * sub-millisecond precision. Other platforms fall back to `select`.
+ */
+NETWAIT *net_wait_create();
+
+/**
+ * Frees a waiter created with @link net_wait_create @endlink.
+ *
+ * @ingroup Network-General
+ */
+void net_wait_free(NETWAIT *wait);
+
+/**
+ * Adds a socket to the next @link net_wait @endlink call, including the
+ * connections of its websocket if it has one.
+ *
+ * @ingroup Network-General
+ */
+void net_wait_add_socket(NETWAIT *wait, NETSOCKET sock);
+
+#if defined(CONF_FAMILY_UNIX)
+/**
+ * Adds a file descriptor, e.g. of a fifo, to the next @link net_wait @endlink call.
+ *
+ * @ingroup Network-General
+ */
+void net_wait_add_fd(NETWAIT *wait, int fd);
+#endif
+
+/**
+ * Waits until one of the added sockets or files becomes readable or the deadline
+ * is reached. The added sockets and files are cleared afterwards.
+ *
+ * @ingroup Network-General
+ *
+ * @param wait The waiter.
+ * @param deadline Value of @link time_get @endlink to wait for, or `-1` to wait indefinitely.
+ *
+ * @return Number of readable sockets and files, `0` if the deadline was reached, `-1` on error.
+ */
+int net_wait(NETWAIT *wait, int64_t deadline);
+
 /**
  * Swaps the endianness of data. Each element is swapped individually by reversing its bytes.
  *
@@ -27,6 +27,7 @@ typedef int (*FS_LISTDIR_CALLBACK_FILEINFO)(const CFsFileInfo *info, int is_dir,
  * @ingroup Network-General
  */
 typedef struct NETSOCKET_INTERNAL *NETSOCKET;
+typedef struct NETWAIT_INTERNAL NETWAIT;
 
 enum
 {
@@ -298,6 +298,7 @@ public:
 	virtual void GenerateTimeoutSeed() = 0;
 
 	virtual IFriends *Foes() = 0;
+	virtual class CTraceRecorder *TraceRecorder() = 0;
 
 	virtual void GetSmoothTick(int *pSmoothTick, float *pSmoothIntraTick, float MixAmount) = 0;
 
@@ -384,6 +385,8 @@ public:
 
 	virtual bool CanDisplayWarning() const = 0;
 	virtual void RenderShutdownMessage() = 0;
+	// Waits for map data that is still being prepared in the background after loading a map
+	virtual void FinishMapLoad() = 0;
 
 	virtual CNetObjHandler *GetNetObjHandler() = 0;
 	virtual protocol7::CNetObjHandler *GetNetObjHandler7() = 0;
@@ -33,6 +33,7 @@
 #include <engine/shared/fifo.h>
 #include <engine/shared/filecollection.h>
 #include <engine/shared/http.h>
+#include <engine/shared/jsonwriter.h>
 #include <engine/shared/masterserver.h>
 #include <engine/shared/network.h>
 #include <engine/shared/packer.h>
@@ -41,6 +42,7 @@
 #include <engine/shared/protocol_ex.h>
 #include <engine/shared/rust_version.h>
 #include <engine/shared/snapshot.h>
+#include <engine/shared/trace.h>
 #include <engine/shared/uuid_manager.h>
 
 #include <game/generated/protocol.h>
@@ -2176,6 +2178,7 @@ void CClient::ProcessServerPacket(CNetChunk *pPacket, int Conn, bool Dummy)
 
 int CClient::UnpackAndValidateSnapshot(CSnapshot *pFrom, CSnapshot *pTo)
 {
+	CTraceScope TraceScope(&m_TraceRecorder, "UnpackAndValidateSnapshot");
 	CUnpacker Unpacker;
 	CSnapshotBuilder Builder;
 	Builder.Init();
@@ -3088,6 +3091,13 @@ void CClient::Run()
 			m_aCmdPlayDemo[0] = 0;
 		}
 
+		// handle pending demo benchmark
+		if(m_aCmdBenchmarkDemo[0])
+		{
+			StartDemoBenchmark();
+			m_aCmdBenchmarkDemo[0] = 0;
+		}
+
 		// handle pending map edits
 		if(m_aCmdEditMap[0])
 		{
@@ -3111,7 +3121,10 @@ void CClient::Run()
 		}
 
 		// update input
-		if(Input()->Update())
+		m_TraceRecorder.Begin("Input");
+		const bool InputQuit = Input()->Update();
+		m_TraceRecorder.End("Input");
+		if(InputQuit)
 		{
 			if(State() == IClient::STATE_QUITTING)
 				break;
@@ -3135,7 +3148,10 @@ void CClient::Run()
 #endif
 
 		// update sound
-		Sound()->Update();
+		{
+			CTraceScope TraceScope(&m_TraceRecorder, "Sound");
+			Sound()->Update();
+		}
 
 		if(CtrlShiftKey(KEY_D, LastD))
 			g_Config.m_Debug ^= 1;
@@ -3152,6 +3168,7 @@ void CClient::Run()
 
 		// render
 		{
+			CTraceScope FrameTraceScope(&m_TraceRecorder, "Frame");
 			if(g_Config.m_ClEditor)
 			{
 				if(!m_EditorActive)
@@ -3167,7 +3184,10 @@ void CClient::Run()
 				m_EditorActive = false;
 			}
 
-			Update();
+			{
+				CTraceScope TraceScope(&m_TraceRecorder, "Update");
+				Update();
+			}
 			int64_t Now = time_get();
 
 			bool IsRenderActive = (g_Config.m_GfxBackgroundRender || m_pGraphics->WindowOpen());
@@ -3176,6 +3196,13 @@ void CClient::Run()
 
 			int GfxRefreshRate = g_Config.m_GfxRefreshRate;
 
+			// render every frame of the benchmark
+			if(m_BenchmarkDemoActive)
+			{
+				AsyncRenderOld = false;
+				GfxRefreshRate = 0;
+			}
+
 #if defined(CONF_VIDEORECORDER)
 			// keep rendering synced
 			if(IVideo::Current())
@@ -3216,14 +3243,20 @@ void CClient::Run()
 				LastRenderTime = Now - AdditionalTime;
 				m_LastRenderTime = Now;
 
-				if(!m_EditorActive)
-					Render();
-				else
 				{
-					m_pEditor->OnRender();
-					DebugRender();
+					CTraceScope TraceScope(&m_TraceRecorder, "Render");
+					if(!m_EditorActive)
+						Render();
+					else
+					{
+						m_pEditor->OnRender();
+						DebugRender();
+					}
+				}
+				{
+					CTraceScope TraceScope(&m_TraceRecorder, "Swap");
+					m_pGraphics->Swap();
 				}
-				m_pGraphics->Swap();
 			}
 			else if(!IsRenderActive)
 			{
@@ -3232,6 +3265,9 @@ void CClient::Run()
 			}
 		}
 
+		if(m_BenchmarkDemoActive)
+			UpdateDemoBenchmark();
+
 		AutoScreenshot_Cleanup();
 		AutoStatScreenshot_Cleanup();
 		AutoCSV_Cleanup();
@@ -3245,7 +3281,11 @@ void CClient::Run()
 		auto Now = time_get_nanoseconds();
 		decltype(Now) SleepTimeInNanoSeconds{0};
 		bool Slept = false;
-		if(g_Config.m_ClRefreshRateInactive && !m_pGraphics->WindowActive())
+		if(m_BenchmarkDemoActive)
+		{
+			// run as fast as possible, the demo advances by a fixed step per frame
+		}
+		else if(g_Config.m_ClRefreshRateInactive && !m_pGraphics->WindowActive())
 		{
 			SleepTimeInNanoSeconds = (std::chrono::nanoseconds(1s) / (int64_t)g_Config.m_ClRefreshRateInactive) - (Now - LastTime);
 			std::this_thread::sleep_for(SleepTimeInNanoSeconds);
@@ -4033,6 +4073,168 @@ void CClient::BenchmarkQuit(int Seconds, const char *pFilename)
 	m_BenchmarkStopTime = time_get() + time_freq() * Seconds;
 }
 
+void CClient::Con_BenchmarkDemo(IConsole::IResult *pResult, void *pUserData)
+{
+	CClient *pSelf = (CClient *)pUserData;
+	str_copy(pSelf->m_aCmdBenchmarkDemo, pResult->GetString(0));
+	pSelf->m_BenchmarkDemoFps = pResult->NumArguments() > 1 ? clamp(pResult->GetInteger(1), 1, 1000) : 60;
+	if(pResult->NumArguments() > 2)
+	{
+		str_copy(pSelf->m_aBenchmarkDemoOutput, pResult->GetString(2));
+	}
+	else
+	{
+		char aDate[64];
+		str_timestamp(aDate, sizeof(aDate));
+		str_format(pSelf->m_aBenchmarkDemoOutput, sizeof(pSelf->m_aBenchmarkDemoOutput), "dumps/benchmark_%s.json", aDate);
+	}
+}
+
+void CClient::StartDemoBenchmark()
+{
+	const char *pError = DemoPlayer_Play(m_aCmdBenchmarkDemo, IStorage::TYPE_ALL_OR_ABSOLUTE);
+	if(pError)
+	{
+		log_error("benchmark", "playing demo '%s' failed: %s", m_aCmdBenchmarkDemo, pError);
+		Quit();
+		return;
+	}
+
+	m_DemoPlayer.SetFixedTimestep(time_freq() / m_BenchmarkDemoFps);
+	// tile layers are built in the background, the first frames must not depend on when they finish
+	GameClient()->FinishMapLoad();
+	m_TraceRecorder.SetEnabled(true, g_Config.m_DbgTraceEvents);
+	m_TraceRecorder.Clear();
+	m_BenchmarkDemoSummary.Reset();
+	m_BenchmarkDemoActive = true;
+	m_BenchmarkDemoFrames = 0;
+	m_BenchmarkDemoStartTime = time_get();
+	m_BenchmarkDemoFirstStats = m_pGraphics->SubmitStats();
+	m_BenchmarkDemoLastStats = m_BenchmarkDemoFirstStats;
+	m_BenchmarkDemoMaxRenderCalls = 0;
+	m_BenchmarkDemoMaxCommandBytes = 0;
+	log_info("benchmark", "benchmarking demo '%s' at %d fps", m_aCmdBenchmarkDemo, m_BenchmarkDemoFps);
+}
+
+void CClient::UpdateDemoBenchmark()
+{
+	m_BenchmarkDemoSummary.Add(m_TraceRecorder);
+	m_TraceRecorder.Clear();
+
+	const IEngineGraphics::CSubmitStats &Stats = m_pGraphics->SubmitStats();
+	m_BenchmarkDemoMaxRenderCalls = maximum(m_BenchmarkDemoMaxRenderCalls, Stats.m_NumRenderCalls - m_BenchmarkDemoLastStats.m_NumRenderCalls);
+	m_BenchmarkDemoMaxCommandBytes = maximum(m_BenchmarkDemoMaxCommandBytes, Stats.m_CommandBytes - m_BenchmarkDemoLastStats.m_CommandBytes);
+	m_BenchmarkDemoLastStats = Stats;
+	m_BenchmarkDemoFrames++;
+
+	// the demo player pauses at the end of the demo
+	if(!m_DemoPlayer.IsPlaying() || m_DemoPlayer.BaseInfo()->m_Paused)
+		FinishDemoBenchmark();
+}
+
+void CClient::FinishDemoBenchmark()
+{
+	m_BenchmarkDemoActive = false;
+	m_DemoPlayer.SetFixedTimestep(0);
+	m_TraceRecorder.SetEnabled(g_Config.m_DbgTrace, g_Config.m_DbgTraceEvents);
+	m_TraceRecorder.Clear();
+	Quit();
+
+	IOHANDLE File = Storage()->OpenFile(m_aBenchmarkDemoOutput, IOFLAG_WRITE, IStorage::TYPE_SAVE);
+	if(!File)
+	{
+		log_error("benchmark", "failed to open '%s' for writing", m_aBenchmarkDemoOutput);
+		return;
+	}
+
+	const int64_t Frames = maximum<int64_t>(m_BenchmarkDemoFrames, 1);
+	const IEngineGraphics::CSubmitStats &First = m_BenchmarkDemoFirstStats;
+	const IEngineGraphics::CSubmitStats &Last = m_BenchmarkDemoLastStats;
+
+	CJsonFileWriter Writer(File);
+	Writer.BeginObject();
+	Writer.WriteAttribute("demo");
+	Writer.WriteStrValue(m_DemoPlayer.Filename());
+	Writer.WriteAttribute("fps");
+	Writer.WriteIntValue(m_BenchmarkDemoFps);
+	Writer.WriteAttribute("frames");
+	Writer.WriteIntValue(m_BenchmarkDemoFrames);
+	Writer.WriteAttribute("wall_time_ms");
+	Writer.WriteIntValue((time_get() - m_BenchmarkDemoStartTime) * 1000 / time_freq());
+
+	// all values are per frame, except for the buffer peaks
+	Writer.WriteAttribute("graphics");
+	Writer.BeginObject();
+	Writer.WriteAttribute("command_buffers_avg");
+	Writer.WriteIntValue((Last.m_NumBuffers - First.m_NumBuffers) / Frames);
+	Writer.WriteAttribute("commands_avg");
+	Writer.WriteIntValue((Last.m_NumCommands - First.m_NumCommands) / Frames);
+	Writer.WriteAttribute("render_calls_avg");
+	Writer.WriteIntValue((Last.m_NumRenderCalls - First.m_NumRenderCalls) / Frames);
+	Writer.WriteAttribute("render_calls_max");
+	Writer.WriteIntValue(m_BenchmarkDemoMaxRenderCalls);
+	Writer.WriteAttribute("command_bytes_avg");
+	Writer.WriteIntValue((Last.m_CommandBytes - First.m_CommandBytes) / Frames);
+	Writer.WriteAttribute("command_bytes_max");
+	Writer.WriteIntValue(m_BenchmarkDemoMaxCommandBytes);
+	Writer.WriteAttribute("data_bytes_avg");
+	Writer.WriteIntValue((Last.m_DataBytes - First.m_DataBytes) / Frames);
+	Writer.WriteAttribute("command_buffer_peak_bytes");
+	Writer.WriteIntValue(Last.m_CommandBytesPeak);
+	Writer.WriteAttribute("data_buffer_peak_bytes");
+	Writer.WriteIntValue(Last.m_DataBytesPeak);
+	Writer.EndObject();
+
+	// CPU time of the engine phases and game components
+	Writer.WriteAttribute("scopes");
+	Writer.BeginArray();
+	for(const auto &Scope : m_BenchmarkDemoSummary.Scopes())
+	{
+		Writer.BeginObject();
+		Writer.WriteAttribute("name");
+		Writer.WriteStrValue(Scope.m_pName);
+		Writer.WriteAttribute("count");
+		Writer.WriteIntValue(Scope.m_Count);
+		Writer.WriteAttribute("avg_us");
+		Writer.WriteIntValue(Scope.m_TotalTime / maximum<int64_t>(Scope.m_Count, 1) / 1000);
+		Writer.WriteAttribute("max_us");
+		Writer.WriteIntValue(Scope.m_MaxTime / 1000);
+		Writer.WriteAttribute("frame_avg_us");
+		Writer.WriteIntValue(Scope.m_TotalTime / Frames / 1000);
+		Writer.EndObject();
+	}
+	Writer.EndArray();
+	Writer.EndObject();
+
+	log_info("benchmark", "wrote results of %" PRId64 " frames to '%s'", m_BenchmarkDemoFrames, m_aBenchmarkDemoOutput);
+}
+
+void CClient::Con_DumpTrace(IConsole::IResult *pResult, void *pUserData)
+{
+	CClient *pSelf = (CClient *)pUserData;
+	char aFilename[IO_MAX_PATH_LENGTH];
+	if(pResult->NumArguments())
+	{
+		str_copy(aFilename, pResult->GetString(0));
+	}
+	else
+	{
+		char aDate[64];
+		str_timestamp(aDate, sizeof(aDate));
+		str_format(aFilename, sizeof(aFilename), "dumps/trace_%s.json", aDate);
+	}
+
+	IOHANDLE File = pSelf->Storage()->OpenFile(aFilename, IOFLAG_WRITE, IStorage::TYPE_SAVE);
+	if(!File)
+	{
+		log_error("trace", "failed to open '%s' for writing", aFilename);
+		return;
+	}
+	CJsonFileWriter Writer(File);
+	pSelf->m_TraceRecorder.WriteChromeTrace(&Writer);
+	log_info("trace", "saved %d trace events to '%s'", (int)pSelf->m_TraceRecorder.NumEvents(), aFilename);
+}
+
 void CClient::UpdateAndSwap()
 {
 	Input()->Update();
@@ -4327,6 +4529,16 @@ void CClient::ConchainLoglevel(IConsole::IResult *pResult, void *pUserData, ICon
 	}
 }
 
+void CClient::ConchainTrace(IConsole::IResult *pResult, void *pUserData, IConsole::FCommandCallback pfnCallback, void *pCallbackUserData)
+{
+	CClient *pSelf = (CClient *)pUserData;
+	pfnCallback(pResult, pCallbackUserData);
+	if(pResult->NumArguments())
+	{
+		pSelf->m_TraceRecorder.SetEnabled(g_Config.m_DbgTrace, g_Config.m_DbgTraceEvents);
+	}
+}
+
 void CClient::ConchainStdoutOutputLevel(IConsole::IResult *pResult, void *pUserData, IConsole::FCommandCallback pfnCallback, void *pCallbackUserData)
 {
 	CClient *pSelf = (CClient *)pUserData;
@@ -4377,6 +4589,8 @@ void CClient::RegisterCommands()
 
 	m_pConsole->Register("save_replay", "?i[length] ?r[filename]", CFGFLAG_CLIENT, Con_SaveReplay, this, "Save a replay of the last defined amount of seconds");
 	m_pConsole->Register("benchmark_quit", "i[seconds] r[file]", CFGFLAG_CLIENT | CFGFLAG_STORE, Con_BenchmarkQuit, this, "Benchmark frame times for number of seconds to file, then quit");
+	m_pConsole->Register("benchmark_demo", "s[demo] ?i[fps] ?r[file]", CFGFLAG_CLIENT | CFGFLAG_STORE, Con_BenchmarkDemo, this, "Play a demo at a fixed frame rate, write the CPU time of all components and the render submission stats as JSON to file, then quit");
+	m_pConsole->Register("dump_trace", "?r[file]", CFGFLAG_CLIENT, Con_DumpTrace, this, "Write the recorded frame trace events as Chrome trace JSON (see dbg_trace)");
 
 	RustVersionRegister(*m_pConsole);
 
@@ -4415,6 +4629,9 @@ void CClient::RegisterCommands()
 
 	m_pConsole->Chain("loglevel", ConchainLoglevel, this);
 	m_pConsole->Chain("stdout_output_level", ConchainStdoutOutputLevel, this);
+
+	m_pConsole->Chain("dbg_trace", ConchainTrace, this);
+	m_pConsole->Chain("dbg_trace_events", ConchainTrace, this);
 }
 
 static CClient *CreateClient()
@@ -21,6 +21,7 @@
 #include <engine/shared/fifo.h>
 #include <engine/shared/http.h>
 #include <engine/shared/network.h>
+#include <engine/shared/trace.h>
 #include <engine/textrender.h>
 #include <engine/warning.h>
 
@@ -243,6 +244,24 @@ class CClient : public IClient, public CDemoPlayer::IListener
 	IOHANDLE m_BenchmarkFile = 0;
 	int64_t m_BenchmarkStopTime = 0;
 
+	CTraceRecorder m_TraceRecorder;
+
+	// demo benchmark
+	char m_aCmdBenchmarkDemo[IO_MAX_PATH_LENGTH] = "";
+	char m_aBenchmarkDemoOutput[IO_MAX_PATH_LENGTH] = "";
+	int m_BenchmarkDemoFps = 0;
+	bool m_BenchmarkDemoActive = false;
+	int64_t m_BenchmarkDemoFrames = 0;
+	int64_t m_BenchmarkDemoStartTime = 0;
+	IEngineGraphics::CSubmitStats m_BenchmarkDemoFirstStats;
+	IEngineGraphics::CSubmitStats m_BenchmarkDemoLastStats;
+	uint64_t m_BenchmarkDemoMaxRenderCalls = 0;
+	uint64_t m_BenchmarkDemoMaxCommandBytes = 0;
+	CTraceSummary m_BenchmarkDemoSummary;
+	void StartDemoBenchmark();
+	void UpdateDemoBenchmark();
+	void FinishDemoBenchmark();
+
 	CChecksum m_Checksum;
 	int m_OwnExecutableSize = 0;
 	IOHANDLE m_OwnExecutable = 0;
@@ -428,6 +447,8 @@ public:
 	static void Con_StopRecord(IConsole::IResult *pResult, void *pUserData);
 	static void Con_AddDemoMarker(IConsole::IResult *pResult, void *pUserData);
 	static void Con_BenchmarkQuit(IConsole::IResult *pResult, void *pUserData);
+	static void Con_BenchmarkDemo(IConsole::IResult *pResult, void *pUserData);
+	static void Con_DumpTrace(IConsole::IResult *pResult, void *pUserData);
 	static void ConchainServerBrowserUpdate(IConsole::IResult *pResult, void *pUserData, IConsole::FCommandCallback pfnCallback, void *pCallbackUserData);
 	static void ConchainFullscreen(IConsole::IResult *pResult, void *pUserData, IConsole::FCommandCallback pfnCallback, void *pCallbackUserData);
 	static void ConchainWindowBordered(IConsole::IResult *pResult, void *pUserData, IConsole::FCommandCallback pfnCallback, void *pCallbackUserData);
@@ -438,6 +459,7 @@ public:
 	static void ConchainPassword(IConsole::IResult *pResult, void *pUserData, IConsole::FCommandCallback pfnCallback, void *pCallbackUserData);
 	static void ConchainReplays(IConsole::IResult *pResult, void *pUserData, IConsole::FCommandCallback pfnCallback, void *pCallbackUserData);
 	static void ConchainLoglevel(IConsole::IResult *pResult, void *pUserData, IConsole::FCommandCallback pfnCallback, void *pCallbackUserData);
+	static void ConchainTrace(IConsole::IResult *pResult, void *pUserData, IConsole::FCommandCallback pfnCallback, void *pCallbackUserData);
 	static void ConchainStdoutOutputLevel(IConsole::IResult *pResult, void *pUserData, IConsole::FCommandCallback pfnCallback, void *pCallbackUserData);
 
 	static void Con_DemoSlice(IConsole::IResult *pResult, void *pUserData);
@@ -506,6 +528,7 @@ public:
 	bool EditorHasUnsavedData() const override { return m_pEditor->HasUnsavedData(); }
 
 	IFriends *Foes() override { return &m_Foes; }
+	CTraceRecorder *TraceRecorder() override { return &m_TraceRecorder; }
 
 	void GetSmoothTick(int *pSmoothTick, float *pSmoothIntraTick, float MixAmount) override;
 
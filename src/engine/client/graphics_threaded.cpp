@@ -534,11 +534,7 @@ bool CGraphics_Threaded::LoadPng(CImageInfo &Image, const char *pFilename, int S
 	if(!CImageLoader::LoadPng(File, pFilename, Image, PngliteIncompatible))
 		return false;
 
-	if(m_WarnPngliteIncompatibleImages && PngliteIncompatible != 0)
-	{
-		m_vWarnings.emplace_back(FormatPngliteIncompatibilityWarning(PngliteIncompatible, pFilename));
-	}
-
+	WarnPngliteIncompatibility(PngliteIncompatible, pFilename);
 	return true;
 }
 
@@ -549,12 +545,16 @@ bool CGraphics_Threaded::LoadPng(CImageInfo &Image, const uint8_t *pData, size_t
 	if(!CImageLoader::LoadPng(Reader, pContextName, Image, PngliteIncompatible))
 		return false;
 
+	WarnPngliteIncompatibility(PngliteIncompatible, pContextName);
+	return true;
+}
+
+void CGraphics_Threaded::WarnPngliteIncompatibility(int PngliteIncompatible, const char *pContextName)
+{
 	if(m_WarnPngliteIncompatibleImages && PngliteIncompatible != 0)
 	{
 		m_vWarnings.emplace_back(FormatPngliteIncompatibilityWarning(PngliteIncompatible, pContextName));
 	}
-
-	return true;
 }
 
 bool CGraphics_Threaded::CheckImageDivisibility(const char *pContextName, CImageInfo &Image, int DivX, int DivY, bool AllowResize)
@@ -612,6 +612,14 @@ bool CGraphics_Threaded::IsImageFormatRgba(const char *pContextName, const CImag
 
 void CGraphics_Threaded::KickCommandBuffer()
 {
+	m_SubmitStats.m_NumBuffers++;
+	m_SubmitStats.m_NumCommands += m_pCommandBuffer->m_CommandCount;
+	m_SubmitStats.m_NumRenderCalls += m_pCommandBuffer->m_RenderCallCount;
+	m_SubmitStats.m_CommandBytes += m_pCommandBuffer->m_CmdBuffer.DataUsed();
+	m_SubmitStats.m_DataBytes += m_pCommandBuffer->m_DataBuffer.DataUsed();
+	m_SubmitStats.m_CommandBytesPeak = maximum<uint64_t>(m_SubmitStats.m_CommandBytesPeak, m_pCommandBuffer->m_CmdBuffer.HighWaterMark());
+	m_SubmitStats.m_DataBytesPeak = maximum<uint64_t>(m_SubmitStats.m_DataBytesPeak, m_pCommandBuffer->m_DataBuffer.HighWaterMark());
+
 	m_pBackend->RunBuffer(m_pCommandBuffer);
 
 	std::vector<std::string> WarningStrings;
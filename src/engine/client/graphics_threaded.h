@@ -1,66 +1,125 @@
 #ifndef ENGINE_CLIENT_GRAPHICS_THREADED_H
 #define ENGINE_CLIENT_GRAPHICS_THREADED_H
 
+#include <base/math.h>
 #include <base/system.h>
 #include <engine/graphics.h>
 #include <engine/shared/config.h>
 
 #include <cstddef>
+#include <memory>
 #include <string>
 #include <vector>
 
 constexpr int CMD_BUFFER_DATA_BUFFER_SIZE = 1024 * 1024 * 2;
 constexpr int CMD_BUFFER_CMD_BUFFER_SIZE = 1024 * 256;
+// command buffers grow up to this multiple of their initial size before they are flushed mid-frame
+constexpr int CMD_BUFFER_MAX_GROWTH = 16;
 
 class CCommandBuffer
 {
+public:
+	/**
+	 * Linear allocator made of a chain of segments. When the current segment
+	 * is full, a new one is appended instead of failing, so a busy frame does
+	 * not have to be flushed to the backend early. The additional segments
+	 * are released again on the next reset, so a single busy frame does not
+	 * keep the memory allocated.
+	 */
 	class CBuffer
 	{
-		unsigned char *m_pData;
+		class CSegment
+		{
+		public:
+			std::unique_ptr<unsigned char[]> m_pData;
+			unsigned m_Size;
+			unsigned m_Used;
+		};
+
+		std::vector<CSegment> m_vSegments;
+		size_t m_CurrentSegment;
 		unsigned m_Size;
+		unsigned m_MaxSize;
 		unsigned m_Used;
+		unsigned m_HighWaterMark;
 
-	public:
-		CBuffer(unsigned BufferSize)
+		void AddSegment(unsigned Size)
 		{
-			m_Size = BufferSize;
-			m_pData = new unsigned char[m_Size];
-			m_Used = 0;
+			m_vSegments.push_back({std::make_unique<unsigned char[]>(Size), Size, 0});
+			m_Size += Size;
 		}
 
-		~CBuffer()
+	public:
+		/**
+		 * @param BufferSize Initial size in bytes.
+		 * @param MaxSize Total size up to which the buffer grows, allocations
+		 * beyond it fail and the caller has to flush the buffer.
+		 */
+		CBuffer(unsigned BufferSize, unsigned MaxSize) :
+			m_CurrentSegment(0), m_Size(0), m_MaxSize(maximum(BufferSize, MaxSize)), m_Used(0), m_HighWaterMark(0)
 		{
-			delete[] m_pData;
-			m_pData = 0x0;
-			m_Used = 0;
-			m_Size = 0;
+			AddSegment(BufferSize);
 		}
 
 		void Reset()
 		{
+			if(m_vSegments.size() > 1)
+			{
+				m_vSegments.resize(1);
+				m_Size = m_vSegments[0].m_Size;
+			}
+			m_vSegments[0].m_Used = 0;
+			m_CurrentSegment = 0;
 			m_Used = 0;
 		}
 
 		void *Alloc(unsigned Requested, unsigned Alignment = alignof(std::max_align_t))
 		{
-			size_t Offset = reinterpret_cast<uintptr_t>(m_pData + m_Used) % Alignment;
-			if(Offset)
-				Offset = Alignment - Offset;
+			while(true)
+			{
+				CSegment &Segment = m_vSegments[m_CurrentSegment];
+				size_t Offset = reinterpret_cast<uintptr_t>(Segment.m_pData.get() + Segment.m_Used) % Alignment;
+				if(Offset)
+					Offset = Alignment - Offset;
 
-			if(Requested + Offset + m_Used > m_Size)
-				return 0;
+				if(Requested + Offset + Segment.m_Used <= Segment.m_Size)
+				{
+					void *pPtr = &Segment.m_pData[Segment.m_Used + Offset];
+					Segment.m_Used += Requested + Offset;
+					m_Used += Requested + Offset;
+					m_HighWaterMark = maximum(m_HighWaterMark, m_Used);
+					return pPtr;
+				}
 
-			void *pPtr = &m_pData[m_Used + Offset];
-			m_Used += Requested + Offset;
-			return pPtr;
+				if(m_CurrentSegment + 1 == m_vSegments.size())
+				{
+					// grow by at least the current size, new segments are aligned for any type
+					const unsigned Wanted = maximum(m_Size, Requested + Alignment);
+					if(m_Size + Wanted > m_MaxSize)
+					{
+						if(Requested + Alignment > m_MaxSize - m_Size)
+							return nullptr;
+						AddSegment(m_MaxSize - m_Size);
+					}
+					else
+					{
+						AddSegment(Wanted);
+					}
+				}
+				m_CurrentSegment++;
+			}
 		}
 
-		unsigned char *DataPtr() { return m_pData; }
 		unsigned DataSize() const { return m_Size; }
 		unsigned DataUsed() const { return m_Used; }
+		size_t NumSegments() const { return m_vSegments.size(); }
+
+		/**
+		 * Highest number of bytes used between two resets since the buffer was created.
+		 */
+		unsigned HighWaterMark() const { return m_HighWaterMark; }
 	};
 
-public:
 	CBuffer m_CmdBuffer;
 	size_t m_CommandCount = 0;
 	size_t m_RenderCallCount = 0;
@@ -599,7 +658,7 @@ public:
 
 	//
 	CCommandBuffer(unsigned CmdBufferSize, unsigned DataBufferSize) :
-		m_CmdBuffer(CmdBufferSize), m_DataBuffer(DataBufferSize), m_pCmdBufferHead(nullptr), m_pCmdBufferTail(nullptr)
+		m_CmdBuffer(CmdBufferSize, CmdBufferSize * CMD_BUFFER_MAX_GROWTH), m_DataBuffer(DataBufferSize, DataBufferSize * CMD_BUFFER_MAX_GROWTH), m_pCmdBufferHead(nullptr), m_pCmdBufferTail(nullptr)
 	{
 	}
 
@@ -767,9 +826,16 @@ class CGraphics_Threaded : public IEngineGraphics
 	bool m_GLHasTextureArraysSupport;
 	bool m_GLUseTrianglesAsQuad;
 
+	// Commands are recorded only from the main thread. The batching state above
+	// and the vertex arrays below are shared by all draw calls, and the IGraphics
+	// API is immediate mode (TextureSet, SetColor, QuadsBegin, ...), so callers
+	// cannot record into separate buffers from several threads without a
+	// per-thread recording context. The backend executes a kicked buffer on
+	// its own thread while the other one is being recorded.
 	CCommandBuffer *m_apCommandBuffers[NUM_CMDBUFFERS];
 	CCommandBuffer *m_pCommandBuffer;
 	unsigned m_CurrentCommandBuffer;
+	CSubmitStats m_SubmitStats;
 
 	//
 	class IStorage *m_pStorage;
@@ -961,6 +1027,7 @@ public:
 	IGraphics::CTextureHandle LoadTexture(const char *pFilename, int StorageType, int Flags = 0) override;
 	bool LoadPng(CImageInfo &Image, const char *pFilename, int StorageType) override;
 	bool LoadPng(CImageInfo &Image, const uint8_t *pData, size_t DataSize, const char *pContextName) override;
+	void WarnPngliteIncompatibility(int PngliteIncompatible, const char *pContextName) override;
 
 	bool CheckImageDivisibility(const char *pContextName, CImageInfo &Image, int DivX, int DivY, bool AllowResize) override;
 	bool IsImageFormatRgba(const char *pContextName, const CImageInfo &Image) override;
@@ -1226,6 +1293,8 @@ public:
 	int WindowActive() override;
 	int WindowOpen() override;
 
+	const CSubmitStats &SubmitStats() const override { return m_SubmitStats; }
+
 	void SetWindowGrab(bool Grab) override;
 	void NotifyWindow() override;
 
@@ -39,14 +39,41 @@ public:
 	bool operator()(int a, int b) { return (g_Config.m_BrSortOrder ? (m_pThis->*m_pfnSort)(b, a) : (m_pThis->*m_pfnSort)(a, b)); }
 };
 
-bool matchesPart(const char *a, const char *b)
+class CSearchToken
 {
-	return str_utf8_find_nocase(a, b) != nullptr;
+public:
+	char m_aText[sizeof(g_Config.m_BrFilterString)];
+	bool m_Exact; // the token was quoted
+};
+
+static void ParseSearchTokens(const char *pSearch, std::vector<CSearchToken> &vTokens)
+{
+	vTokens.clear();
+	char aToken[sizeof(g_Config.m_BrFilterString)];
+	while((pSearch = str_next_token(pSearch, IServerBrowser::SEARCH_EXCLUDE_TOKEN, aToken, sizeof(aToken))))
+	{
+		CSearchToken Token;
+		str_copy(Token.m_aText, str_utf8_skip_whitespaces(aToken));
+		str_utf8_trim_right(Token.m_aText);
+		if(Token.m_aText[0] == '\0')
+			continue;
+
+		const int Length = str_length(Token.m_aText);
+		Token.m_Exact = Token.m_aText[0] == '"' && Token.m_aText[Length - 1] == '"';
+		if(Token.m_Exact)
+		{
+			Token.m_aText[Length - 1] = '\0';
+			mem_move(Token.m_aText, Token.m_aText + 1, Length - 1);
+		}
+		vTokens.push_back(Token);
+	}
 }
 
-bool matchesExactly(const char *a, const char *b)
+static bool MatchesSearchToken(const CSearchToken &Token, const char *pField)
 {
-	return str_comp(a, &b[1]) == 0;
+	if(Token.m_Exact)
+		return str_comp(pField, Token.m_aText) == 0;
+	return str_utf8_find_nocase(pField, Token.m_aText) != nullptr;
 }
 
 CServerBrowser::CServerBrowser() :
@@ -423,6 +450,12 @@ void CServerBrowser::Filter()
 		m_pSortedServerlist = (int *)calloc(m_NumSortedServersCapacity, sizeof(int));
 	}
 
+	// split the search strings only once instead of for every server
+	std::vector<CSearchToken> vFilterTokens;
+	std::vector<CSearchToken> vExcludeTokens;
+	ParseSearchTokens(g_Config.m_BrFilterString, vFilterTokens);
+	ParseSearchTokens(g_Config.m_BrExcludeString, vExcludeTokens);
+
 	// filter the servers
 	for(int i = 0; i < m_NumServers; i++)
 	{
@@ -479,28 +512,10 @@ void CServerBrowser::Filter()
 			{
 				Info.m_QuickSearchHit = 0;
 
-				const char *pStr = g_Config.m_BrFilterString;
-				char aFilterStr[sizeof(g_Config.m_BrFilterString)];
-				char aFilterStrTrimmed[sizeof(g_Config.m_BrFilterString)];
-				while((pStr = str_next_token(pStr, IServerBrowser::SEARCH_EXCLUDE_TOKEN, aFilterStr, sizeof(aFilterStr))))
+				for(const CSearchToken &Token : vFilterTokens)
 				{
-					str_copy(aFilterStrTrimmed, str_utf8_skip_whitespaces(aFilterStr));
-					str_utf8_trim_right(aFilterStrTrimmed);
-
-					if(aFilterStrTrimmed[0] == '\0')
-					{
-						continue;
-					}
-					auto MatchesFn = matchesPart;
-					const int FilterLen = str_length(aFilterStrTrimmed);
-					if(aFilterStrTrimmed[0] == '"' && aFilterStrTrimmed[FilterLen - 1] == '"')
-					{
-						aFilterStrTrimmed[FilterLen - 1] = '\0';
-						MatchesFn = matchesExactly;
-					}
-
 					// match against server name
-					if(MatchesFn(Info.m_aName, aFilterStrTrimmed))
+					if(MatchesSearchToken(Token, Info.m_aName))
 					{
 						Info.m_QuickSearchHit |= IServerBrowser::QUICK_SERVERNAME;
 					}
@@ -508,8 +523,8 @@ void CServerBrowser::Filter()
 					// match against players
 					for(int p = 0; p < minimum(Info.m_NumClients, (int)MAX_CLIENTS); p++)
 					{
-						if(MatchesFn(Info.m_aClients[p].m_aName, aFilterStrTrimmed) ||
-							MatchesFn(Info.m_aClients[p].m_aClan, aFilterStrTrimmed))
+						if(MatchesSearchToken(Token, Info.m_aClients[p].m_aName) ||
+							MatchesSearchToken(Token, Info.m_aClients[p].m_aClan))
 						{
 							if(g_Config.m_BrFilterConnectingPlayers &&
 								str_comp(Info.m_aClients[p].m_aName, "(connecting)") == 0 &&
@@ -523,7 +538,7 @@ void CServerBrowser::Filter()
 					}
 
 					// match against map
-					if(MatchesFn(Info.m_aMap, aFilterStrTrimmed))
+					if(MatchesSearchToken(Token, Info.m_aMap))
 					{
 						Info.m_QuickSearchHit |= IServerBrowser::QUICK_MAPNAME;
 					}
@@ -533,44 +548,14 @@ void CServerBrowser::Filter()
 					Filtered = true;
 			}
 
-			if(!Filtered && g_Config.m_BrExcludeString[0] != '\0')
+			if(!Filtered)
 			{
-				const char *pStr = g_Config.m_BrExcludeString;
-				char aExcludeStr[sizeof(g_Config.m_BrExcludeString)];
-				char aExcludeStrTrimmed[sizeof(g_Config.m_BrExcludeString)];
-				while((pStr = str_next_token(pStr, IServerBrowser::SEARCH_EXCLUDE_TOKEN, aExcludeStr, sizeof(aExcludeStr))))
+				for(const CSearchToken &Token : vExcludeTokens)
 				{
-					str_copy(aExcludeStrTrimmed, str_utf8_skip_whitespaces(aExcludeStr));
-					str_utf8_trim_right(aExcludeStrTrimmed);
-
-					if(aExcludeStrTrimmed[0] == '\0')
-					{
-						continue;
-					}
-					auto MatchesFn = matchesPart;
-					const int FilterLen = str_length(aExcludeStrTrimmed);
-					if(aExcludeStrTrimmed[0] == '"' && aExcludeStrTrimmed[FilterLen - 1] == '"')
-					{
-						aExcludeStrTrimmed[FilterLen - 1] = '\0';
-						MatchesFn = matchesExactly;
-					}
-
-					// match against server name
-					if(MatchesFn(Info.m_aName, aExcludeStrTrimmed))
-					{
-						Filtered = true;
-						break;
-					}
-
-					// match against map
-					if(MatchesFn(Info.m_aMap, aExcludeStrTrimmed))
-					{
-						Filtered = true;
-						break;
-					}
-
-					// match against gametype
-					if(MatchesFn(Info.m_aGameType, aExcludeStrTrimmed))
+					// match against server name, map and gametype
+					if(MatchesSearchToken(Token, Info.m_aName) ||
+						MatchesSearchToken(Token, Info.m_aMap) ||
+						MatchesSearchToken(Token, Info.m_aGameType))
 					{
 						Filtered = true;
 						break;
@@ -2,10 +2,10 @@
 
 #include <engine/console.h>
 #include <engine/engine.h>
-#include <engine/external/json-parser/json.h>
 #include <engine/serverbrowser.h>
 #include <engine/shared/http.h>
 #include <engine/shared/jobs.h>
+#include <engine/shared/json.h>
 #include <engine/shared/linereader.h>
 #include <engine/shared/serverinfo.h>
 #include <engine/storage.h>
@@ -46,7 +46,7 @@ static int ClassifyAge(int AgeSeconds)
 class CChooseMaster
 {
 public:
-	typedef bool (*VALIDATOR)(json_value *pJson);
+	typedef bool (*VALIDATOR)(const char *pJson, size_t Length);
 
 	enum
 	{
@@ -255,14 +255,10 @@ void CChooseMaster::CJob::Run()
 		{
 			continue;
 		}
-		json_value *pJson = pGet->ResultJson();
-		if(!pJson)
-		{
-			continue;
-		}
-
-		bool ParseFailure = m_pData->m_pfnValidator(pJson);
-		json_value_free(pJson);
+		unsigned char *pResult;
+		size_t ResultLength;
+		pGet->Result(&pResult, &ResultLength);
+		bool ParseFailure = m_pData->m_pfnValidator((const char *)pResult, ResultLength);
 		if(ParseFailure)
 		{
 			continue;
@@ -329,8 +325,8 @@ private:
 		STATE_NO_MASTER,
 	};
 
-	static bool Validate(json_value *pJson);
-	static bool Parse(json_value *pJson, std::vector<CServerInfo> *pvServers);
+	static bool Validate(const char *pJson, size_t Length);
+	static bool Parse(const char *pJson, size_t Length, std::vector<CServerInfo> *pvServers);
 
 	IHttp *m_pHttp;
 
@@ -386,11 +382,14 @@ void CServerBrowserHttp::Update()
 		std::shared_ptr<CHttpRequest> pGetServers = nullptr;
 		std::swap(m_pGetServers, pGetServers);
 
-		bool Success = true;
-		json_value *pJson = pGetServers->State() == EHttpState::DONE ? pGetServers->ResultJson() : nullptr;
-		Success = Success && pJson;
-		Success = Success && !Parse(pJson, &m_vServers);
-		json_value_free(pJson);
+		bool Success = pGetServers->State() == EHttpState::DONE;
+		if(Success)
+		{
+			unsigned char *pResult;
+			size_t ResultLength;
+			pGetServers->Result(&pResult, &ResultLength);
+			Success = !Parse((const char *)pResult, ResultLength, &m_vServers);
+		}
 		if(!Success)
 		{
 			log_error("serverbrowser_http", "failed getting serverlist, trying to find best URL");
@@ -429,24 +428,17 @@ bool ServerbrowserParseUrl(NETADDR *pOut, const char *pUrl)
 		return true;
 	return false;
 }
-bool CServerBrowserHttp::Validate(json_value *pJson)
+bool CServerBrowserHttp::Validate(const char *pJson, size_t Length)
 {
 	std::vector<CServerInfo> vServers;
-	return Parse(pJson, &vServers);
+	return Parse(pJson, Length, &vServers);
 }
-bool CServerBrowserHttp::Parse(json_value *pJson, std::vector<CServerInfo> *pvServers)
+bool CServerBrowserHttp::Parse(const char *pJson, size_t Length, std::vector<CServerInfo> *pvServers)
 {
 	std::vector<CServerInfo> vServers;
 
-	const json_value &Json = *pJson;
-	const json_value &Servers = Json["servers"];
-	if(Servers.type != json_array)
-	{
-		return true;
-	}
-	for(unsigned int i = 0; i < Servers.u.array.length; i++)
-	{
-		const json_value &Server = Servers[i];
+	// parse the servers one by one instead of building a tree of the whole list
+	const bool Success = JsonParseArrayElements(pJson, Length, "servers", [&](const json_value &Server) {
 		const json_value &Addresses = Server["addresses"];
 		const json_value &Info = Server["info"];
 		const json_value &Location = Server["location"];
@@ -454,23 +446,23 @@ bool CServerBrowserHttp::Parse(json_value *pJson, std::vector<CServerInfo> *pvSe
 		CServerInfo2 ParsedInfo;
 		if(Addresses.type != json_array || (Location.type != json_string && Location.type != json_none))
 		{
-			return true;
+			return false;
 		}
 		if(Location.type == json_string)
 		{
 			if(CServerInfo::ParseLocation(&ParsedLocation, Location))
 			{
-				return true;
+				return false;
 			}
 		}
 		if(CServerInfo2::FromJson(&ParsedInfo, &Info))
 		{
-			log_debug("serverbrowser_http", "skipped due to info, i=%d", i);
+			log_debug("serverbrowser_http", "skipped due to info");
 			// Only skip the current server on parsing
 			// failure; the server info is "user input" by
 			// the game server and can be set to arbitrary
 			// values.
-			continue;
+			return true;
 		}
 		CServerInfo SetInfo = ParsedInfo;
 		SetInfo.m_Location = ParsedLocation;
@@ -481,7 +473,7 @@ bool CServerBrowserHttp::Parse(json_value *pJson, std::vector<CServerInfo> *pvSe
 			const json_value &Address = Addresses[a];
 			if(Address.type != json_string)
 			{
-				return true;
+				return false;
 			}
 			if(str_startswith(Addresses[a], "tw-0.6+udp://"))
 			{
@@ -494,7 +486,7 @@ bool CServerBrowserHttp::Parse(json_value *pJson, std::vector<CServerInfo> *pvSe
 			const json_value &Address = Addresses[a];
 			if(Address.type != json_string)
 			{
-				return true;
+				return false;
 			}
 			if(GotVersion6 && str_startswith(Addresses[a], "tw-0.7+udp://"))
 			{
@@ -503,7 +495,7 @@ bool CServerBrowserHttp::Parse(json_value *pJson, std::vector<CServerInfo> *pvSe
 			NETADDR ParsedAddr;
 			if(ServerbrowserParseUrl(&ParsedAddr, Addresses[a]))
 			{
-				// log_debug("serverbrowser_http", "unknown address, i=%d a=%d", i, a);
+				// log_debug("serverbrowser_http", "unknown address, a=%d", a);
 				// Skip unknown addresses.
 				continue;
 			}
@@ -517,6 +509,11 @@ bool CServerBrowserHttp::Parse(json_value *pJson, std::vector<CServerInfo> *pvSe
 		{
 			vServers.push_back(SetInfo);
 		}
+		return true;
+	});
+	if(!Success)
+	{
+		return true;
 	}
 	*pvServers = vServers;
 	return false;
@@ -17,6 +17,8 @@
 #include <chrono>
 #include <cstddef>
 #include <limits>
+#include <list>
+#include <string>
 #include <tuple>
 #include <unordered_map>
 #include <vector>
@@ -612,6 +614,11 @@ public:
 		return m_IconFace;
 	}
 
+	FT_Face SelectedFace() const
+	{
+		return m_SelectedFace;
+	}
+
 	void AddFace(FT_Face Face)
 	{
 		m_vFtFaces.push_back(Face);
@@ -907,6 +914,117 @@ struct SFontLanguageVariant
 	char m_aFamilyName[FONT_NAME_SIZE];
 };
 
+// Caches the measured size of texts, so UI code that measures the same
+// strings every frame does not have to lay them out again. The least
+// recently used entries are evicted when the cache is full.
+class CTextLayoutCache
+{
+public:
+	// everything besides the text that affects the layout
+	struct SKey
+	{
+		float m_Size;
+		float m_LineWidth;
+		float m_LineSpacing;
+		int m_Flags;
+		unsigned m_RenderFlags;
+		vec2 m_FakeToScreen;
+		FT_Face m_Face;
+
+		bool operator==(const SKey &Other) const
+		{
+			return m_Size == Other.m_Size && m_LineWidth == Other.m_LineWidth && m_LineSpacing == Other.m_LineSpacing &&
+			       m_Flags == Other.m_Flags && m_RenderFlags == Other.m_RenderFlags && m_FakeToScreen == Other.m_FakeToScreen && m_Face == Other.m_Face;
+		}
+	};
+
+	struct SLayout
+	{
+		float m_LongestLineWidth;
+		float m_Height;
+		float m_AlignedFontSize;
+		float m_MaxCharacterHeight;
+		int m_LineCount;
+	};
+
+private:
+	static constexpr size_t MAX_ENTRIES = 1024;
+
+	struct SEntry
+	{
+		uint64_t m_Hash;
+		std::string m_Text;
+		SKey m_Key;
+		SLayout m_Layout;
+	};
+
+	// most recently used entry first
+	std::list<SEntry> m_lEntries;
+	std::unordered_map<uint64_t, std::list<SEntry>::iterator> m_Entries;
+
+	static void HashBytes(uint64_t &Hash, const void *pData, size_t Size)
+	{
+		// FNV-1a
+		for(size_t i = 0; i < Size; ++i)
+		{
+			Hash ^= ((const unsigned char *)pData)[i];
+			Hash *= 1099511628211ull;
+		}
+	}
+
+public:
+	static uint64_t Hash(const char *pText, int Length, const SKey &Key)
+	{
+		uint64_t Hash = 14695981039346656037ull;
+		HashBytes(Hash, pText, Length);
+		HashBytes(Hash, &Key.m_Size, sizeof(Key.m_Size));
+		HashBytes(Hash, &Key.m_LineWidth, sizeof(Key.m_LineWidth));
+		HashBytes(Hash, &Key.m_LineSpacing, sizeof(Key.m_LineSpacing));
+		HashBytes(Hash, &Key.m_Flags, sizeof(Key.m_Flags));
+		HashBytes(Hash, &Key.m_RenderFlags, sizeof(Key.m_RenderFlags));
+		HashBytes(Hash, &Key.m_FakeToScreen.x, sizeof(Key.m_FakeToScreen.x));
+		HashBytes(Hash, &Key.m_FakeToScreen.y, sizeof(Key.m_FakeToScreen.y));
+		HashBytes(Hash, &Key.m_Face, sizeof(Key.m_Face));
+		return Hash;
+	}
+
+	const SLayout *Find(uint64_t Hash, const char *pText, int Length, const SKey &Key)
+	{
+		auto It = m_Entries.find(Hash);
+		if(It == m_Entries.end())
+			return nullptr;
+		const SEntry &Entry = *It->second;
+		if(!(Entry.m_Key == Key) || Entry.m_Text.size() != (size_t)Length || mem_comp(Entry.m_Text.data(), pText, Length) != 0)
+			return nullptr;
+		m_lEntries.splice(m_lEntries.begin(), m_lEntries, It->second);
+		return &Entry.m_Layout;
+	}
+
+	void Add(uint64_t Hash, const char *pText, int Length, const SKey &Key, const SLayout &Layout)
+	{
+		auto It = m_Entries.find(Hash);
+		if(It != m_Entries.end())
+		{
+			// hash collision, replace the old entry
+			m_lEntries.erase(It->second);
+			m_Entries.erase(It);
+		}
+		else if(m_lEntries.size() >= MAX_ENTRIES)
+		{
+			m_Entries.erase(m_lEntries.back().m_Hash);
+			m_lEntries.pop_back();
+		}
+		m_lEntries.push_front({Hash, std::string(pText, Length), Key, Layout});
+		m_Entries[Hash] = m_lEntries.begin();
+	}
+
+	void Clear()
+	{
+		m_lEntries.clear();
+		m_Entries.clear();
+	}
+};
+
 class CTextRender : public IEngineTextRender
 {
 	IConsole *m_pConsole;
@@ -937,6 +1055,49 @@ class CTextRender : public IEngineTextRender
 
 	std::chrono::nanoseconds m_CursorRenderTime;
 
+	CTextLayoutCache m_LayoutCache;
+
+	CTextLayoutCache::SKey LayoutKey(float Size, float LineWidth, float LineSpacing, int Flags)
+	{
+		float ScreenX0, ScreenY0, ScreenX1, ScreenY1;
+		Graphics()->GetScreen(&ScreenX0, &ScreenY0, &ScreenX1, &ScreenY1);
+
+		CTextLayoutCache::SKey Key;
+		Key.m_Size = Size;
+		Key.m_LineWidth = LineWidth;
+		Key.m_LineSpacing = LineSpacing;
+		Key.m_Flags = Flags;
+		Key.m_RenderFlags = m_RenderFlags;
+		Key.m_FakeToScreen = vec2(Graphics()->ScreenWidth() / (ScreenX1 - ScreenX0), Graphics()->ScreenHeight() / (ScreenY1 - ScreenY0));
+		Key.m_Face = m_pGlyphMap->SelectedFace();
+		return Key;
+	}
+
+	CTextLayoutCache::SLayout MeasureText(const CTextLayoutCache::SKey &Key, const char *pText, int StrLength)
+	{
+		const int Length = StrLength < 0 ? str_length(pText) : minimum(StrLength, str_length(pText));
+		// rendering text has side effects, so only cache pure measurements
+		const bool Cached = (Key.m_Flags & TEXTFLAG_RENDER) == 0;
+		uint64_t Hash = 0;
+		if(Cached)
+		{
+			Hash = CTextLayoutCache::Hash(pText, Length, Key);
+			if(const CTextLayoutCache::SLayout *pLayout = m_LayoutCache.Find(Hash, pText, Length, Key))
+				return *pLayout;
+		}
+
+		CTextCursor Cursor;
+		SetCursor(&Cursor, 0, 0, Key.m_Size, Key.m_Flags);
+		Cursor.m_LineWidth = Key.m_LineWidth;
+		Cursor.m_LineSpacing = Key.m_LineSpacing;
+		TextEx(&Cursor, pText, Length);
+
+		const CTextLayoutCache::SLayout Layout = {Cursor.m_LongestLineWidth, Cursor.Height(), Cursor.m_AlignedFontSize, Cursor.m_MaxCharacterHeight, Cursor.m_LineCount};
+		if(Cached)
+			m_LayoutCache.Add(Hash, pText, Length, Key, Layout);
+		return Layout;
+	}
+
 	int GetFreeTextContainerIndex()
 	{
 		if(m_FirstFreeTextContainerIndex == -1)
@@ -1144,6 +1305,8 @@ public:
 
 	void LoadFonts() override
 	{
+		m_LayoutCache.Clear();
+
 		// read file data into buffer
 		const char *pFilename = "fonts/index.json";
 		void *pFileData;
@@ -1250,6 +1413,7 @@ public:
 
 	void SetFontLanguageVariant(const char *pLanguageFile) override
 	{
+		m_LayoutCache.Clear();
 		for(const auto &Variant : m_vVariants)
 		{
 			if(str_comp(pLanguageFile, Variant.m_aLanguageFile) == 0)
@@ -1320,29 +1484,36 @@ public:
 
 	float TextWidth(float Size, const char *pText, int StrLength = -1, float LineWidth = -1.0f, int Flags = 0, const STextSizeProperties &TextSizeProps = {}) override
 	{
-		CTextCursor Cursor;
-		SetCursor(&Cursor, 0, 0, Size, Flags);
-		Cursor.m_LineWidth = LineWidth;
-		TextEx(&Cursor, pText, StrLength);
+		const CTextLayoutCache::SLayout Layout = MeasureText(LayoutKey(Size, LineWidth, 0.0f, Flags), pText, StrLength);
 		if(TextSizeProps.m_pHeight != nullptr)
-			*TextSizeProps.m_pHeight = Cursor.Height();
+			*TextSizeProps.m_pHeight = Layout.m_Height;
 		if(TextSizeProps.m_pAlignedFontSize != nullptr)
-			*TextSizeProps.m_pAlignedFontSize = Cursor.m_AlignedFontSize;
+			*TextSizeProps.m_pAlignedFontSize = Layout.m_AlignedFontSize;
 		if(TextSizeProps.m_pMaxCharacterHeightInLine != nullptr)
-			*TextSizeProps.m_pMaxCharacterHeightInLine = Cursor.m_MaxCharacterHeight;
+			*TextSizeProps.m_pMaxCharacterHeightInLine = Layout.m_MaxCharacterHeight;
 		if(TextSizeProps.m_pLineCount != nullptr)
-			*TextSizeProps.m_pLineCount = Cursor.m_LineCount;
-		return Cursor.m_LongestLineWidth;
+			*TextSizeProps.m_pLineCount = Layout.m_LineCount;
+		return Layout.m_LongestLineWidth;
+	}
+
+	float TextWidths(float Size, const char *const *ppTexts, int NumTexts, float *pWidths = nullptr, int Flags = 0) override
+	{
+		const CTextLayoutCache::SKey Key = LayoutKey(Size, -1.0f, 0.0f, Flags);
+		float LongestWidth = 0.0f;
+		for(int i = 0; i < NumTexts; ++i)
+		{
+			const float Width = MeasureText(Key, ppTexts[i], -1).m_LongestLineWidth;
+			if(pWidths != nullptr)
+				pWidths[i] = Width;
+			LongestWidth = maximum(LongestWidth, Width);
+		}
+		return LongestWidth;
 	}
 
 	STextBoundingBox TextBoundingBox(float Size, const char *pText, int StrLength = -1, float LineWidth = -1.0f, float LineSpacing = 0.0f, int Flags = 0) override
 	{
-		CTextCursor Cursor;
-		SetCursor(&Cursor, 0, 0, Size, Flags);
-		Cursor.m_LineWidth = LineWidth;
-		Cursor.m_LineSpacing = LineSpacing;
-		TextEx(&Cursor, pText, StrLength);
-		return Cursor.BoundingBox();
+		const CTextLayoutCache::SLayout Layout = MeasureText(LayoutKey(Size, LineWidth, LineSpacing, Flags), pText, StrLength);
+		return {0.0f, 0.0f, Layout.m_LongestLineWidth, Layout.m_Height};
 	}
 
 	void TextColor(float r, float g, float b, float a) override
@@ -3,6 +3,8 @@
 #include <base/math.h>
 #include <base/system.h>
 
+#include <vector>
+
 bool ConvertToRgba(uint8_t *pDest, const CImageInfo &SourceImage)
 {
 	if(SourceImage.m_Format == CImageInfo::FORMAT_RGBA)
@@ -10,43 +12,43 @@ bool ConvertToRgba(uint8_t *pDest, const CImageInfo &SourceImage)
 		mem_copy(pDest, SourceImage.m_pData, SourceImage.DataSize());
 		return true;
 	}
-	else
+
+	// one tight loop per format instead of checking the format for every pixel
+	const uint8_t *pSrc = SourceImage.m_pData;
+	const size_t NumPixels = SourceImage.m_Width * SourceImage.m_Height;
+	switch(SourceImage.m_Format)
 	{
-		const size_t SrcChannelCount = CImageInfo::PixelSize(SourceImage.m_Format);
-		const size_t DstChannelCount = CImageInfo::PixelSize(CImageInfo::FORMAT_RGBA);
-		for(size_t Y = 0; Y < SourceImage.m_Height; ++Y)
+	case CImageInfo::FORMAT_RGB:
+		for(size_t i = 0; i < NumPixels; ++i)
 		{
-			for(size_t X = 0; X < SourceImage.m_Width; ++X)
-			{
-				size_t ImgOffsetSrc = (Y * SourceImage.m_Width * SrcChannelCount) + (X * SrcChannelCount);
-				size_t ImgOffsetDest = (Y * SourceImage.m_Width * DstChannelCount) + (X * DstChannelCount);
-				if(SourceImage.m_Format == CImageInfo::FORMAT_RGB)
-				{
-					mem_copy(&pDest[ImgOffsetDest], &SourceImage.m_pData[ImgOffsetSrc], SrcChannelCount);
-					pDest[ImgOffsetDest + 3] = 255;
-				}
-				else if(SourceImage.m_Format == CImageInfo::FORMAT_RA)
-				{
-					pDest[ImgOffsetDest + 0] = SourceImage.m_pData[ImgOffsetSrc];
-					pDest[ImgOffsetDest + 1] = SourceImage.m_pData[ImgOffsetSrc];
-					pDest[ImgOffsetDest + 2] = SourceImage.m_pData[ImgOffsetSrc];
-					pDest[ImgOffsetDest + 3] = SourceImage.m_pData[ImgOffsetSrc + 1];
-				}
-				else if(SourceImage.m_Format == CImageInfo::FORMAT_R)
-				{
-					pDest[ImgOffsetDest + 0] = 255;
-					pDest[ImgOffsetDest + 1] = 255;
-					pDest[ImgOffsetDest + 2] = 255;
-					pDest[ImgOffsetDest + 3] = SourceImage.m_pData[ImgOffsetSrc];
-				}
-				else
-				{
-					dbg_assert(false, "SourceImage.m_Format invalid");
-				}
-			}
+			pDest[i * 4 + 0] = pSrc[i * 3 + 0];
+			pDest[i * 4 + 1] = pSrc[i * 3 + 1];
+			pDest[i * 4 + 2] = pSrc[i * 3 + 2];
+			pDest[i * 4 + 3] = 255;
+		}
+		break;
+	case CImageInfo::FORMAT_RA:
+		for(size_t i = 0; i < NumPixels; ++i)
+		{
+			pDest[i * 4 + 0] = pSrc[i * 2];
+			pDest[i * 4 + 1] = pSrc[i * 2];
+			pDest[i * 4 + 2] = pSrc[i * 2];
+			pDest[i * 4 + 3] = pSrc[i * 2 + 1];
 		}
-		return false;
+		break;
+	case CImageInfo::FORMAT_R:
+		for(size_t i = 0; i < NumPixels; ++i)
+		{
+			pDest[i * 4 + 0] = 255;
+			pDest[i * 4 + 1] = 255;
+			pDest[i * 4 + 2] = 255;
+			pDest[i * 4 + 3] = pSrc[i];
+		}
+		break;
+	default:
+		dbg_assert(false, "SourceImage.m_Format invalid");
 	}
+	return false;
 }
 
 bool ConvertToRgbaAlloc(uint8_t *&pDest, const CImageInfo &SourceImage)
@@ -68,67 +70,70 @@ bool ConvertToRgba(CImageInfo &Image)
 	return false;
 }
 
+template<size_t Step>
+static void ConvertToGrayscale(uint8_t *pData, size_t NumPixels)
+{
+	for(size_t i = 0; i < NumPixels; ++i)
+	{
+		const int Average = (pData[i * Step] + pData[i * Step + 1] + pData[i * Step + 2]) / 3;
+		pData[i * Step] = Average;
+		pData[i * Step + 1] = Average;
+		pData[i * Step + 2] = Average;
+	}
+}
+
 void ConvertToGrayscale(const CImageInfo &Image)
 {
 	if(Image.m_Format == CImageInfo::FORMAT_R || Image.m_Format == CImageInfo::FORMAT_RA)
 		return;
 
-	const size_t Step = Image.PixelSize();
-	for(size_t i = 0; i < Image.m_Width * Image.m_Height; ++i)
-	{
-		const int Average = (Image.m_pData[i * Step] + Image.m_pData[i * Step + 1] + Image.m_pData[i * Step + 2]) / 3;
-		Image.m_pData[i * Step] = Average;
-		Image.m_pData[i * Step + 1] = Average;
-		Image.m_pData[i * Step + 2] = Average;
-	}
+	// a constant step lets the compiler vectorize the loop
+	if(Image.m_Format == CImageInfo::FORMAT_RGBA)
+		ConvertToGrayscale<4>(Image.m_pData, Image.m_Width * Image.m_Height);
+	else
+		ConvertToGrayscale<3>(Image.m_pData, Image.m_Width * Image.m_Height);
 }
 
 static constexpr int DILATE_BPP = 4; // RGBA assumed
 static constexpr uint8_t DILATE_ALPHA_THRESHOLD = 10;
 
-static void Dilate(int w, int h, const uint8_t *pSrc, uint8_t *pDest)
+// Fills every transparent pixel in the list that has an opaque neighbour with the
+// color of the first one (up, left, right, down). Filled pixels are removed from
+// the list, returns the number of filled pixels.
+static int Dilate(int w, int h, const uint8_t *pSrc, uint8_t *pDest, std::vector<int> &vTransparent)
 {
-	const int aDirX[] = {0, -1, 1, 0};
-	const int aDirY[] = {-1, 0, 0, 1};
+	mem_copy(pDest, pSrc, (size_t)w * h * DILATE_BPP);
 
-	int m = 0;
-	for(int y = 0; y < h; y++)
+	int Filled = 0;
+	size_t Kept = 0;
+	for(const int Pixel : vTransparent)
 	{
-		for(int x = 0; x < w; x++, m += DILATE_BPP)
+		const int x = Pixel % w;
+		const int y = Pixel / w;
+
+		// neighbours outside of the image are clamped to the pixel itself, which is transparent
+		int Neighbour = -1;
+		if(y > 0 && pSrc[(Pixel - w) * DILATE_BPP + DILATE_BPP - 1] > DILATE_ALPHA_THRESHOLD)
+			Neighbour = Pixel - w;
+		else if(x > 0 && pSrc[(Pixel - 1) * DILATE_BPP + DILATE_BPP - 1] > DILATE_ALPHA_THRESHOLD)
+			Neighbour = Pixel - 1;
+		else if(x < w - 1 && pSrc[(Pixel + 1) * DILATE_BPP + DILATE_BPP - 1] > DILATE_ALPHA_THRESHOLD)
+			Neighbour = Pixel + 1;
+		else if(y < h - 1 && pSrc[(Pixel + w) * DILATE_BPP + DILATE_BPP - 1] > DILATE_ALPHA_THRESHOLD)
+			Neighbour = Pixel + w;
+
+		if(Neighbour < 0)
 		{
-			for(int i = 0; i < DILATE_BPP; ++i)
-				pDest[m + i] = pSrc[m + i];
-			if(pSrc[m + DILATE_BPP - 1] > DILATE_ALPHA_THRESHOLD)
-				continue;
-
-			int aSumOfOpaque[] = {0, 0, 0};
-			int Counter = 0;
-			for(int c = 0; c < 4; c++)
-			{
-				const int ClampedX = clamp(x + aDirX[c], 0, w - 1);
-				const int ClampedY = clamp(y + aDirY[c], 0, h - 1);
-				const int SrcIndex = ClampedY * w * DILATE_BPP + ClampedX * DILATE_BPP;
-				if(pSrc[SrcIndex + DILATE_BPP - 1] > DILATE_ALPHA_THRESHOLD)
-				{
-					for(int p = 0; p < DILATE_BPP - 1; ++p)
-						aSumOfOpaque[p] += pSrc[SrcIndex + p];
-					++Counter;
-					break;
-				}
-			}
-
-			if(Counter > 0)
-			{
-				for(int i = 0; i < DILATE_BPP - 1; ++i)
-				{
-					aSumOfOpaque[i] /= Counter;
-					pDest[m + i] = (uint8_t)aSumOfOpaque[i];
-				}
-
-				pDest[m + DILATE_BPP - 1] = 255;
-			}
+			vTransparent[Kept++] = Pixel;
+			continue;
 		}
+
+		mem_copy(&pDest[Pixel * DILATE_BPP], &pSrc[Neighbour * DILATE_BPP], DILATE_BPP - 1);
+		pDest[Pixel * DILATE_BPP + DILATE_BPP - 1] = 255;
+		Filled++;
 	}
+	vTransparent.resize(Kept);
+	return Filled;
 }
 
 static void CopyColorValues(int w, int h, const uint8_t *pSrc, uint8_t *pDest)
@@ -174,12 +179,22 @@ void DilateImageSub(uint8_t *pImageBuff, int w, int h, int x, int y, int sw, int
 		mem_copy(&pBufferOriginal[DstImgOffset], &pImageBuff[SrcImgOffset], CopySize);
 	}
 
-	Dilate(sw, sh, pBufferOriginal, apBuffer[0]);
+	// only transparent pixels can change, the others are just copied
+	std::vector<int> vTransparent;
+	for(int i = 0; i < sw * sh; ++i)
+	{
+		if(pBufferOriginal[i * DILATE_BPP + DILATE_BPP - 1] <= DILATE_ALPHA_THRESHOLD)
+			vTransparent.push_back(i);
+	}
 
-	for(int i = 0; i < 5; i++)
+	// once a pass fills nothing, the following passes wouldn't either
+	if(Dilate(sw, sh, pBufferOriginal, apBuffer[0], vTransparent) > 0)
 	{
-		Dilate(sw, sh, apBuffer[0], apBuffer[1]);
-		Dilate(sw, sh, apBuffer[1], apBuffer[0]);
+		for(int i = 0; i < 5; i++)
+		{
+			if(Dilate(sw, sh, apBuffer[0], apBuffer[1], vTransparent) == 0 || Dilate(sw, sh, apBuffer[1], apBuffer[0], vTransparent) == 0)
+				break;
+		}
 	}
 
 	CopyColorValues(sw, sh, apBuffer[0], pBufferOriginal);
@@ -208,56 +223,60 @@ static float CubicHermite(float A, float B, float C, float D, float t)
 	return (a * t * t * t) + (b * t * t) + (c * t) + d;
 }
 
-static void GetPixelClamped(const uint8_t *pSourceImage, int x, int y, uint32_t W, uint32_t H, size_t BPP, uint8_t aSample[4])
-{
-	x = clamp<int>(x, 0, (int)W - 1);
-	y = clamp<int>(y, 0, (int)H - 1);
-
-	mem_copy(aSample, &pSourceImage[x * BPP + (W * BPP * y)], BPP);
-}
-
-static void SampleBicubic(const uint8_t *pSourceImage, float u, float v, uint32_t W, uint32_t H, size_t BPP, uint8_t aSample[4])
+// Bicubic resampling. The filter is separable, so every source row that is needed is
+// filtered horizontally once for all destination columns instead of once per pixel.
+static void ResizeImage(const uint8_t *pSourceImage, uint32_t SW, uint32_t SH, uint8_t *pDestinationImage, uint32_t W, uint32_t H, size_t BPP)
 {
-	float X = (u * W) - 0.5f;
-	int xInt = (int)X;
-	float xFract = X - std::floor(X);
-
-	float Y = (v * H) - 0.5f;
-	int yInt = (int)Y;
-	float yFract = Y - std::floor(Y);
-
-	uint8_t aaaSamples[4][4][4];
-	for(int y = 0; y < 4; ++y)
+	std::vector<int> vColumns(W * 4);
+	std::vector<float> vColumnFract(W);
+	for(int x = 0; x < (int)W; ++x)
 	{
-		for(int x = 0; x < 4; ++x)
-		{
-			GetPixelClamped(pSourceImage, xInt + x - 1, yInt + y - 1, W, H, BPP, aaaSamples[x][y]);
-		}
+		float u = (float)x / (float)(W - 1);
+		float X = (u * SW) - 0.5f;
+		int xInt = (int)X;
+		vColumnFract[x] = X - std::floor(X);
+		for(int i = 0; i < 4; ++i)
+			vColumns[x * 4 + i] = clamp<int>(xInt + i - 1, 0, (int)SW - 1) * BPP;
 	}
 
-	for(size_t i = 0; i < BPP; i++)
-	{
-		float aRows[4];
-		for(int y = 0; y < 4; ++y)
+	// the four source rows used by one destination row are consecutive, so they
+	// never share a slot
+	std::vector<float> avFilteredRows[4];
+	int aFilteredRowY[4] = {-1, -1, -1, -1};
+	for(auto &vRow : avFilteredRows)
+		vRow.resize(W * BPP);
+	auto &&FilteredRow = [&](int SourceY) -> const float * {
+		SourceY = clamp<int>(SourceY, 0, (int)SH - 1);
+		const int Slot = SourceY % 4;
+		float *pRow = avFilteredRows[Slot].data();
+		if(aFilteredRowY[Slot] != SourceY)
 		{
-			aRows[y] = CubicHermite(aaaSamples[0][y][i], aaaSamples[1][y][i], aaaSamples[2][y][i], aaaSamples[3][y][i], xFract);
+			const uint8_t *pSourceRow = &pSourceImage[(size_t)SW * BPP * SourceY];
+			for(int x = 0; x < (int)W; ++x)
+			{
+				const int *pColumns = &vColumns[x * 4];
+				for(size_t i = 0; i < BPP; i++)
+					pRow[x * BPP + i] = CubicHermite(pSourceRow[pColumns[0] + i], pSourceRow[pColumns[1] + i], pSourceRow[pColumns[2] + i], pSourceRow[pColumns[3] + i], vColumnFract[x]);
+			}
+			aFilteredRowY[Slot] = SourceY;
 		}
-		aSample[i] = (uint8_t)clamp<float>(CubicHermite(aRows[0], aRows[1], aRows[2], aRows[3], yFract), 0.0f, 255.0f);
-	}
-}
+		return pRow;
+	};
 
-static void ResizeImage(const uint8_t *pSourceImage, uint32_t SW, uint32_t SH, uint8_t *pDestinationImage, uint32_t W, uint32_t H, size_t BPP)
-{
 	for(int y = 0; y < (int)H; ++y)
 	{
 		float v = (float)y / (float)(H - 1);
-		for(int x = 0; x < (int)W; ++x)
-		{
-			float u = (float)x / (float)(W - 1);
-			uint8_t aSample[4];
-			SampleBicubic(pSourceImage, u, v, SW, SH, BPP, aSample);
-			mem_copy(&pDestinationImage[x * BPP + ((W * BPP) * y)], aSample, BPP);
-		}
+		float Y = (v * SH) - 0.5f;
+		int yInt = (int)Y;
+		float yFract = Y - std::floor(Y);
+
+		const float *apRows[4];
+		for(int i = 0; i < 4; ++i)
+			apRows[i] = FilteredRow(yInt + i - 1);
+
+		uint8_t *pDestinationRow = &pDestinationImage[(size_t)W * BPP * y];
+		for(size_t i = 0; i < (size_t)W * BPP; ++i)
+			pDestinationRow[i] = (uint8_t)clamp<float>(CubicHermite(apRows[0][i], apRows[1][i], apRows[2][i], apRows[3][i], yFract), 0.0f, 255.0f);
 	}
 }
 
@@ -270,6 +270,8 @@ public:
 
 	virtual bool LoadPng(CImageInfo &Image, const char *pFilename, int StorageType) = 0;
 	virtual bool LoadPng(CImageInfo &Image, const uint8_t *pData, size_t DataSize, const char *pContextName) = 0;
+	// for images decoded with CImageLoader directly, e.g. on a worker thread
+	virtual void WarnPngliteIncompatibility(int PngliteIncompatible, const char *pContextName) = 0;
 
 	virtual bool CheckImageDivisibility(const char *pContextName, CImageInfo &Image, int DivX, int DivY, bool AllowResize) = 0;
 	virtual bool IsImageFormatRgba(const char *pContextName, const CImageInfo &Image) = 0;
@@ -501,6 +503,21 @@ class IEngineGraphics : public IGraphics
 {
 	MACRO_INTERFACE("enginegraphics")
 public:
+	/**
+	 * Running totals of the command buffers submitted to the backend.
+	 */
+	class CSubmitStats
+	{
+	public:
+		uint64_t m_NumBuffers = 0;
+		uint64_t m_NumCommands = 0;
+		uint64_t m_NumRenderCalls = 0;
+		uint64_t m_CommandBytes = 0;
+		uint64_t m_DataBytes = 0;
+		uint64_t m_CommandBytesPeak = 0; // most bytes used by a single command buffer
+		uint64_t m_DataBytesPeak = 0;
+	};
+
 	virtual int Init() = 0;
 	virtual void Shutdown() override = 0;
 
@@ -509,6 +526,8 @@ public:
 
 	virtual int WindowActive() = 0;
 	virtual int WindowOpen() = 0;
+
+	virtual const CSubmitStats &SubmitStats() const = 0;
 };
 
 extern IEngineGraphics *CreateEngineGraphicsThreaded();
@@ -18,6 +18,7 @@
 #include <game/generated/protocol7.h>
 #include <game/generated/protocolglue.h>
 
+struct CAntibotCharacterData;
 struct CAntibotRoundData;
 
 // When recording a demo on the server, the ClientId -1 is used
@@ -364,6 +365,7 @@ public:
 	virtual void TeehistorianRecordTeamFinish(int TeamId, int TimeTicks) = 0;
 
 	virtual void FillAntibot(CAntibotRoundData *pData) = 0;
+	virtual void FillAntibotCharacter(int ClientId, CAntibotCharacterData *pData) = 0;
 
 	/**
 	 * Used to report custom player info to master servers.
@@ -2,6 +2,7 @@
 
 #include <antibot/antibot_interface.h>
 
+#include <base/math.h>
 #include <base/system.h>
 
 #include <engine/console.h>
@@ -12,7 +13,7 @@ class IEngineAntibot;
 
 #ifdef CONF_ANTIBOT
 CAntibot::CAntibot() :
-	m_pServer(0), m_pConsole(0), m_pGameServer(0), m_Initialized(false)
+	m_pServer(0), m_pConsole(0), m_pGameServer(0), m_Initialized(false), m_UseEvents(false)
 {
 }
 CAntibot::~CAntibot()
@@ -80,6 +81,20 @@ void CAntibot::Init()
 	m_Data.m_pUser = this;
 	AntibotInit(&m_Data);
 
+	m_vEvents.resize(EVENT_RING_SIZE);
+	m_EventRing.m_pEvents = m_vEvents.data();
+	m_EventRing.m_Size = m_vEvents.size();
+	m_EventRing.m_Published = 0;
+	m_EventRing.m_Consumed = 0;
+	m_EventRing.m_NumDropped = 0;
+	m_EventRing.m_Pending = 0;
+	m_UseEvents = AntibotInitEvents(&m_EventRing);
+	if(!m_UseEvents)
+	{
+		m_vEvents.clear();
+		m_vEvents.shrink_to_fit();
+	}
+
 	m_Initialized = true;
 }
 void CAntibot::RoundStart(IGameServer *pGameServer)
@@ -115,64 +130,150 @@ void CAntibot::Update()
 	}
 }
 
+CAntibotEvent *CAntibot::PushEvent(int Type, int ClientId, int Arg)
+{
+	CAntibotEvent *pEvent = m_EventRing.Push();
+	if(!pEvent)
+		return nullptr;
+	pEvent->m_Type = Type;
+	pEvent->m_ClientId = ClientId;
+	pEvent->m_Tick = Server()->Tick();
+	pEvent->m_Arg = Arg;
+	pEvent->m_Flags = 0;
+	pEvent->m_aData[0] = '\0';
+	return pEvent;
+}
+CAntibotEvent *CAntibot::PushCharacterEvent(int Type, int ClientId, int Arg)
+{
+	CAntibotEvent *pEvent = PushEvent(Type, ClientId, Arg);
+	if(pEvent && GameServer())
+		GameServer()->FillAntibotCharacter(ClientId, &pEvent->m_Character);
+	return pEvent;
+}
+
 void CAntibot::OnPlayerInit(int ClientId)
 {
+	if(m_UseEvents)
+	{
+		PushEvent(ANTIBOT_EVENT_PLAYER_INIT, ClientId);
+		return;
+	}
 	Update();
 	AntibotOnPlayerInit(ClientId);
 }
 void CAntibot::OnPlayerDestroy(int ClientId)
 {
+	if(m_UseEvents)
+	{
+		PushEvent(ANTIBOT_EVENT_PLAYER_DESTROY, ClientId);
+		return;
+	}
 	Update();
 	AntibotOnPlayerDestroy(ClientId);
 }
 void CAntibot::OnSpawn(int ClientId)
 {
+	if(m_UseEvents)
+	{
+		PushCharacterEvent(ANTIBOT_EVENT_SPAWN, ClientId);
+		return;
+	}
 	Update();
 	AntibotOnSpawn(ClientId);
 }
 void CAntibot::OnHammerFireReloading(int ClientId)
 {
+	if(m_UseEvents)
+	{
+		PushCharacterEvent(ANTIBOT_EVENT_HAMMER_FIRE_RELOADING, ClientId);
+		return;
+	}
 	Update();
 	AntibotOnHammerFireReloading(ClientId);
 }
 void CAntibot::OnHammerFire(int ClientId)
 {
+	if(m_UseEvents)
+	{
+		PushCharacterEvent(ANTIBOT_EVENT_HAMMER_FIRE, ClientId);
+		return;
+	}
 	Update();
 	AntibotOnHammerFire(ClientId);
 }
 void CAntibot::OnHammerHit(int ClientId, int TargetId)
 {
+	if(m_UseEvents)
+	{
+		PushCharacterEvent(ANTIBOT_EVENT_HAMMER_HIT, ClientId, TargetId);
+		return;
+	}
 	Update();
 	AntibotOnHammerHit(ClientId, TargetId);
 }
 void CAntibot::OnDirectInput(int ClientId)
 {
+	if(m_UseEvents)
+	{
+		PushCharacterEvent(ANTIBOT_EVENT_DIRECT_INPUT, ClientId);
+		return;
+	}
 	Update();
 	AntibotOnDirectInput(ClientId);
 }
 void CAntibot::OnCharacterTick(int ClientId)
 {
+	if(m_UseEvents)
+	{
+		PushCharacterEvent(ANTIBOT_EVENT_CHARACTER_TICK, ClientId);
+		return;
+	}
 	Update();
 	AntibotOnCharacterTick(ClientId);
 }
 void CAntibot::OnHookAttach(int ClientId, bool Player)
 {
+	if(m_UseEvents)
+	{
+		PushCharacterEvent(ANTIBOT_EVENT_HOOK_ATTACH, ClientId, Player);
+		return;
+	}
 	Update();
 	AntibotOnHookAttach(ClientId, Player);
 }
 
 void CAntibot::OnEngineTick()
 {
+	if(m_UseEvents)
+	{
+		// the module only gets woken up, it reads the events on its own thread
+		m_EventRing.Publish();
+		m_Data.m_Now = time_get();
+		AntibotOnEngineTick();
+		return;
+	}
 	Update();
 	AntibotOnEngineTick();
 }
 void CAntibot::OnEngineClientJoin(int ClientId, bool Sixup)
 {
+	if(m_UseEvents)
+	{
+		PushEvent(ANTIBOT_EVENT_ENGINE_CLIENT_JOIN, ClientId, Sixup);
+		return;
+	}
 	Update();
 	AntibotOnEngineClientJoin(ClientId, Sixup);
 }
 void CAntibot::OnEngineClientDrop(int ClientId, const char *pReason)
 {
+	if(m_UseEvents)
+	{
+		CAntibotEvent *pEvent = PushEvent(ANTIBOT_EVENT_ENGINE_CLIENT_DROP, ClientId);
+		if(pEvent)
+			str_copy((char *)pEvent->m_aData, pReason, sizeof(pEvent->m_aData));
+		return;
+	}
 	Update();
 	AntibotOnEngineClientDrop(ClientId, pReason);
 }
@@ -188,12 +289,22 @@ bool CAntibot::OnEngineClientMessage(int ClientId, const void *pData, int Size,
 }
 bool CAntibot::OnEngineServerMessage(int ClientId, const void *pData, int Size, int Flags)
 {
-	Update();
 	int AntibotFlags = 0;
 	if((Flags & MSGFLAG_VITAL) == 0)
 	{
 		AntibotFlags |= ANTIBOT_MSGFLAG_NONVITAL;
 	}
+	if(m_UseEvents)
+	{
+		CAntibotEvent *pEvent = PushEvent(ANTIBOT_EVENT_ENGINE_SERVER_MESSAGE, ClientId, Size);
+		if(pEvent)
+		{
+			pEvent->m_Flags = AntibotFlags;
+			mem_copy(pEvent->m_aData, pData, minimum<int>(Size, sizeof(pEvent->m_aData)));
+		}
+		return false;
+	}
+	Update();
 	return AntibotOnEngineServerMessage(ClientId, pData, Size, AntibotFlags);
 }
 bool CAntibot::OnEngineSimulateClientMessage(int *pClientId, void *pBuffer, int BufferSize, int *pOutSize, int *pFlags)
@@ -212,7 +323,7 @@ bool CAntibot::OnEngineSimulateClientMessage(int *pClientId, void *pBuffer, int
 }
 #else
 CAntibot::CAntibot() :
-	m_pServer(0), m_pConsole(0), m_pGameServer(0), m_Initialized(false)
+	m_pServer(0), m_pConsole(0), m_pGameServer(0), m_Initialized(false), m_UseEvents(false)
 {
 }
 CAntibot::~CAntibot() = default;
@@ -4,6 +4,8 @@
 #include <antibot/antibot_data.h>
 #include <engine/antibot.h>
 
+#include <vector>
+
 class CAntibot : public IEngineAntibot
 {
 	class IServer *m_pServer;
@@ -18,7 +20,17 @@ class CAntibot : public IEngineAntibot
 	CAntibotRoundData m_RoundData;
 	bool m_Initialized;
 
+	enum
+	{
+		EVENT_RING_SIZE = 1 << 14,
+	};
+	std::vector<CAntibotEvent> m_vEvents;
+	CAntibotEventRing m_EventRing;
+	bool m_UseEvents;
+
 	void Update();
+	CAntibotEvent *PushEvent(int Type, int ClientId, int Arg = 0);
+	CAntibotEvent *PushCharacterEvent(int Type, int ClientId, int Arg = 0);
 	static void Kick(int ClientId, const char *pMessage, void *pUser);
 	static void Log(const char *pMessage, void *pUser);
 	static void Report(int ClientId, const char *pMessage, void *pUser);
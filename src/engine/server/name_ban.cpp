@@ -1,9 +1,12 @@
 #include "name_ban.h"
 
+#include <base/math.h>
 #include <base/system.h>
 
 #include <engine/shared/config.h>
 
+#include <algorithm>
+
 CNameBan::CNameBan(const char *pName, const char *pReason, int Distance, bool IsSubstring) :
 	m_Distance(Distance), m_IsSubstring(IsSubstring)
 {
@@ -36,11 +39,13 @@ void CNameBans::Ban(const char *pName, const char *pReason, const int Distance,
 			str_copy(Ban.m_aReason, pReason);
 			Ban.m_Distance = Distance;
 			Ban.m_IsSubstring = IsSubstring;
+			m_IndexDirty = true;
 			return;
 		}
 	}
 
 	m_vNameBans.emplace_back(pName, pReason, Distance, IsSubstring);
+	m_IndexDirty = true;
 	if(m_pConsole)
 	{
 		char aBuf[256];
@@ -70,6 +75,7 @@ void CNameBans::Unban(const char *pName)
 			m_pConsole->Print(IConsole::OUTPUT_LEVEL_STANDARD, "name_ban", aBuf);
 		}
 		m_vNameBans.erase(ToRemove, m_vNameBans.end());
+		m_IndexDirty = true;
 	}
 }
 
@@ -86,24 +92,154 @@ void CNameBans::Dump() const
 	}
 }
 
+void CNameBans::UpdateIndex() const
+{
+	if(!m_IndexDirty)
+		return;
+	m_IndexDirty = false;
+
+	m_vSkeletonNodes.clear();
+	m_vSubstringNodes.clear();
+	m_vSubstringNodes.emplace_back();
+	for(int i = 0; i < (int)m_vNameBans.size(); i++)
+	{
+		AddSkeleton(i);
+		if(m_vNameBans[i].m_IsSubstring)
+			AddSubstring(i);
+	}
+
+	// breadth-first, so the fail node of every node is finished before its children
+	std::vector<int> vQueue;
+	for(const auto &[Code, Child] : m_vSubstringNodes[0].m_Next)
+		vQueue.push_back(Child);
+	for(size_t i = 0; i < vQueue.size(); i++)
+	{
+		const int Node = vQueue[i];
+		for(const auto &[Code, Child] : m_vSubstringNodes[Node].m_Next)
+		{
+			int Fail = m_vSubstringNodes[Node].m_Fail;
+			while(Fail != 0 && !m_vSubstringNodes[Fail].m_Next.count(Code))
+				Fail = m_vSubstringNodes[Fail].m_Fail;
+			auto Next = m_vSubstringNodes[Fail].m_Next.find(Code);
+			if(Next != m_vSubstringNodes[Fail].m_Next.end())
+				Fail = Next->second;
+			m_vSubstringNodes[Child].m_Fail = Fail;
+			m_vSubstringNodes[Child].m_Ban = maximum(m_vSubstringNodes[Child].m_Ban, m_vSubstringNodes[Fail].m_Ban);
+			vQueue.push_back(Child);
+		}
+	}
+}
+
+void CNameBans::AddSkeleton(int Ban) const
+{
+	const CNameBan &NewBan = m_vNameBans[Ban];
+	const int NewNode = m_vSkeletonNodes.size();
+	m_vSkeletonNodes.push_back({Ban, NewBan.m_Distance, {}});
+	if(NewNode == 0)
+		return;
+
+	int aBuffer[MAX_NAME_SKELETON_LENGTH * 2 + 2];
+	int Node = 0;
+	while(true)
+	{
+		CSkeletonNode &Current = m_vSkeletonNodes[Node];
+		Current.m_MaxDistance = maximum(Current.m_MaxDistance, NewBan.m_Distance);
+		const CNameBan &CurrentBan = m_vNameBans[Current.m_Ban];
+		const int Distance = str_utf32_dist_buffer(NewBan.m_aSkeleton, NewBan.m_SkeletonLength, CurrentBan.m_aSkeleton, CurrentBan.m_SkeletonLength, aBuffer, std::size(aBuffer));
+		auto Child = std::find_if(Current.m_vChildren.begin(), Current.m_vChildren.end(), [Distance](const std::pair<int, int> &Edge) { return Edge.first == Distance; });
+		if(Child == Current.m_vChildren.end())
+		{
+			Current.m_vChildren.emplace_back(Distance, NewNode);
+			return;
+		}
+		Node = Child->second;
+	}
+}
+
+void CNameBans::AddSubstring(int Ban) const
+{
+	int Node = 0;
+	const char *pName = m_vNameBans[Ban].m_aName;
+	while(*pName)
+	{
+		const int Code = str_utf8_tolower(str_utf8_decode(&pName));
+		auto Next = m_vSubstringNodes[Node].m_Next.find(Code);
+		if(Next != m_vSubstringNodes[Node].m_Next.end())
+		{
+			Node = Next->second;
+		}
+		else
+		{
+			const int NewNode = m_vSubstringNodes.size();
+			m_vSubstringNodes[Node].m_Next.emplace(Code, NewNode);
+			m_vSubstringNodes.emplace_back();
+			Node = NewNode;
+		}
+	}
+	m_vSubstringNodes[Node].m_Ban = Ban;
+}
+
+int CNameBans::FindSkeleton(const int *pSkeleton, int SkeletonLength) const
+{
+	int Result = -1;
+	if(m_vSkeletonNodes.empty())
+		return Result;
+
+	int aBuffer[MAX_NAME_SKELETON_LENGTH * 2 + 2];
+	std::vector<int> vStack = {0};
+	while(!vStack.empty())
+	{
+		const CSkeletonNode &Node = m_vSkeletonNodes[vStack.back()];
+		vStack.pop_back();
+		const CNameBan &Ban = m_vNameBans[Node.m_Ban];
+		const int Distance = str_utf32_dist_buffer(pSkeleton, SkeletonLength, Ban.m_aSkeleton, Ban.m_SkeletonLength, aBuffer, std::size(aBuffer));
+		if(Distance <= Ban.m_Distance)
+			Result = maximum(Result, Node.m_Ban);
+		// by the triangle inequality, a ban in the child's subtree is at least
+		// |Distance - edge| away from the name
+		for(const auto &[Edge, Child] : Node.m_vChildren)
+		{
+			if(absolute(Distance - Edge) <= m_vSkeletonNodes[Child].m_MaxDistance)
+				vStack.push_back(Child);
+		}
+	}
+	return Result;
+}
+
+int CNameBans::FindSubstring(const char *pName) const
+{
+	int Result = -1;
+	if(m_vSubstringNodes.empty())
+		return Result;
+
+	int Node = 0;
+	while(*pName)
+	{
+		const int Code = str_utf8_tolower(str_utf8_decode(&pName));
+		while(Node != 0 && !m_vSubstringNodes[Node].m_Next.count(Code))
+			Node = m_vSubstringNodes[Node].m_Fail;
+		auto Next = m_vSubstringNodes[Node].m_Next.find(Code);
+		if(Next != m_vSubstringNodes[Node].m_Next.end())
+			Node = Next->second;
+		Result = maximum(Result, m_vSubstringNodes[Node].m_Ban);
+	}
+	return Result;
+}
+
 const CNameBan *CNameBans::IsBanned(const char *pName) const
 {
+	UpdateIndex();
+
 	char aTrimmed[MAX_NAME_LENGTH];
 	str_copy(aTrimmed, str_utf8_skip_whitespaces(pName));
 	str_utf8_trim_right(aTrimmed);
 
 	int aSkeleton[MAX_NAME_SKELETON_LENGTH];
 	int SkeletonLength = str_utf8_to_skeleton(aTrimmed, aSkeleton, std::size(aSkeleton));
-	int aBuffer[MAX_NAME_SKELETON_LENGTH * 2 + 2];
 
-	const CNameBan *pResult = nullptr;
-	for(const CNameBan &Ban : m_vNameBans)
-	{
-		int Distance = str_utf32_dist_buffer(aSkeleton, SkeletonLength, Ban.m_aSkeleton, Ban.m_SkeletonLength, aBuffer, std::size(aBuffer));
-		if(Distance <= Ban.m_Distance || (Ban.m_IsSubstring && str_utf8_find_nocase(pName, Ban.m_aName)))
-			pResult = &Ban;
-	}
-	return pResult;
+	// the last matching ban in the list wins
+	const int Result = maximum(FindSkeleton(aSkeleton, SkeletonLength), FindSubstring(pName));
+	return Result >= 0 ? &m_vNameBans[Result] : nullptr;
 }
 
 void CNameBans::ConNameBan(IConsole::IResult *pResult, void *pUser)
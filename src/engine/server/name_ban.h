@@ -4,6 +4,7 @@
 #include <engine/console.h>
 #include <engine/shared/protocol.h>
 
+#include <map>
 #include <vector>
 
 enum
@@ -27,9 +28,39 @@ public:
 
 class CNameBans
 {
+	// BK-tree node, all bans in the subtree of a child have the same
+	// skeleton distance to this node's ban
+	class CSkeletonNode
+	{
+	public:
+		int m_Ban;
+		int m_MaxDistance; // largest ban distance in this subtree
+		std::vector<std::pair<int, int>> m_vChildren; // skeleton distance, node index
+	};
+
+	// Aho-Corasick automaton node over the lowercased names of substring bans
+	class CSubstringNode
+	{
+	public:
+		std::map<int, int> m_Next; // lowercased codepoint, node index
+		int m_Fail = 0;
+		int m_Ban = -1; // last ban ending here or in one of the suffixes
+	};
+
 	IConsole *m_pConsole = nullptr;
 	std::vector<CNameBan> m_vNameBans;
 
+	// rebuilt lazily, so loading long ban lists doesn't rebuild them for every ban
+	mutable bool m_IndexDirty = false;
+	mutable std::vector<CSkeletonNode> m_vSkeletonNodes;
+	mutable std::vector<CSubstringNode> m_vSubstringNodes;
+
+	void UpdateIndex() const;
+	void AddSkeleton(int Ban) const;
+	void AddSubstring(int Ban) const;
+	int FindSkeleton(const int *pSkeleton, int SkeletonLength) const;
+	int FindSubstring(const char *pName) const;
+
 	static void ConNameBan(IConsole::IResult *pResult, void *pUser);
 	static void ConNameUnban(IConsole::IResult *pResult, void *pUser);
 	static void ConNameBans(IConsole::IResult *pResult, void *pUser);
@@ -242,6 +242,11 @@ CServer::CServer()
 		m_aCurrentMapSize[i] = 0;
 	}
 
+	static const char *const s_apTickProfileScopes[] = {"total", "input", "game_tick", "snapshot", "fifo", "register", "server_info", "antibot", "network", "tick_jitter"};
+	static_assert(std::size(s_apTickProfileScopes) == NUM_PROFILE_SCOPES);
+	m_TickProfiler.Init(s_apTickProfileScopes, NUM_PROFILE_SCOPES);
+	m_TickProfileStart = 0;
+
 	m_MapReload = false;
 	m_SameMapReload = false;
 	m_ReloadedWhenEmpty = false;
@@ -253,6 +258,14 @@ CServer::CServer()
 	m_ServerInfoFirstRequest = 0;
 	m_ServerInfoNumRequests = 0;
 	m_ServerInfoNeedsUpdate = false;
+	for(bool &Dirty : m_aServerInfoCacheDirty)
+		Dirty = true;
+	for(bool &Dirty : m_aSixupServerInfoCacheDirty)
+		Dirty = true;
+	for(auto &Info : m_aServerInfoClients)
+		Info.m_Included = false;
+	m_ServerInfoPlayerCount = 0;
+	m_ServerInfoClientCount = 0;
 
 #ifdef CONF_FAMILY_UNIX
 	m_ConnLoggingSocketCreated = false;
@@ -1950,18 +1963,8 @@ void CServer::CacheServerInfo(CCache *pCache, int Type, bool SendClients)
 	CPacker p;
 	char aBuf[128];
 
-	// count the players
-	int PlayerCount = 0, ClientCount = 0;
-	for(int i = 0; i < MAX_CLIENTS; i++)
-	{
-		if(m_aClients[i].IncludedInServerInfo())
-		{
-			if(GameServer()->IsClientPlayer(i))
-				PlayerCount++;
-
-			ClientCount++;
-		}
-	}
+	int PlayerCount = m_ServerInfoPlayerCount;
+	int ClientCount = m_ServerInfoClientCount;
 
 	p.Reset();
 
@@ -2086,7 +2089,8 @@ void CServer::CacheServerInfo(CCache *pCache, int Type, bool SendClients)
 
 	for(int i = 0; i < MAX_CLIENTS; i++)
 	{
-		if(m_aClients[i].IncludedInServerInfo())
+		const CServerInfoClient &Info = m_aServerInfoClients[i];
+		if(Info.m_Included)
 		{
 			if(Remaining == 0)
 			{
@@ -2106,29 +2110,7 @@ void CServer::CacheServerInfo(CCache *pCache, int Type, bool SendClients)
 
 			int PreviousSize = q.Size();
 
-			q.AddString(ClientName(i), MAX_NAME_LENGTH); // client name
-			q.AddString(ClientClan(i), MAX_CLAN_LENGTH); // client clan
-
-			ADD_INT(q, m_aClients[i].m_Country); // client country
-
-			int Score;
-			if(m_aClients[i].m_Score.has_value())
-			{
-				Score = m_aClients[i].m_Score.value();
-				if(Score == 9999)
-					Score = -10000;
-				else if(Score == 0) // 0 time isn't displayed otherwise.
-					Score = -1;
-				else
-					Score = -Score;
-			}
-			else
-			{
-				Score = -9999;
-			}
-
-			ADD_INT(q, Score); // client score
-			ADD_INT(q, GameServer()->IsClientPlayer(i) ? 1 : 0); // is player?
+			q.AddRaw(Info.m_vInfo.data(), Info.m_vInfo.size());
 			if(Type == SERVERINFO_EXTENDED)
 				q.AddString("", 0); // extra info, reserved
 
@@ -2163,19 +2145,8 @@ void CServer::CacheServerInfoSixup(CCache *pCache, bool SendClients)
 	CPacker Packer;
 	Packer.Reset();
 
-	// Could be moved to a separate function and cached
-	// count the players
-	int PlayerCount = 0, ClientCount = 0;
-	for(int i = 0; i < MAX_CLIENTS; i++)
-	{
-		if(m_aClients[i].IncludedInServerInfo())
-		{
-			if(GameServer()->IsClientPlayer(i))
-				PlayerCount++;
-
-			ClientCount++;
-		}
-	}
+	const int PlayerCount = m_ServerInfoPlayerCount;
+	const int ClientCount = m_ServerInfoClientCount;
 
 	char aVersion[32];
 	str_format(aVersion, sizeof(aVersion), "0.7↔%s", GameServer()->Version());
@@ -2202,29 +2173,121 @@ void CServer::CacheServerInfoSixup(CCache *pCache, bool SendClients)
 
 	if(SendClients)
 	{
-		for(int i = 0; i < MAX_CLIENTS; i++)
+		for(const auto &Info : m_aServerInfoClients)
 		{
-			if(m_aClients[i].IncludedInServerInfo())
-			{
-				Packer.AddString(ClientName(i), MAX_NAME_LENGTH); // client name
-				Packer.AddString(ClientClan(i), MAX_CLAN_LENGTH); // client clan
-				Packer.AddInt(m_aClients[i].m_Country); // client country
-				Packer.AddInt(m_aClients[i].m_Score.value_or(-1)); // client score
-				Packer.AddInt(GameServer()->IsClientPlayer(i) ? 0 : 1); // flag spectator=1, bot=2 (player=0)
-			}
+			if(Info.m_Included)
+				Packer.AddRaw(Info.m_vInfoSixup.data(), Info.m_vInfoSixup.size());
 		}
 	}
 
 	pCache->AddChunk(Packer.Data(), Packer.Size());
 }
 
+CServer::CCache *CServer::ServerInfoCache(int Type, bool SendClients)
+{
+	const int Index = GetCacheIndex(Type, SendClients);
+	if(m_aServerInfoCacheDirty[Index])
+	{
+		CacheServerInfo(&m_aServerInfoCache[Index], Index / 2, SendClients);
+		m_aServerInfoCacheDirty[Index] = false;
+	}
+	return &m_aServerInfoCache[Index];
+}
+
+CServer::CCache *CServer::SixupServerInfoCache(bool SendClients)
+{
+	if(m_aSixupServerInfoCacheDirty[SendClients])
+	{
+		CacheServerInfoSixup(&m_aSixupServerInfoCache[SendClients], SendClients);
+		m_aSixupServerInfoCacheDirty[SendClients] = false;
+	}
+	return &m_aSixupServerInfoCache[SendClients];
+}
+
+void CServer::UpdateServerInfoClients()
+{
+	m_ServerInfoPlayerCount = 0;
+	m_ServerInfoClientCount = 0;
+	for(int i = 0; i < MAX_CLIENTS; i++)
+	{
+		CServerInfoClient &Info = m_aServerInfoClients[i];
+		const CClient &Client = m_aClients[i];
+		const bool Included = Client.IncludedInServerInfo();
+		const bool Player = Included && GameServer()->IsClientPlayer(i);
+		if(Included)
+		{
+			m_ServerInfoClientCount++;
+			if(Player)
+				m_ServerInfoPlayerCount++;
+		}
+
+		// only repack the entries of clients that changed
+		bool Changed = Included != Info.m_Included;
+		if(!Changed && Included)
+		{
+			Changed = Player != Info.m_Player || Client.m_Country != Info.m_Country || Client.m_Score != Info.m_Score ||
+				  str_comp(ClientName(i), Info.m_aName) != 0 || str_comp(ClientClan(i), Info.m_aClan) != 0;
+		}
+		if(!Changed)
+			continue;
+
+		Info.m_Included = Included;
+		Info.m_vInfo.clear();
+		Info.m_vInfoSixup.clear();
+		if(!Included)
+			continue;
+
+		str_copy(Info.m_aName, ClientName(i));
+		str_copy(Info.m_aClan, ClientClan(i));
+		Info.m_Country = Client.m_Country;
+		Info.m_Score = Client.m_Score;
+		Info.m_Player = Player;
+
+		int Score;
+		if(Info.m_Score.has_value())
+		{
+			Score = Info.m_Score.value();
+			if(Score == 9999)
+				Score = -10000;
+			else if(Score == 0) // 0 time isn't displayed otherwise.
+				Score = -1;
+			else
+				Score = -Score;
+		}
+		else
+		{
+			Score = -9999;
+		}
+
+		CPacker Packer;
+		char aBuf[16];
+		Packer.Reset();
+		Packer.AddString(Info.m_aName, MAX_NAME_LENGTH); // client name
+		Packer.AddString(Info.m_aClan, MAX_CLAN_LENGTH); // client clan
+		str_format(aBuf, sizeof(aBuf), "%d", Info.m_Country);
+		Packer.AddString(aBuf, 0); // client country
+		str_format(aBuf, sizeof(aBuf), "%d", Score);
+		Packer.AddString(aBuf, 0); // client score
+		Packer.AddString(Player ? "1" : "0", 0); // is player?
+		Info.m_vInfo.assign(Packer.Data(), Packer.Data() + Packer.Size());
+
+		Packer.Reset();
+		Packer.AddString(Info.m_aName, MAX_NAME_LENGTH); // client name
+		Packer.AddString(Info.m_aClan, MAX_CLAN_LENGTH); // client clan
+		Packer.AddInt(Info.m_Country); // client country
+		Packer.AddInt(Info.m_Score.value_or(-1)); // client score
+		Packer.AddInt(Player ? 0 : 1); // flag spectator=1, bot=2 (player=0)
+		Info.m_vInfoSixup.assign(Packer.Data(), Packer.Data() + Packer.Size());
+	}
+}
+
 void CServer::SendServerInfo(const NETADDR *pAddr, int Token, int Type, bool SendClients)
 {
 	CPacker p;
 	char aBuf[128];
 	p.Reset();
 
-	CCache *pCache = &m_aServerInfoCache[GetCacheIndex(Type, SendClients)];
+	CCache *pCache = ServerInfoCache(Type, SendClients);
 
 #define ADD_RAW(p, x) (p).AddRaw(x, sizeof(x))
 #define ADD_INT(p, x) \
@@ -2283,7 +2346,7 @@ void CServer::GetServerInfoSixup(CPacker *pPacker, int Token, bool SendClients)
 
 	SendClients = SendClients && Token != -1;
 
-	CCache::CCacheChunk &FirstChunk = m_aSixupServerInfoCache[SendClients].m_vCache.front();
+	CCache::CCacheChunk &FirstChunk = SixupServerInfoCache(SendClients)->m_vCache.front();
 	pPacker->AddRaw(FirstChunk.m_vData.data(), FirstChunk.m_vData.size());
 }
 
@@ -2405,13 +2468,13 @@ void CServer::UpdateServerInfo(bool Resend)
 		return;
 
 	UpdateRegisterServerInfo();
+	UpdateServerInfoClients();
 
-	for(int i = 0; i < 3; i++)
-		for(int j = 0; j < 2; j++)
-			CacheServerInfo(&m_aServerInfoCache[i * 2 + j], i, j);
-
-	for(int i = 0; i < 2; i++)
-		CacheServerInfoSixup(&m_aSixupServerInfoCache[i], i);
+	// the caches are rebuilt from the client entries on the next request
+	for(bool &Dirty : m_aServerInfoCacheDirty)
+		Dirty = true;
+	for(bool &Dirty : m_aSixupServerInfoCacheDirty)
+		Dirty = true;
 
 	if(Resend)
 	{
@@ -2434,6 +2497,14 @@ void CServer::UpdateServerInfo(bool Resend)
 	m_ServerInfoNeedsUpdate = false;
 }
 
+bool CServer::WaitForNetwork(int64_t Deadline)
+{
+	net_wait_add_socket(m_pNetWait, m_NetServer.Socket());
+	m_Econ.AddToWait(m_pNetWait);
+	m_Fifo.AddToWait(m_pNetWait);
+	return net_wait(m_pNetWait, Deadline) != 0;
+}
+
 void CServer::PumpNetwork(bool PacketWaiting)
 {
 	CNetChunk Packet;
@@ -2589,6 +2660,8 @@ int CServer::LoadMap(const char *pMapName)
 	str_copy(m_aCurrentMap, pMapName);
 
 	// load complete map into memory for download
+	// Every server owns its own copy of the map data. Sharing it only pays off once several
+	// game worlds run in one process, which CServer, the kernel and g_Config do not support yet.
 	{
 		free(m_apCurrentMapData[MAP_TYPE_SIX]);
 		void *pData;
@@ -2799,6 +2872,7 @@ int CServer::Run()
 	{
 		bool NonActive = false;
 		bool PacketWaiting = false;
+		m_pNetWait = net_wait_create();
 
 		m_GameStartTime = time_get();
 
@@ -2882,6 +2956,13 @@ int CServer::Run()
 
 			while(t > TickStartTime(m_CurrentGameTick + 1))
 			{
+				m_TickProfiler.SetSampleInterval(Config()->m_SvTickProfile);
+				if(!m_TickProfiler.IsSampling() && m_TickProfiler.BeginSample())
+					m_TickProfileStart = time_get();
+
+				const int64_t InputStart = m_TickProfiler.IsSampling() ? time_get() : 0;
+				if(NewTicks == 0 && m_TickProfiler.IsSampling())
+					m_TickProfiler.Record(PROFILE_TICK_JITTER, t - TickStartTime(m_CurrentGameTick + 1));
 				GameServer()->OnPreTickTeehistorian();
 
 #ifdef CONF_DEBUG
@@ -2926,8 +3007,13 @@ int CServer::Run()
 					if(!ClientHadInput)
 						GameServer()->OnClientPredictedInput(c, nullptr);
 				}
+				if(m_TickProfiler.IsSampling())
+					m_TickProfiler.Record(PROFILE_INPUT, time_get() - InputStart);
 
-				GameServer()->OnTick();
+				{
+					CProfileScope Scope(&m_TickProfiler, PROFILE_GAME_TICK);
+					GameServer()->OnTick();
+				}
 				if(ErrorShutdown())
 				{
 					break;
@@ -2938,19 +3024,29 @@ int CServer::Run()
 			if(NewTicks)
 			{
 				if(Config()->m_SvHighBandwidth || (m_CurrentGameTick % 2) == 0)
+				{
+					CProfileScope Scope(&m_TickProfiler, PROFILE_SNAPSHOT);
 					DoSnapshot();
+				}
 
 				UpdateClientRconCommands();
 
-				m_Fifo.Update();
-
 				// master server stuff
-				m_pRegister->Update();
+				{
+					CProfileScope Scope(&m_TickProfiler, PROFILE_REGISTER);
+					m_pRegister->Update();
+				}
 
 				if(m_ServerInfoNeedsUpdate)
+				{
+					CProfileScope Scope(&m_TickProfiler, PROFILE_SERVER_INFO);
 					UpdateServerInfo();
+				}
 
-				Antibot()->OnEngineTick();
+				{
+					CProfileScope Scope(&m_TickProfiler, PROFILE_ANTIBOT);
+					Antibot()->OnEngineTick();
+				}
 
 				// handle dnsbl
 				if(Config()->m_SvDnsbl)
@@ -3011,8 +3107,23 @@ int CServer::Run()
 				}
 			}
 
+			// the fifo wakes up the loop as well, so it must be read every time
+			{
+				CProfileScope Scope(&m_TickProfiler, PROFILE_FIFO);
+				m_Fifo.Update();
+			}
+
 			if(!NonActive)
+			{
+				CProfileScope Scope(&m_TickProfiler, PROFILE_NETWORK);
 				PumpNetwork(PacketWaiting);
+			}
+
+			if(m_TickProfiler.IsSampling())
+			{
+				m_TickProfiler.Record(PROFILE_TOTAL, time_get() - m_TickProfileStart);
+				m_TickProfiler.EndSample();
+			}
 
 			NonActive = true;
 			for(const auto &Client : m_aClients)
@@ -3041,17 +3152,16 @@ int CServer::Run()
 				if(Config()->m_SvShutdownWhenEmpty)
 					m_RunServer = STOPPING;
 				else
-					PacketWaiting = net_socket_read_wait(m_NetServer.Socket(), 1000000);
+				{
+					set_new_tick();
+					PacketWaiting = WaitForNetwork(time_get() + time_freq());
+				}
 			}
 			else
 			{
 				m_ReloadedWhenEmpty = false;
 
-				set_new_tick();
-				t = time_get();
-				int x = (TickStartTime(m_CurrentGameTick + 1) - t) * 1000000 / time_freq() + 1;
-
-				PacketWaiting = x > 0 ? net_socket_read_wait(m_NetServer.Socket(), x) : true;
+				PacketWaiting = WaitForNetwork(TickStartTime(m_CurrentGameTick + 1));
 			}
 			if(IsInterrupted())
 			{
@@ -3079,6 +3189,11 @@ int CServer::Run()
 	m_pRegister->OnShutdown();
 	m_Econ.Shutdown();
 	m_Fifo.Shutdown();
+	if(m_pNetWait)
+	{
+		net_wait_free(m_pNetWait);
+		m_pNetWait = nullptr;
+	}
 	Engine()->ShutdownJobs();
 
 	GameServer()->OnShutdown(nullptr);
@@ -3626,6 +3741,63 @@ void CServer::ConDumpSqlServers(IConsole::IResult *pResult, void *pUserData)
 	}
 }
 
+void CServer::ConDumpTickProfile(IConsole::IResult *pResult, void *pUser)
+{
+	CServer *pThis = static_cast<CServer *>(pUser);
+	const CProfiler &Profiler = pThis->m_TickProfiler;
+	if(Profiler.SampleInterval() == 0 && Profiler.NumSamples() == 0)
+	{
+		pThis->Console()->Print(IConsole::OUTPUT_LEVEL_STANDARD, "tick_profile", "tick profiler is disabled, set sv_tick_profile to enable it");
+		return;
+	}
+
+	char aBuf[1024];
+	str_format(aBuf, sizeof(aBuf), "map='%s' sampled_ticks=%" PRId64 " interval=%d", pThis->m_aCurrentMap, Profiler.NumSamples(), Profiler.SampleInterval());
+	pThis->Console()->Print(IConsole::OUTPUT_LEVEL_STANDARD, "tick_profile", aBuf);
+	for(int Scope = 0; Scope < Profiler.NumScopes(); Scope++)
+	{
+		if(Profiler.Stats(Scope).m_NumSamples == 0)
+			continue;
+		Profiler.FormatSummary(Scope, aBuf, sizeof(aBuf));
+		pThis->Console()->Print(IConsole::OUTPUT_LEVEL_STANDARD, "tick_profile", aBuf);
+		Profiler.FormatHistogram(Scope, aBuf, sizeof(aBuf));
+		pThis->Console()->Print(IConsole::OUTPUT_LEVEL_STANDARD, "tick_profile", aBuf);
+	}
+}
+
+void CServer::ConResetTickProfile(IConsole::IResult *pResult, void *pUser)
+{
+	CServer *pThis = static_cast<CServer *>(pUser);
+	pThis->m_TickProfiler.Reset();
+	pThis->Console()->Print(IConsole::OUTPUT_LEVEL_STANDARD, "tick_profile", "tick profile reset");
+}
+
+void CServer::ConSaveTickProfile(IConsole::IResult *pResult, void *pUser)
+{
+	CServer *pThis = static_cast<CServer *>(pUser);
+	char aFilename[IO_MAX_PATH_LENGTH];
+	if(pResult->NumArguments())
+	{
+		str_copy(aFilename, pResult->GetString(0));
+	}
+	else
+	{
+		char aDate[64];
+		str_timestamp(aDate, sizeof(aDate));
+		str_format(aFilename, sizeof(aFilename), "dumps/tick_profile_%s.csv", aDate);
+	}
+
+	IOHANDLE File = pThis->Storage()->OpenFile(aFilename, IOFLAG_WRITE, IStorage::TYPE_SAVE);
+	if(!File)
+	{
+		log_error("tick_profile", "failed to open '%s' for writing", aFilename);
+		return;
+	}
+	pThis->m_TickProfiler.WriteCsv(File, pThis->m_aCurrentMap);
+	io_close(File);
+	log_info("tick_profile", "saved tick profile to '%s'", aFilename);
+}
+
 void CServer::ConchainSpecialInfoupdate(IConsole::IResult *pResult, void *pUserData, IConsole::FCommandCallback pfnCallback, void *pCallbackUserData)
 {
 	pfnCallback(pResult, pCallbackUserData);
@@ -3874,6 +4046,10 @@ void CServer::RegisterCommands()
 	Console()->Register("add_sqlserver", "s['r'|'w'] s[Database] s[Prefix] s[User] s[Password] s[IP] i[Port] ?i[SetUpDatabase ?]", CFGFLAG_SERVER | CFGFLAG_NONTEEHISTORIC, ConAddSqlServer, this, "add a sqlserver");
 	Console()->Register("dump_sqlservers", "s['r'|'w']", CFGFLAG_SERVER, ConDumpSqlServers, this, "dumps all sqlservers readservers = r, writeservers = w");
 
+	Console()->Register("dump_tick_profile", "", CFGFLAG_SERVER, ConDumpTickProfile, this, "Print per-subsystem tick duration histograms (see sv_tick_profile)");
+	Console()->Register("reset_tick_profile", "", CFGFLAG_SERVER, ConResetTickProfile, this, "Reset the tick duration histograms");
+	Console()->Register("save_tick_profile", "?s[file]", CFGFLAG_SERVER, ConSaveTickProfile, this, "Write the tick duration histograms to a CSV file");
+
 	Console()->Register("auth_add", "s[ident] s[level] r[pw]", CFGFLAG_SERVER | CFGFLAG_NONTEEHISTORIC, ConAuthAdd, this, "Add a rcon key");
 	Console()->Register("auth_add_p", "s[ident] s[level] s[hash] s[salt]", CFGFLAG_SERVER | CFGFLAG_NONTEEHISTORIC, ConAuthAddHashed, this, "Add a prehashed rcon key");
 	Console()->Register("auth_change", "s[ident] s[level] r[pw]", CFGFLAG_SERVER | CFGFLAG_NONTEEHISTORIC, ConAuthUpdate, this, "Update a rcon key");
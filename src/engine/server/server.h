@@ -14,6 +14,7 @@
 #include <engine/shared/http.h>
 #include <engine/shared/netban.h>
 #include <engine/shared/network.h>
+#include <engine/shared/profiler.h>
 #include <engine/shared/protocol.h>
 #include <engine/shared/snapshot.h>
 #include <engine/shared/uuid_manager.h>
@@ -204,6 +205,25 @@ public:
 	CServerBan m_ServerBan;
 	CHttp m_Http;
 
+	enum
+	{
+		PROFILE_TOTAL = 0,
+		PROFILE_INPUT,
+		PROFILE_GAME_TICK,
+		PROFILE_SNAPSHOT,
+		PROFILE_FIFO,
+		PROFILE_REGISTER,
+		PROFILE_SERVER_INFO,
+		PROFILE_ANTIBOT,
+		PROFILE_NETWORK,
+		PROFILE_TICK_JITTER, // delay between the intended and the actual start of a tick
+		NUM_PROFILE_SCOPES,
+	};
+	CProfiler m_TickProfiler;
+	int64_t m_TickProfileStart;
+
+	NETWAIT *m_pNetWait = nullptr;
+
 	IEngineMap *m_pMap;
 
 	int64_t m_GameStartTime;
@@ -362,13 +382,37 @@ public:
 	};
 	CCache m_aServerInfoCache[3 * 2];
 	CCache m_aSixupServerInfoCache[2];
+	bool m_aServerInfoCacheDirty[3 * 2];
+	bool m_aSixupServerInfoCacheDirty[2];
 	bool m_ServerInfoNeedsUpdate;
 
+	// the packed player entries are kept per client and only repacked
+	// when the client changed, the caches above just concatenate them
+	class CServerInfoClient
+	{
+	public:
+		bool m_Included;
+		char m_aName[MAX_NAME_LENGTH];
+		char m_aClan[MAX_CLAN_LENGTH];
+		int m_Country;
+		std::optional<int> m_Score;
+		bool m_Player;
+
+		std::vector<uint8_t> m_vInfo; // vanilla, 64 legacy and extended
+		std::vector<uint8_t> m_vInfoSixup;
+	};
+	CServerInfoClient m_aServerInfoClients[MAX_CLIENTS];
+	int m_ServerInfoPlayerCount;
+	int m_ServerInfoClientCount;
+
 	void FillAntibot(CAntibotRoundData *pData) override;
 
 	void ExpireServerInfo() override;
 	void CacheServerInfo(CCache *pCache, int Type, bool SendClients);
 	void CacheServerInfoSixup(CCache *pCache, bool SendClients);
+	CCache *ServerInfoCache(int Type, bool SendClients);
+	CCache *SixupServerInfoCache(bool SendClients);
+	void UpdateServerInfoClients();
 	void SendServerInfo(const NETADDR *pAddr, int Token, int Type, bool SendClients);
 	void GetServerInfoSixup(CPacker *pPacker, int Token, bool SendClients);
 	bool RateLimitServerInfoConnless();
@@ -377,6 +421,7 @@ public:
 	void UpdateServerInfo(bool Resend = false);
 
 	void PumpNetwork(bool PacketWaiting);
+	bool WaitForNetwork(int64_t Deadline);
 
 	void ChangeMap(const char *pMap) override;
 	const char *GetMapName() const override;
@@ -411,6 +456,10 @@ public:
 	static void ConAddSqlServer(IConsole::IResult *pResult, void *pUserData);
 	static void ConDumpSqlServers(IConsole::IResult *pResult, void *pUserData);
 
+	static void ConDumpTickProfile(IConsole::IResult *pResult, void *pUser);
+	static void ConResetTickProfile(IConsole::IResult *pResult, void *pUser);
+	static void ConSaveTickProfile(IConsole::IResult *pResult, void *pUser);
+
 	static void ConchainSpecialInfoupdate(IConsole::IResult *pResult, void *pUserData, IConsole::FCommandCallback pfnCallback, void *pCallbackUserData);
 	static void ConchainMaxclientsperipUpdate(IConsole::IResult *pResult, void *pUserData, IConsole::FCommandCallback pfnCallback, void *pCallbackUserData);
 	static void ConchainCommandAccessUpdate(IConsole::IResult *pResult, void *pUserData, IConsole::FCommandCallback pfnCallback, void *pCallbackUserData);
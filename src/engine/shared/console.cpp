@@ -14,6 +14,7 @@
 #include "console.h"
 #include "linereader.h"
 
+#include <algorithm>
 #include <iterator> // std::size
 #include <new>
 
@@ -607,7 +608,7 @@ int CConsole::PossibleCommands(const char *pStr, int FlagMask, bool Temp, FPossi
 
 CConsole::CCommand *CConsole::FindCommand(const char *pName, int FlagMask)
 {
-	for(CCommand *pCommand = m_pFirstCommand; pCommand; pCommand = pCommand->m_pNext)
+	for(CCommand *pCommand = m_apCommandBuckets[CommandBucket(pName)]; pCommand; pCommand = pCommand->m_pNextHashed)
 	{
 		if(pCommand->m_Flags & FlagMask)
 		{
@@ -785,6 +786,7 @@ CConsole::CConsole(int FlagMask)
 	m_apStrokeStr[1] = "1";
 	m_ExecutionQueue.Reset();
 	m_pFirstCommand = 0;
+	std::fill(std::begin(m_apCommandBuckets), std::end(m_apCommandBuckets), nullptr);
 	m_pFirstExec = 0;
 	m_pfnTeeHistorianCommandCallback = 0;
 	m_pTeeHistorianCommandUserdata = 0;
@@ -858,8 +860,39 @@ void CConsole::ParseArguments(int NumArgs, const char **ppArguments)
 	}
 }
 
+unsigned CConsole::CommandBucket(const char *pName)
+{
+	// FNV-1a of the lowercase name, matching str_comp_nocase
+	unsigned Hash = 2166136261u;
+	for(; *pName; pName++)
+	{
+		const unsigned char c = *pName;
+		Hash ^= c >= 'A' && c <= 'Z' ? c - 'A' + 'a' : c;
+		Hash *= 16777619u;
+	}
+	return Hash % NUM_COMMAND_BUCKETS;
+}
+
+void CConsole::RemoveCommandHashed(CCommand *pCommand)
+{
+	for(CCommand **ppCommand = &m_apCommandBuckets[CommandBucket(pCommand->m_pName)]; *ppCommand; ppCommand = &(*ppCommand)->m_pNextHashed)
+	{
+		if(*ppCommand == pCommand)
+		{
+			*ppCommand = pCommand->m_pNextHashed;
+			return;
+		}
+	}
+}
+
 void CConsole::AddCommandSorted(CCommand *pCommand)
 {
+	CCommand **ppHashed = &m_apCommandBuckets[CommandBucket(pCommand->m_pName)];
+	while(*ppHashed && str_comp(pCommand->m_pName, (*ppHashed)->m_pName) > 0)
+		ppHashed = &(*ppHashed)->m_pNextHashed;
+	pCommand->m_pNextHashed = *ppHashed;
+	*ppHashed = pCommand;
+
 	if(!m_pFirstCommand || str_comp(pCommand->m_pName, m_pFirstCommand->m_pName) <= 0)
 	{
 		if(m_pFirstCommand && m_pFirstCommand->m_pNext)
@@ -970,6 +1003,7 @@ void CConsole::DeregisterTemp(const char *pName)
 	// add to recycle list
 	if(pRemoved)
 	{
+		RemoveCommandHashed(pRemoved);
 		pRemoved->m_pNext = m_pRecycleList;
 		m_pRecycleList = pRemoved;
 	}
@@ -977,6 +1011,17 @@ void CConsole::DeregisterTemp(const char *pName)
 
 void CConsole::DeregisterTempAll()
 {
+	for(CCommand *&pBucket : m_apCommandBuckets)
+	{
+		for(CCommand **ppCommand = &pBucket; *ppCommand;)
+		{
+			if((*ppCommand)->m_Temp)
+				*ppCommand = (*ppCommand)->m_pNextHashed;
+			else
+				ppCommand = &(*ppCommand)->m_pNextHashed;
+		}
+	}
+
 	// set non temp as first one
 	for(; m_pFirstCommand && m_pFirstCommand->m_Temp; m_pFirstCommand = m_pFirstCommand->m_pNext)
 		;
@@ -1041,7 +1086,7 @@ void CConsole::StoreCommands(bool Store)
 
 const IConsole::CCommandInfo *CConsole::GetCommandInfo(const char *pName, int FlagMask, bool Temp)
 {
-	for(CCommand *pCommand = m_pFirstCommand; pCommand; pCommand = pCommand->m_pNext)
+	for(CCommand *pCommand = m_apCommandBuckets[CommandBucket(pName)]; pCommand; pCommand = pCommand->m_pNextHashed)
 	{
 		if(pCommand->m_Flags & FlagMask && pCommand->m_Temp == Temp)
 		{
@@ -15,6 +15,7 @@ class CConsole : public IConsole
 	{
 	public:
 		CCommand *m_pNext;
+		CCommand *m_pNextHashed; // next command in the same bucket of m_apCommandBuckets
 		int m_Flags;
 		bool m_Temp;
 		FCommandCallback m_pfnCallback;
@@ -39,6 +40,13 @@ class CConsole : public IConsole
 	const char *m_apStrokeStr[2];
 	CCommand *m_pFirstCommand;
 
+	enum
+	{
+		NUM_COMMAND_BUCKETS = 1024,
+	};
+	// commands by case-insensitive name hash, each bucket is sorted like m_pFirstCommand
+	CCommand *m_apCommandBuckets[NUM_COMMAND_BUCKETS];
+
 	class CExecFile
 	{
 	public:
@@ -193,7 +201,9 @@ class CConsole : public IConsole
 		}
 	} m_ExecutionQueue;
 
+	static unsigned CommandBucket(const char *pName);
 	void AddCommandSorted(CCommand *pCommand);
+	void RemoveCommandHashed(CCommand *pCommand);
 	CCommand *FindCommand(const char *pName, int FlagMask);
 
 	bool m_Cheated;
@@ -11,8 +11,11 @@
 
 #include "uuid_manager.h"
 
+#include <algorithm>
+#include <atomic>
 #include <cstdlib>
 #include <limits>
+#include <thread>
 
 #include <zlib.h>
 
@@ -786,33 +789,167 @@ static int CompressionLevelToZlib(CDataFileWriter::ECompressionLevel Compression
 		return Z_DEFAULT_COMPRESSION;
 	case CDataFileWriter::COMPRESSION_BEST:
 		return Z_BEST_COMPRESSION;
+	case CDataFileWriter::COMPRESSION_FAST:
+		return Z_BEST_SPEED;
 	default:
 		dbg_assert(false, "CompressionLevel invalid");
 		dbg_break();
 	}
 }
 
-void CDataFileWriter::Finish()
+// Data larger than this is split into chunks that are compressed independently,
+// so a single big layer or image can be compressed on several threads.
+static constexpr int COMPRESSION_CHUNK_SIZE = 1024 * 1024;
+// Each chunk is primed with the end of the previous one, so the compression ratio stays the same.
+static constexpr int COMPRESSION_WINDOW_SIZE = 32 * 1024;
+// Below this total size starting threads takes longer than compressing.
+static constexpr size_t COMPRESSION_PARALLEL_MIN_SIZE = 256 * 1024;
+
+static void CompressionError(int Result)
 {
-	dbg_assert((bool)m_File, "File not open");
+	char aError[32];
+	str_format(aError, sizeof(aError), "zlib compression error %d", Result);
+	dbg_assert(false, aError);
+}
 
-	// Compress data. This takes the majority of the time when saving a datafile,
-	// so it's delayed until the end so it can be off-loaded to another thread.
-	for(CDataInfo &DataInfo : m_vDatas)
+void CDataFileWriter::CompressDatas()
+{
+	struct CChunk
 	{
-		unsigned long CompressedSize = compressBound(DataInfo.m_UncompressedSize);
-		DataInfo.m_pCompressedData = malloc(CompressedSize);
-		const int Result = compress2((Bytef *)DataInfo.m_pCompressedData, &CompressedSize, (Bytef *)DataInfo.m_pUncompressedData, DataInfo.m_UncompressedSize, CompressionLevelToZlib(DataInfo.m_CompressionLevel));
-		DataInfo.m_CompressedSize = CompressedSize;
+		int m_DataIndex;
+		int m_Offset;
+		int m_Size;
+		bool m_Last;
+		unsigned char *m_pCompressedData;
+		int m_CompressedSize;
+		uLong m_Adler;
+	};
+
+	std::vector<CChunk> vChunks;
+	size_t TotalSize = 0;
+	for(int DataIndex = 0; DataIndex < (int)m_vDatas.size(); DataIndex++)
+	{
+		const int Size = m_vDatas[DataIndex].m_UncompressedSize;
+		for(int Offset = 0; Offset < Size; Offset += COMPRESSION_CHUNK_SIZE)
+			vChunks.push_back({DataIndex, Offset, minimum(Size - Offset, COMPRESSION_CHUNK_SIZE), Offset + COMPRESSION_CHUNK_SIZE >= Size, nullptr, 0, 0});
+		TotalSize += Size;
+	}
+	// biggest chunks first, so no thread is left with a big one at the end
+	std::stable_sort(vChunks.begin(), vChunks.end(), [](const CChunk &A, const CChunk &B) { return A.m_Size > B.m_Size; });
+
+	std::atomic<size_t> NextChunk(0);
+	auto &&CompressChunks = [&]() {
+		for(size_t ChunkIndex = NextChunk++; ChunkIndex < vChunks.size(); ChunkIndex = NextChunk++)
+		{
+			CChunk &Chunk = vChunks[ChunkIndex];
+			const CDataInfo &DataInfo = m_vDatas[Chunk.m_DataIndex];
+			const Bytef *pData = (const Bytef *)DataInfo.m_pUncompressedData + Chunk.m_Offset;
+			const int Level = CompressionLevelToZlib(DataInfo.m_CompressionLevel);
+
+			if(Chunk.m_Offset == 0 && Chunk.m_Last)
+			{
+				// small data is compressed exactly like before
+				unsigned long CompressedSize = compressBound(Chunk.m_Size);
+				Chunk.m_pCompressedData = (unsigned char *)malloc(CompressedSize);
+				const int Result = compress2(Chunk.m_pCompressedData, &CompressedSize, pData, Chunk.m_Size, Level);
+				if(Result != Z_OK)
+					CompressionError(Result);
+				Chunk.m_CompressedSize = CompressedSize;
+				continue;
+			}
+
+			// raw deflate stream, the zlib header and checksum are added when the chunks are joined
+			z_stream Stream = {};
+			int Result = deflateInit2(&Stream, Level, Z_DEFLATED, -MAX_WBITS, 8, Z_DEFAULT_STRATEGY);
+			if(Result == Z_OK && Chunk.m_Offset > 0)
+			{
+				const int DictionarySize = minimum(Chunk.m_Offset, COMPRESSION_WINDOW_SIZE);
+				Result = deflateSetDictionary(&Stream, pData - DictionarySize, DictionarySize);
+			}
+			if(Result != Z_OK)
+				CompressionError(Result);
+
+			// the sync flush marker ending all but the last chunk takes up to 10 bytes
+			const uLong Bound = deflateBound(&Stream, Chunk.m_Size) + 16;
+			Chunk.m_pCompressedData = (unsigned char *)malloc(Bound);
+			Stream.next_in = (Bytef *)pData;
+			Stream.avail_in = Chunk.m_Size;
+			Stream.next_out = Chunk.m_pCompressedData;
+			Stream.avail_out = Bound;
+			Result = deflate(&Stream, Chunk.m_Last ? Z_FINISH : Z_SYNC_FLUSH);
+			if(Result != (Chunk.m_Last ? Z_STREAM_END : Z_OK) || Stream.avail_in != 0)
+				CompressionError(Result);
+			Chunk.m_CompressedSize = Bound - Stream.avail_out;
+			Chunk.m_Adler = adler32(adler32(0, nullptr, 0), pData, Chunk.m_Size);
+			deflateEnd(&Stream);
+		}
+	};
+
+	const int MaxThreads = m_MaxCompressionThreads > 0 ? m_MaxCompressionThreads : maximum<int>(std::thread::hardware_concurrency(), 1);
+	const int NumThreads = TotalSize < COMPRESSION_PARALLEL_MIN_SIZE ? 1 : minimum<int>(MaxThreads, vChunks.size());
+	std::vector<std::thread> vThreads;
+	for(int i = 1; i < NumThreads; i++)
+		vThreads.emplace_back(CompressChunks);
+	CompressChunks();
+	for(std::thread &Thread : vThreads)
+		Thread.join();
+
+	// join the chunks of each data in order
+	std::stable_sort(vChunks.begin(), vChunks.end(), [](const CChunk &A, const CChunk &B) { return A.m_DataIndex != B.m_DataIndex ? A.m_DataIndex < B.m_DataIndex : A.m_Offset < B.m_Offset; });
+	for(size_t First = 0, Last; First < vChunks.size(); First = Last)
+	{
+		CDataInfo &DataInfo = m_vDatas[vChunks[First].m_DataIndex];
+		for(Last = First + 1; Last < vChunks.size() && vChunks[Last].m_DataIndex == vChunks[First].m_DataIndex; Last++)
+			;
+
 		free(DataInfo.m_pUncompressedData);
 		DataInfo.m_pUncompressedData = nullptr;
-		if(Result != Z_OK)
+		if(Last - First == 1)
 		{
-			char aError[32];
-			str_format(aError, sizeof(aError), "zlib compression error %d", Result);
-			dbg_assert(false, aError);
+			DataInfo.m_pCompressedData = vChunks[First].m_pCompressedData;
+			DataInfo.m_CompressedSize = vChunks[First].m_CompressedSize;
+			continue;
 		}
+
+		int CompressedSize = 2 + 4; // zlib header and adler32 checksum
+		for(size_t i = First; i < Last; i++)
+			CompressedSize += vChunks[i].m_CompressedSize;
+		unsigned char *pCompressedData = (unsigned char *)malloc(CompressedSize);
+
+		// same header zlib writes for this level
+		const int Level = CompressionLevelToZlib(DataInfo.m_CompressionLevel);
+		const int LevelFlags = Level == Z_DEFAULT_COMPRESSION ? 2 : Level < 2 ? 0 : Level < 6 ? 1 : Level == 6 ? 2 : 3;
+		int Header = (Z_DEFLATED + ((MAX_WBITS - 8) << 4)) << 8 | LevelFlags << 6;
+		Header += 31 - Header % 31;
+		pCompressedData[0] = Header >> 8;
+		pCompressedData[1] = Header & 0xff;
+
+		int Pos = 2;
+		uLong Adler = adler32(0, nullptr, 0);
+		for(size_t i = First; i < Last; i++)
+		{
+			mem_copy(pCompressedData + Pos, vChunks[i].m_pCompressedData, vChunks[i].m_CompressedSize);
+			Pos += vChunks[i].m_CompressedSize;
+			free(vChunks[i].m_pCompressedData);
+			Adler = adler32_combine(Adler, vChunks[i].m_Adler, vChunks[i].m_Size);
+		}
+		pCompressedData[Pos++] = Adler >> 24;
+		pCompressedData[Pos++] = Adler >> 16;
+		pCompressedData[Pos++] = Adler >> 8;
+		pCompressedData[Pos++] = Adler;
+
+		DataInfo.m_pCompressedData = pCompressedData;
+		DataInfo.m_CompressedSize = CompressedSize;
 	}
+}
+
+void CDataFileWriter::Finish()
+{
+	dbg_assert((bool)m_File, "File not open");
+
+	// Compress data. This takes the majority of the time when saving a datafile,
+	// so it's delayed until the end so it can be off-loaded to other threads.
+	CompressDatas();
 
 	// Calculate total size of items
 	size_t ItemSize = 0;
@@ -73,6 +73,7 @@ public:
 	{
 		COMPRESSION_DEFAULT,
 		COMPRESSION_BEST,
+		COMPRESSION_FAST, // for files that are only used locally, e.g. editor autosaves
 	};
 
 private:
@@ -118,9 +119,11 @@ private:
 	std::vector<CItemInfo> m_vItems;
 	std::vector<CDataInfo> m_vDatas;
 	std::vector<CExtendedItemType> m_vExtendedItemTypes;
+	int m_MaxCompressionThreads = 0;
 
 	int GetTypeFromIndex(int Index) const;
 	int GetExtendedItemTypeIndex(int Type, const CUuid *pUuid);
+	void CompressDatas();
 
 public:
 	CDataFileWriter();
@@ -132,6 +135,7 @@ public:
 		m_vItems = std::move(Other.m_vItems);
 		m_vDatas = std::move(Other.m_vDatas);
 		m_vExtendedItemTypes = std::move(Other.m_vExtendedItemTypes);
+		m_MaxCompressionThreads = Other.m_MaxCompressionThreads;
 	}
 	~CDataFileWriter();
 
@@ -140,6 +144,12 @@ public:
 	int AddData(size_t Size, const void *pData, ECompressionLevel CompressionLevel = COMPRESSION_DEFAULT);
 	int AddDataSwapped(size_t Size, const void *pData);
 	int AddDataString(const char *pStr);
+	/**
+	 * Limits the threads used to compress large data in @link Finish @endlink.
+	 *
+	 * @param MaxThreads Maximum number of threads, including the calling one. `0` uses one per core.
+	 */
+	void SetMaxCompressionThreads(int MaxThreads) { m_MaxCompressionThreads = MaxThreads; }
 	void Finish();
 };
 
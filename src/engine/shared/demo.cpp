@@ -898,6 +898,9 @@ bool CDemoPlayer::ExtractMap(class IStorage *pStorage)
 
 int64_t CDemoPlayer::Time()
 {
+	if(m_FixedTimestep)
+		return m_FixedTime;
+
 #if defined(CONF_VIDEORECORDER)
 	if(m_UseVideo && IVideo::Current())
 	{
@@ -1025,8 +1028,18 @@ void CDemoPlayer::AdjustSpeedIndex(int Offset)
 	SetSpeedIndex(clamp(m_SpeedIndex + Offset, 0, (int)(std::size(g_aSpeeds) - 1)));
 }
 
+void CDemoPlayer::SetFixedTimestep(int64_t Timestep)
+{
+	m_FixedTimestep = Timestep;
+	m_FixedTime = 0;
+	m_Info.m_LastUpdate = Time();
+}
+
 int CDemoPlayer::Update(bool RealTime)
 {
+	// seeking also updates the player, only actual playback advances the time
+	if(RealTime)
+		m_FixedTime += m_FixedTimestep;
 	int64_t Now = Time();
 	int64_t Deltatime = Now - m_Info.m_LastUpdate;
 	m_Info.m_LastUpdate = Now;
@@ -133,6 +133,8 @@ private:
 #if defined(CONF_VIDEORECORDER)
 	bool m_WasRecording = false;
 #endif
+	int64_t m_FixedTimestep = 0;
+	int64_t m_FixedTime = 0;
 
 	enum EReadChunkHeaderResult
 	{
@@ -177,6 +179,14 @@ public:
 	const char *ErrorMessage() const override { return m_aErrorMessage; }
 
 	int Update(bool RealTime = true);
+
+	/**
+	 * Advances the playback clock by a constant step on every @link Update @endlink
+	 * instead of following the wall clock, so every run renders the same frames.
+	 *
+	 * @param Timestep Step in @link time_get @endlink units, `0` restores real time playback.
+	 */
+	void SetFixedTimestep(int64_t Timestep);
 	bool IsSixup() const { return m_Sixup; }
 
 	const CPlaybackInfo *Info() const { return &m_Info; }
@@ -96,6 +96,12 @@ void CEcon::Init(CConfig *pConfig, IConsole *pConsole, CNetBan *pNetBan)
 		Console()->Print(IConsole::OUTPUT_LEVEL_STANDARD, "econ", "couldn't open socket. port might already be in use");
 }
 
+void CEcon::AddToWait(NETWAIT *pWait) const
+{
+	if(m_Ready)
+		m_NetConsole.AddToWait(pWait);
+}
+
 void CEcon::Update()
 {
 	if(!m_Ready)
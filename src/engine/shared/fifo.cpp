@@ -12,6 +12,7 @@
 void CFifo::Init(IConsole *pConsole, const char *pFifoFile, int Flag)
 {
 	m_File = -1;
+	m_KeepOpenFile = -1;
 
 	m_pConsole = pConsole;
 	if(pFifoFile[0] == '\0')
@@ -41,7 +42,14 @@ void CFifo::Init(IConsole *pConsole, const char *pFifoFile, int Flag)
 
 	m_File = open(m_aFilename, O_RDONLY | O_NONBLOCK);
 	if(m_File < 0)
+	{
 		dbg_msg("fifo", "can't open file '%s'", m_aFilename);
+		return;
+	}
+
+	// keep a writer open, otherwise the fifo reports end of file (and is
+	// therefore always readable) after the first writer closed it
+	m_KeepOpenFile = open(m_aFilename, O_WRONLY | O_NONBLOCK);
 }
 
 void CFifo::Shutdown()
@@ -49,10 +57,17 @@ void CFifo::Shutdown()
 	if(m_File < 0)
 		return;
 
+	if(m_KeepOpenFile >= 0)
+		close(m_KeepOpenFile);
 	close(m_File);
 	fs_remove(m_aFilename);
 }
 
+void CFifo::AddToWait(NETWAIT *pWait) const
+{
+	net_wait_add_fd(pWait, m_File);
+}
+
 void CFifo::Update()
 {
 	if(m_File < 0)
@@ -86,6 +101,11 @@ void CFifo::Update()
 
 #include <windows.h>
 
+void CFifo::AddToWait(NETWAIT *pWait) const
+{
+	// named pipes can't be waited on together with sockets, they are polled every tick
+}
+
 void CFifo::Init(IConsole *pConsole, const char *pFifoFile, int Flag)
 {
 	m_pConsole = pConsole;
@@ -2,6 +2,7 @@
 #define ENGINE_SHARED_FIFO_H
 
 #include <base/detect.h>
+#include <base/types.h>
 #include <engine/console.h>
 
 class CFifo
@@ -11,6 +12,7 @@ class CFifo
 	int m_Flag;
 #if defined(CONF_FAMILY_UNIX)
 	int m_File;
+	int m_KeepOpenFile;
 #elif defined(CONF_FAMILY_WINDOWS)
 	void *m_pPipe;
 #endif
@@ -18,6 +20,7 @@ class CFifo
 public:
 	void Init(IConsole *pConsole, const char *pFifoFile, int Flag);
 	void Update();
+	void AddToWait(NETWAIT *pWait) const;
 	void Shutdown();
 };
 
@@ -43,6 +43,206 @@ int json_boolean_get(const json_value *boolean)
 	return boolean->u.boolean != 0;
 }
 
+class CJsonScanner
+{
+	const char *m_pJson;
+	size_t m_Length;
+	size_t m_Pos = 0;
+
+	bool SkipString()
+	{
+		m_Pos++; // opening quote
+		while(m_Pos < m_Length)
+		{
+			const char c = m_pJson[m_Pos++];
+			if(c == '\\')
+				m_Pos++;
+			else if(c == '"')
+				return true;
+		}
+		return false;
+	}
+
+public:
+	CJsonScanner(const char *pJson, size_t Length) :
+		m_pJson(pJson), m_Length(Length)
+	{
+	}
+
+	size_t Pos() const { return m_Pos; }
+
+	static bool IsWhitespace(char c)
+	{
+		return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+	}
+
+	void SkipWhitespace()
+	{
+		while(m_Pos < m_Length && IsWhitespace(m_pJson[m_Pos]))
+			m_Pos++;
+	}
+
+	bool Consume(char c)
+	{
+		SkipWhitespace();
+		if(m_Pos < m_Length && m_pJson[m_Pos] == c)
+		{
+			m_Pos++;
+			return true;
+		}
+		return false;
+	}
+
+	bool AtEnd()
+	{
+		SkipWhitespace();
+		return m_Pos == m_Length;
+	}
+
+	// returns the raw string without quotes, escape sequences are kept
+	bool ReadString(const char **ppString, size_t *pLength)
+	{
+		SkipWhitespace();
+		if(m_Pos >= m_Length || m_pJson[m_Pos] != '"')
+			return false;
+		const size_t Start = m_Pos + 1;
+		if(!SkipString())
+			return false;
+		*ppString = m_pJson + Start;
+		*pLength = m_Pos - 1 - Start;
+		return true;
+	}
+
+	bool SkipValue(int Depth = 0)
+	{
+		SkipWhitespace();
+		if(m_Pos >= m_Length || Depth > MAX_DEPTH)
+			return false;
+		const char First = m_pJson[m_Pos];
+		if(First == '"')
+			return SkipString();
+		if(First == '{' || First == '[')
+		{
+			m_Pos++;
+			const char Closer = First == '{' ? '}' : ']';
+			if(Consume(Closer))
+				return true;
+			do
+			{
+				if(First == '{')
+				{
+					const char *pName;
+					size_t NameLength;
+					if(!ReadString(&pName, &NameLength) || !Consume(':'))
+						return false;
+				}
+				if(!SkipValue(Depth + 1))
+					return false;
+			} while(Consume(','));
+			return Consume(Closer);
+		}
+		if(SkipLiteral("true") || SkipLiteral("false") || SkipLiteral("null"))
+			return true;
+		return SkipNumber();
+	}
+
+private:
+	enum
+	{
+		MAX_DEPTH = 64,
+	};
+
+	bool SkipLiteral(const char *pLiteral)
+	{
+		const size_t Length = str_length(pLiteral);
+		if(m_Length - m_Pos < Length || mem_comp(m_pJson + m_Pos, pLiteral, Length) != 0)
+			return false;
+		m_Pos += Length;
+		return true;
+	}
+
+	bool SkipDigits()
+	{
+		const size_t Start = m_Pos;
+		while(m_Pos < m_Length && m_pJson[m_Pos] >= '0' && m_pJson[m_Pos] <= '9')
+			m_Pos++;
+		return m_Pos > Start;
+	}
+
+	// -?(0|[1-9][0-9]*)(\.[0-9]+)?([eE][+-]?[0-9]+)?
+	bool SkipNumber()
+	{
+		if(m_Pos < m_Length && m_pJson[m_Pos] == '-')
+			m_Pos++;
+		if(m_Pos < m_Length && m_pJson[m_Pos] == '0')
+			m_Pos++;
+		else if(!SkipDigits())
+			return false;
+		if(m_Pos < m_Length && m_pJson[m_Pos] == '.')
+		{
+			m_Pos++;
+			if(!SkipDigits())
+				return false;
+		}
+		if(m_Pos < m_Length && (m_pJson[m_Pos] == 'e' || m_pJson[m_Pos] == 'E'))
+		{
+			m_Pos++;
+			if(m_Pos < m_Length && (m_pJson[m_Pos] == '+' || m_pJson[m_Pos] == '-'))
+				m_Pos++;
+			if(!SkipDigits())
+				return false;
+		}
+		return true;
+	}
+};
+
+bool JsonParseArrayElements(const char *pJson, size_t Length, const char *pKey, const std::function<bool(const json_value &Element)> &Callback)
+{
+	CJsonScanner Scanner(pJson, Length);
+	if(!Scanner.Consume('{') || Scanner.Consume('}'))
+		return false;
+
+	const size_t KeyLength = str_length(pKey);
+	bool Found = false;
+	do
+	{
+		const char *pName;
+		size_t NameLength;
+		if(!Scanner.ReadString(&pName, &NameLength) || !Scanner.Consume(':'))
+			return false;
+		if(Found || NameLength != KeyLength || mem_comp(pName, pKey, KeyLength) != 0)
+		{
+			if(!Scanner.SkipValue())
+				return false;
+			continue;
+		}
+
+		Found = true;
+		if(!Scanner.Consume('['))
+			return false;
+		if(Scanner.Consume(']'))
+			continue;
+		do
+		{
+			Scanner.SkipWhitespace();
+			const size_t Start = Scanner.Pos();
+			if(!Scanner.SkipValue())
+				return false;
+			json_value *pElement = json_parse(pJson + Start, Scanner.Pos() - Start);
+			if(!pElement)
+				return false;
+			const bool Continue = Callback(*pElement);
+			json_value_free(pElement);
+			if(!Continue)
+				return false;
+		} while(Scanner.Consume(','));
+		if(!Scanner.Consume(']'))
+			return false;
+	} while(Scanner.Consume(','));
+
+	return Scanner.Consume('}') && Scanner.AtEnd() && Found;
+}
+
 static char EscapeJsonChar(char c)
 {
 	switch(c)
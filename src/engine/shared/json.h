@@ -3,6 +3,8 @@
 
 #include <engine/external/json-parser/json.h>
 
+#include <functional>
+
 const struct _json_value *json_object_get(const json_value *object, const char *index);
 const struct _json_value *json_array_get(const json_value *array, int index);
 int json_array_length(const json_value *array);
@@ -10,6 +12,14 @@ const char *json_string_get(const json_value *string);
 int json_int_get(const json_value *integer);
 int json_boolean_get(const json_value *boolean);
 
+// Parses the elements of the array `pKey` of the top-level object one at a
+// time and passes each of them to the callback, which returns false to stop.
+// Only the current element is kept as a tree, the rest of the document is
+// scanned for matching brackets without being parsed.
+// Returns false if the document is malformed, the array was not found or the
+// callback stopped.
+bool JsonParseArrayElements(const char *pJson, size_t Length, const char *pKey, const std::function<bool(const json_value &Element)> &Callback);
+
 char *EscapeJson(char *pBuffer, int BufferSize, const char *pString);
 const char *JsonBool(bool Bool);
 
@@ -2,6 +2,7 @@
 
 #include <engine/console.h>
 #include <engine/shared/config.h>
+#include <engine/shared/linereader.h>
 #include <engine/storage.h>
 
 #include "netban.h"
@@ -29,18 +30,218 @@ CNetBan::CNetHash::CNetHash(const CNetRange *pRange)
 	m_Hash &= 0xFF;
 }
 
-int CNetBan::CNetHash::MakeHashArray(const NETADDR *pAddr, CNetHash aHash[17])
+static int GetBit(const unsigned char *pBytes, int Bit)
 {
-	int Length = pAddr->type == NETTYPE_IPV4 ? 4 : 16;
-	aHash[0].m_Hash = 0;
-	aHash[0].m_HashIndex = 0;
-	for(int i = 1, Sum = 0; i <= Length; ++i)
+	return (pBytes[Bit / 8] >> (7 - Bit % 8)) & 1;
+}
+
+static int CommonPrefixLength(const unsigned char *pBytes1, const unsigned char *pBytes2, int MaxLength)
+{
+	int Length = 0;
+	while(Length < MaxLength && pBytes1[Length / 8] == pBytes2[Length / 8])
+		Length += 8;
+	while(Length < MaxLength && GetBit(pBytes1, Length) == GetBit(pBytes2, Length))
+		++Length;
+	return minimum(Length, MaxLength);
+}
+
+static bool PrefixMatch(const unsigned char *pPrefix, const unsigned char *pBytes, int Length)
+{
+	const int Bytes = Length / 8;
+	if(Bytes > 0 && mem_comp(pPrefix, pBytes, Bytes) != 0)
+		return false;
+	const int Bits = Length % 8;
+	return Bits == 0 || ((pPrefix[Bytes] ^ pBytes[Bytes]) >> (8 - Bits)) == 0;
+}
+
+// calls Fn(pPrefix, Length) for the smallest set of prefixes covering the range
+template<class F>
+static void ForEachPrefix(const CNetRange *pRange, F &&Fn)
+{
+	const int Bytes = pRange->m_LB.type == NETTYPE_IPV4 ? 4 : 16;
+	const int Bits = Bytes * 8;
+	unsigned char aFirst[16], aLast[16];
+	mem_copy(aFirst, pRange->m_LB.ip, Bytes);
+	while(true)
+	{
+		// largest aligned block starting at aFirst that does not exceed the upper bound
+		int Size = 0;
+		while(Size < Bits && GetBit(aFirst, Bits - 1 - Size) == 0)
+			++Size;
+		while(true)
+		{
+			mem_copy(aLast, aFirst, Bytes);
+			for(int i = Bits - Size; i < Bits; ++i)
+				aLast[i / 8] |= 1 << (7 - i % 8);
+			if(mem_comp(aLast, pRange->m_UB.ip, Bytes) <= 0)
+				break;
+			--Size;
+		}
+
+		Fn(aFirst, Bits - Size);
+		if(mem_comp(aLast, pRange->m_UB.ip, Bytes) == 0)
+			break;
+
+		// continue after the block, can't overflow because it ended below the upper bound
+		mem_copy(aFirst, aLast, Bytes);
+		for(int i = Bytes - 1; i >= 0; --i)
+		{
+			if(++aFirst[i] != 0)
+				break;
+		}
+	}
+}
+
+void CNetBan::CBanRangeTrie::Reset()
+{
+	m_vNodes.clear();
+	m_vFreeNodes.clear();
+	const unsigned char aZero[16] = {0};
+	NewNode(aZero, 0);
+	NewNode(aZero, 0);
+}
+
+int CNetBan::CBanRangeTrie::NewNode(const unsigned char *pPrefix, int Length)
+{
+	int Index;
+	if(m_vFreeNodes.empty())
+	{
+		Index = m_vNodes.size();
+		m_vNodes.emplace_back();
+	}
+	else
+	{
+		Index = m_vFreeNodes.back();
+		m_vFreeNodes.pop_back();
+	}
+
+	CNode &Node = m_vNodes[Index];
+	mem_zero(Node.m_aPrefix, sizeof(Node.m_aPrefix));
+	mem_copy(Node.m_aPrefix, pPrefix, (Length + 7) / 8);
+	if(Length % 8)
+		Node.m_aPrefix[Length / 8] &= 0xFF << (8 - Length % 8);
+	Node.m_Length = Length;
+	Node.m_aChildren[0] = Node.m_aChildren[1] = -1;
+	Node.m_vpBans.clear();
+	return Index;
+}
+
+void CNetBan::CBanRangeTrie::InsertPrefix(int Root, const unsigned char *pPrefix, int Length, CBanRange *pBan)
+{
+	int Node = Root;
+	while(m_vNodes[Node].m_Length < Length)
 	{
-		Sum += pAddr->ip[i - 1];
-		aHash[i].m_Hash = Sum & 0xFF;
-		aHash[i].m_HashIndex = i % Length;
+		const int Bit = GetBit(pPrefix, m_vNodes[Node].m_Length);
+		const int Child = m_vNodes[Node].m_aChildren[Bit];
+		if(Child < 0)
+		{
+			const int Leaf = NewNode(pPrefix, Length);
+			m_vNodes[Leaf].m_vpBans.push_back(pBan);
+			m_vNodes[Node].m_aChildren[Bit] = Leaf;
+			return;
+		}
+
+		const int ChildLength = m_vNodes[Child].m_Length;
+		const int Common = CommonPrefixLength(m_vNodes[Child].m_aPrefix, pPrefix, minimum(ChildLength, Length));
+		if(Common == ChildLength)
+		{
+			Node = Child;
+			continue;
+		}
+
+		// the prefix ends or branches off in the middle of the child's path, split it
+		const int Split = NewNode(pPrefix, Common);
+		m_vNodes[Split].m_aChildren[GetBit(m_vNodes[Child].m_aPrefix, Common)] = Child;
+		if(Common == Length)
+			m_vNodes[Split].m_vpBans.push_back(pBan);
+		else
+		{
+			const int Leaf = NewNode(pPrefix, Length);
+			m_vNodes[Leaf].m_vpBans.push_back(pBan);
+			m_vNodes[Split].m_aChildren[GetBit(pPrefix, Common)] = Leaf;
+		}
+		m_vNodes[Node].m_aChildren[Bit] = Split;
+		return;
+	}
+
+	m_vNodes[Node].m_vpBans.push_back(pBan);
+}
+
+void CNetBan::CBanRangeTrie::RemovePrefix(int Root, const unsigned char *pPrefix, int Length, CBanRange *pBan)
+{
+	int aPath[129];
+	int Depth = 0;
+	int Node = Root;
+	while(m_vNodes[Node].m_Length < Length)
+	{
+		aPath[Depth++] = Node;
+		Node = m_vNodes[Node].m_aChildren[GetBit(pPrefix, m_vNodes[Node].m_Length)];
+		if(Node < 0 || m_vNodes[Node].m_Length > Length || !PrefixMatch(m_vNodes[Node].m_aPrefix, pPrefix, m_vNodes[Node].m_Length))
+			return;
+	}
+	if(m_vNodes[Node].m_Length != Length)
+		return;
+
+	std::vector<CBanRange *> &vpBans = m_vNodes[Node].m_vpBans;
+	for(size_t i = 0; i < vpBans.size(); ++i)
+	{
+		if(vpBans[i] == pBan)
+		{
+			vpBans.erase(vpBans.begin() + i);
+			break;
+		}
+	}
+
+	// drop nodes that neither hold bans nor branch, the roots stay
+	while(Depth > 0 && m_vNodes[Node].m_vpBans.empty())
+	{
+		const CNode &Current = m_vNodes[Node];
+		if(Current.m_aChildren[0] >= 0 && Current.m_aChildren[1] >= 0)
+			break;
+
+		const int Parent = aPath[--Depth];
+		const int Replacement = Current.m_aChildren[0] >= 0 ? Current.m_aChildren[0] : Current.m_aChildren[1];
+		m_vNodes[Parent].m_aChildren[m_vNodes[Parent].m_aChildren[1] == Node] = Replacement;
+		m_vFreeNodes.push_back(Node);
+		if(Replacement >= 0)
+			break;
+		Node = Parent;
 	}
-	return Length;
+}
+
+void CNetBan::CBanRangeTrie::Insert(CBanRange *pBan)
+{
+	const int Root = pBan->m_Data.m_LB.type == NETTYPE_IPV4 ? 0 : 1;
+	ForEachPrefix(&pBan->m_Data, [&](const unsigned char *pPrefix, int Length) {
+		InsertPrefix(Root, pPrefix, Length, pBan);
+	});
+}
+
+void CNetBan::CBanRangeTrie::Remove(CBanRange *pBan)
+{
+	const int Root = pBan->m_Data.m_LB.type == NETTYPE_IPV4 ? 0 : 1;
+	ForEachPrefix(&pBan->m_Data, [&](const unsigned char *pPrefix, int Length) {
+		RemovePrefix(Root, pPrefix, Length, pBan);
+	});
+}
+
+CNetBan::CBanRange *CNetBan::CBanRangeTrie::Find(const NETADDR *pAddr) const
+{
+	const int Bits = pAddr->type == NETTYPE_IPV4 ? 32 : 128;
+	CBanRange *pFound = 0;
+	int Node = pAddr->type == NETTYPE_IPV4 ? 0 : 1;
+	while(true)
+	{
+		const CNode &Current = m_vNodes[Node];
+		if(!Current.m_vpBans.empty())
+			pFound = Current.m_vpBans.front();
+		if(Current.m_Length == Bits)
+			break;
+		Node = Current.m_aChildren[GetBit(pAddr->ip, Current.m_Length)];
+		if(Node < 0 || !PrefixMatch(m_vNodes[Node].m_aPrefix, pAddr->ip, m_vNodes[Node].m_Length))
+			break;
+	}
+	return pFound;
 }
 
 template<class T, int HashCount>
@@ -80,10 +281,27 @@ void CNetBan::CBanPool<T, HashCount>::InsertUsed(CBan<T> *pBan)
 	}
 }
 
+template<class T, int HashCount>
+bool CNetBan::CBanPool<T, HashCount>::Grow()
+{
+	if((int)m_vpChunks.size() * CHUNK_SIZE >= MAX_BANS)
+		return false;
+
+	CBan<T> *pChunk = new CBan<T>[CHUNK_SIZE]();
+	m_vpChunks.emplace_back(pChunk);
+	for(int i = 0; i < CHUNK_SIZE; ++i)
+	{
+		pChunk[i].m_pPrev = i > 0 ? &pChunk[i - 1] : 0;
+		pChunk[i].m_pNext = i < CHUNK_SIZE - 1 ? &pChunk[i + 1] : 0;
+	}
+	m_pFirstFree = pChunk;
+	return true;
+}
+
 template<class T, int HashCount>
 typename CNetBan::CBan<T> *CNetBan::CBanPool<T, HashCount>::Add(const T *pData, const CBanInfo *pInfo, const CNetHash *pNetHash)
 {
-	if(!m_pFirstFree)
+	if(!m_pFirstFree && !Grow())
 		return 0;
 
 	// create new ban
@@ -177,19 +395,31 @@ template<class T, int HashCount>
 void CNetBan::CBanPool<T, HashCount>::Reset()
 {
 	mem_zero(m_aapHashList, sizeof(m_aapHashList));
-	mem_zero(m_aBans, sizeof(m_aBans));
+	m_vpChunks.clear();
+	m_pFirstFree = 0;
 	m_pFirstUsed = 0;
 	m_CountUsed = 0;
+}
 
-	for(int i = 1; i < MAX_BANS - 1; ++i)
-	{
-		m_aBans[i].m_pNext = &m_aBans[i + 1];
-		m_aBans[i].m_pPrev = &m_aBans[i - 1];
-	}
+CNetBan::CBanRange *CNetBan::CBanRangePool::Add(const CNetRange *pData, const CBanInfo *pInfo, const CNetHash *pNetHash)
+{
+	CBanRange *pBan = CBanPool<CNetRange, 16>::Add(pData, pInfo, pNetHash);
+	if(pBan)
+		m_Trie.Insert(pBan);
+	return pBan;
+}
 
-	m_aBans[0].m_pNext = &m_aBans[1];
-	m_aBans[MAX_BANS - 1].m_pPrev = &m_aBans[MAX_BANS - 2];
-	m_pFirstFree = &m_aBans[0];
+int CNetBan::CBanRangePool::Remove(CBanRange *pBan)
+{
+	if(pBan)
+		m_Trie.Remove(pBan);
+	return CBanPool<CNetRange, 16>::Remove(pBan);
+}
+
+void CNetBan::CBanRangePool::Reset()
+{
+	CBanPool<CNetRange, 16>::Reset();
+	m_Trie.Reset();
 }
 
 template<class T, int HashCount>
@@ -232,6 +462,8 @@ int CNetBan::Ban(T *pBanPool, const typename T::CDataType *pData, int Seconds, c
 	{
 		// adjust the ban
 		pBanPool->Update(pBan, &Info);
+		if(m_Importing)
+			return 1;
 		char aBuf[256];
 		MakeBanInfo(pBan, aBuf, sizeof(aBuf), MSGTYPE_LIST);
 		Console()->Print(IConsole::OUTPUT_LEVEL_STANDARD, "net_ban", aBuf);
@@ -242,6 +474,8 @@ int CNetBan::Ban(T *pBanPool, const typename T::CDataType *pData, int Seconds, c
 	pBan = pBanPool->Add(pData, &Info, &NetHash);
 	if(pBan)
 	{
+		if(m_Importing)
+			return 0;
 		char aBuf[256];
 		MakeBanInfo(pBan, aBuf, sizeof(aBuf), MSGTYPE_BANADD);
 		Console()->Print(IConsole::OUTPUT_LEVEL_STANDARD, "net_ban", aBuf);
@@ -287,6 +521,7 @@ void CNetBan::Init(IConsole *pConsole, IStorage *pStorage)
 	Console()->Register("unban_all", "", CFGFLAG_SERVER | CFGFLAG_MASTER | CFGFLAG_STORE, ConUnbanAll, this, "Unban all entries");
 	Console()->Register("bans", "?i[page]", CFGFLAG_SERVER | CFGFLAG_MASTER, ConBans, this, "Show banlist (page 1 by default, 20 entries per page)");
 	Console()->Register("bans_save", "s[file]", CFGFLAG_SERVER | CFGFLAG_MASTER | CFGFLAG_STORE, ConBansSave, this, "Save banlist in a file");
+	Console()->Register("bans_import", "s[file] ?i[minutes] ?r[reason]", CFGFLAG_SERVER | CFGFLAG_MASTER | CFGFLAG_STORE, ConBansImport, this, "Ban all addresses, prefixes (ip/len) and ranges (first ip - last ip) listed in a file, one per line");
 }
 
 void CNetBan::Update()
@@ -378,11 +613,10 @@ bool CNetBan::IsBanned(const NETADDR *pOrigAddr, char *pBuf, unsigned BufferSize
 		pAddr = &Addr;
 		Addr.type = NETTYPE_IPV4;
 	}
-	CNetHash aHash[17];
-	int Length = CNetHash::MakeHashArray(pAddr, aHash);
 
 	// check ban addresses
-	CBanAddr *pBan = m_BanAddrPool.Find(pAddr, &aHash[Length]);
+	CNetHash NetHash(pAddr);
+	CBanAddr *pBan = m_BanAddrPool.Find(pAddr, &NetHash);
 	if(pBan)
 	{
 		MakeBanInfo(pBan, pBuf, BufferSize, MSGTYPE_PLAYER);
@@ -390,19 +624,104 @@ bool CNetBan::IsBanned(const NETADDR *pOrigAddr, char *pBuf, unsigned BufferSize
 	}
 
 	// check ban ranges
-	for(int i = Length - 1; i >= 0; --i)
+	CBanRange *pBanRange = m_BanRangePool.Find(pAddr);
+	if(pBanRange)
 	{
-		for(CBanRange *pBanRange = m_BanRangePool.First(&aHash[i]); pBanRange; pBanRange = pBanRange->m_pHashNext)
+		MakeBanInfo(pBanRange, pBuf, BufferSize, MSGTYPE_PLAYER);
+		return true;
+	}
+
+	return false;
+}
+
+static bool NetAddrFromListStr(NETADDR *pAddr, const char *pStr)
+{
+	// lists usually contain ipv6 addresses without brackets
+	char aBuf[128];
+	if(pStr[0] != '[' && str_find(pStr, ":") != str_rchr(pStr, ':'))
+	{
+		str_format(aBuf, sizeof(aBuf), "[%s]", pStr);
+		pStr = aBuf;
+	}
+	return net_addr_from_str(pAddr, pStr) == 0 && (pAddr->type == NETTYPE_IPV4 || pAddr->type == NETTYPE_IPV6);
+}
+
+bool CNetBan::NetRangeFromStr(CNetRange *pRange, const char *pStr)
+{
+	char aBuf[128];
+	str_copy(aBuf, pStr);
+	str_clean_whitespaces(aBuf);
+
+	char *pSeparator = (char *)str_find(aBuf, "/");
+	if(pSeparator)
+	{
+		*pSeparator = 0;
+		const char *pLength = str_skip_whitespaces(pSeparator + 1);
+		str_utf8_trim_right(aBuf);
+		if(!NetAddrFromListStr(&pRange->m_LB, aBuf) || !pLength[0] || !str_isallnum(pLength))
+			return false;
+		const int Bits = pRange->m_LB.type == NETTYPE_IPV4 ? 32 : 128;
+		const int Length = str_toint(pLength);
+		if(Length > Bits)
+			return false;
+
+		pRange->m_UB = pRange->m_LB;
+		for(int i = Length; i < Bits; ++i)
 		{
-			if(NetMatch(&pBanRange->m_Data, pAddr, i, Length))
-			{
-				MakeBanInfo(pBanRange, pBuf, BufferSize, MSGTYPE_PLAYER);
-				return true;
-			}
+			pRange->m_LB.ip[i / 8] &= ~(1 << (7 - i % 8));
+			pRange->m_UB.ip[i / 8] |= 1 << (7 - i % 8);
 		}
+		return true;
 	}
 
-	return false;
+	pSeparator = (char *)str_find(aBuf, "-");
+	if(!pSeparator)
+		pSeparator = str_skip_to_whitespace(aBuf);
+	if(!*pSeparator)
+	{
+		if(!NetAddrFromListStr(&pRange->m_LB, aBuf))
+			return false;
+		pRange->m_UB = pRange->m_LB;
+		return true;
+	}
+
+	*pSeparator = 0;
+	str_utf8_trim_right(aBuf);
+	return NetAddrFromListStr(&pRange->m_LB, aBuf) && NetAddrFromListStr(&pRange->m_UB, str_skip_whitespaces(pSeparator + 1)) &&
+	       pRange->m_LB.type == pRange->m_UB.type && NetComp(&pRange->m_LB, &pRange->m_UB) <= 0;
+}
+
+int CNetBan::ImportBans(CLineReader *pLineReader, int Seconds, const char *pReason)
+{
+	int Imported = 0;
+	int Failed = 0;
+	m_Importing = true;
+	while(const char *pLine = pLineReader->Get())
+	{
+		pLine = str_skip_whitespaces_const(pLine);
+		if(!pLine[0] || pLine[0] == '#')
+			continue;
+
+		CNetRange Range;
+		int Result = -1;
+		if(NetRangeFromStr(&Range, pLine))
+		{
+			if(NetComp(&Range.m_LB, &Range.m_UB) == 0)
+				Result = BanAddr(&Range.m_LB, Seconds, pReason, false);
+			else
+				Result = BanRange(&Range, Seconds, pReason);
+		}
+		if(Result < 0)
+			++Failed;
+		else
+			++Imported;
+	}
+	m_Importing = false;
+
+	char aBuf[128];
+	str_format(aBuf, sizeof(aBuf), "imported %d bans, %d failed", Imported, Failed);
+	Console()->Print(IConsole::OUTPUT_LEVEL_STANDARD, "net_ban", aBuf);
+	return Imported;
 }
 
 void CNetBan::ConBan(IConsole::IResult *pResult, void *pUser)
@@ -565,3 +884,22 @@ void CNetBan::ConBansSave(IConsole::IResult *pResult, void *pUser)
 	str_format(aBuf, sizeof(aBuf), "saved banlist to '%s'", pResult->GetString(0));
 	pThis->Console()->Print(IConsole::OUTPUT_LEVEL_STANDARD, "net_ban", aBuf);
 }
+
+void CNetBan::ConBansImport(IConsole::IResult *pResult, void *pUser)
+{
+	CNetBan *pThis = static_cast<CNetBan *>(pUser);
+
+	const char *pFilename = pResult->GetString(0);
+	int Minutes = pResult->NumArguments() > 1 ? clamp(pResult->GetInteger(1), 0, 525600) : 0;
+	const char *pReason = pResult->NumArguments() > 2 ? pResult->GetString(2) : "No reason given";
+
+	CLineReader LineReader;
+	if(!LineReader.OpenFile(pThis->Storage()->OpenFile(pFilename, IOFLAG_READ, IStorage::TYPE_ALL)))
+	{
+		char aBuf[256];
+		str_format(aBuf, sizeof(aBuf), "failed to import bans from '%s'", pFilename);
+		pThis->Console()->Print(IConsole::OUTPUT_LEVEL_STANDARD, "net_ban", aBuf);
+		return;
+	}
+	pThis->ImportBans(&LineReader, Minutes * 60, pReason);
+}
@@ -4,6 +4,9 @@
 #include <base/system.h>
 #include <engine/console.h>
 
+#include <memory>
+#include <vector>
+
 inline int NetComp(const NETADDR *pAddr1, const NETADDR *pAddr2)
 {
 	return mem_comp(pAddr1, pAddr2, pAddr1->type == NETTYPE_IPV4 ? 8 : 20);
@@ -68,8 +71,6 @@ protected:
 		CNetHash() = default;
 		CNetHash(const NETADDR *pAddr);
 		CNetHash(const CNetRange *pRange);
-
-		static int MakeHashArray(const NETADDR *pAddr, CNetHash aHash[17]);
 	};
 
 	struct CBanInfo
@@ -106,6 +107,11 @@ protected:
 	public:
 		typedef T CDataType;
 
+		enum
+		{
+			MAX_BANS = 65536,
+		};
+
 		CBan<CDataType> *Add(const CDataType *pData, const CBanInfo *pInfo, const CNetHash *pNetHash);
 		int Remove(CBan<CDataType> *pBan);
 		void Update(CBan<CDataType> *pBan, const CBanInfo *pInfo);
@@ -131,23 +137,66 @@ protected:
 	private:
 		enum
 		{
-			MAX_BANS = 1024,
+			CHUNK_SIZE = 1024,
 		};
 
 		CBan<CDataType> *m_aapHashList[HashCount][256];
-		CBan<CDataType> m_aBans[MAX_BANS];
+		std::vector<std::unique_ptr<CBan<CDataType>[]>> m_vpChunks; // bans are allocated in chunks so pointers stay valid
 		CBan<CDataType> *m_pFirstFree;
 		CBan<CDataType> *m_pFirstUsed;
 		int m_CountUsed;
 
 		void InsertUsed(CBan<CDataType> *pBan);
+		bool Grow();
 	};
 
 	typedef CBanPool<NETADDR, 1> CBanAddrPool;
-	typedef CBanPool<CNetRange, 16> CBanRangePool;
 	typedef CBan<NETADDR> CBanAddr;
 	typedef CBan<CNetRange> CBanRange;
 
+	// path compressed binary trie over the address bits, every range is
+	// split into prefixes (CIDR blocks) which point back to the range ban
+	class CBanRangeTrie
+	{
+		struct CNode
+		{
+			unsigned char m_aPrefix[16];
+			int m_Length; // in bits
+			int m_aChildren[2];
+			std::vector<CBanRange *> m_vpBans;
+		};
+
+		std::vector<CNode> m_vNodes; // the first two nodes are the ipv4 and ipv6 roots
+		std::vector<int> m_vFreeNodes;
+
+		int NewNode(const unsigned char *pPrefix, int Length);
+		void InsertPrefix(int Root, const unsigned char *pPrefix, int Length, CBanRange *pBan);
+		void RemovePrefix(int Root, const unsigned char *pPrefix, int Length, CBanRange *pBan);
+
+	public:
+		void Reset();
+		void Insert(CBanRange *pBan);
+		void Remove(CBanRange *pBan);
+
+		// returns the ban of the longest prefix that contains the address
+		CBanRange *Find(const NETADDR *pAddr) const;
+		int NumNodes() const { return m_vNodes.size() - m_vFreeNodes.size(); }
+	};
+
+	class CBanRangePool : public CBanPool<CNetRange, 16>
+	{
+		CBanRangeTrie m_Trie;
+
+	public:
+		CBanRange *Add(const CNetRange *pData, const CBanInfo *pInfo, const CNetHash *pNetHash);
+		int Remove(CBanRange *pBan);
+		void Reset();
+
+		CBanRange *Find(const NETADDR *pAddr) const { return m_Trie.Find(pAddr); }
+		using CBanPool<CNetRange, 16>::Find;
+		const CBanRangeTrie &Trie() const { return m_Trie; }
+	};
+
 	template<class T>
 	void MakeBanInfo(const CBan<T> *pBan, char *pBuf, unsigned BuffSize, int Type) const;
 	template<class T>
@@ -160,6 +209,7 @@ protected:
 	CBanAddrPool m_BanAddrPool;
 	CBanRangePool m_BanRangePool;
 	NETADDR m_LocalhostIpV4, m_LocalhostIpV6;
+	bool m_Importing = false;
 
 public:
 	enum
@@ -185,6 +235,10 @@ public:
 	void UnbanAll();
 	bool IsBanned(const NETADDR *pOrigAddr, char *pBuf, unsigned BufferSize) const;
 
+	// bans every entry of a list, one address, prefix ("ip/len") or range ("first ip - last ip") per line
+	int ImportBans(class CLineReader *pLineReader, int Seconds, const char *pReason);
+	static bool NetRangeFromStr(CNetRange *pRange, const char *pStr);
+
 	static void ConBan(class IConsole::IResult *pResult, void *pUser);
 	static void ConBanRange(class IConsole::IResult *pResult, void *pUser);
 	static void ConUnban(class IConsole::IResult *pResult, void *pUser);
@@ -192,6 +246,7 @@ public:
 	static void ConUnbanAll(class IConsole::IResult *pResult, void *pUser);
 	static void ConBans(class IConsole::IResult *pResult, void *pUser);
 	static void ConBansSave(class IConsole::IResult *pResult, void *pUser);
+	static void ConBansImport(class IConsole::IResult *pResult, void *pUser);
 };
 
 template<class T>
@@ -345,6 +345,7 @@ public:
 	int State() const { return m_State; }
 	const NETADDR *PeerAddress() const { return &m_PeerAddr; }
 	const char *ErrorString() const { return m_aErrorString; }
+	NETSOCKET Socket() const { return m_Socket; }
 
 	void Reset();
 	int Update();
@@ -496,6 +497,7 @@ public:
 	int Recv(char *pLine, int MaxLength, int *pClientId = nullptr);
 	int Send(int ClientId, const char *pLine);
 	int Update();
+	void AddToWait(NETWAIT *pWait) const;
 
 	//
 	int AcceptClient(NETSOCKET Socket, const NETADDR *pAddr);
@@ -91,6 +91,16 @@ int CNetConsole::AcceptClient(NETSOCKET Socket, const NETADDR *pAddr)
 	return -1;
 }
 
+void CNetConsole::AddToWait(NETWAIT *pWait) const
+{
+	net_wait_add_socket(pWait, m_Socket);
+	for(const auto &Slot : m_aSlots)
+	{
+		if(Slot.m_Connection.State() == NET_CONNSTATE_ONLINE)
+			net_wait_add_socket(pWait, Slot.m_Connection.Socket());
+	}
+}
+
 int CNetConsole::Update()
 {
 	NETSOCKET Socket;
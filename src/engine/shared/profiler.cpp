@@ -0,0 +1,130 @@
+#include "profiler.h"
+
+#include "csv.h"
+
+#include <base/math.h>
+
+#include <iterator> // std::size
+
+int CProfiler::BucketIndex(int64_t Microseconds)
+{
+	int Bucket = 0;
+	while(Microseconds >= 2 && Bucket < NUM_BUCKETS - 1)
+	{
+		Microseconds >>= 1;
+		Bucket++;
+	}
+	return Bucket;
+}
+
+int64_t CProfiler::BucketUpperBound(int Bucket)
+{
+	return (int64_t)1 << (Bucket + 1);
+}
+
+int64_t CProfiler::CScopeStats::Percentile(float Percentile) const
+{
+	if(m_NumSamples == 0)
+		return 0;
+	const int64_t Wanted = maximum<int64_t>(1, (int64_t)(m_NumSamples * (Percentile / 100.0f) + 0.5f));
+	int64_t Count = 0;
+	for(int i = 0; i < NUM_BUCKETS; i++)
+	{
+		Count += m_aBuckets[i];
+		if(Count >= Wanted)
+			return minimum(BucketUpperBound(i), m_MaxTime);
+	}
+	return m_MaxTime;
+}
+
+void CProfiler::Init(const char *const *ppNames, int NumScopes)
+{
+	m_vScopes.resize(NumScopes);
+	for(int i = 0; i < NumScopes; i++)
+		m_vScopes[i].m_pName = ppNames[i];
+	Reset();
+}
+
+void CProfiler::SetSampleInterval(int Interval)
+{
+	m_SampleInterval = maximum(Interval, 0);
+	if(m_SampleInterval == 0)
+		m_Sampling = false;
+}
+
+bool CProfiler::BeginSample()
+{
+	m_Sampling = m_SampleInterval > 0 && (m_SampleCounter++ % m_SampleInterval) == 0;
+	if(m_Sampling)
+		m_NumSamples++;
+	return m_Sampling;
+}
+
+void CProfiler::Record(int Scope, int64_t Duration)
+{
+	dbg_assert(Scope >= 0 && Scope < NumScopes(), "invalid profiler scope");
+	const int64_t Microseconds = Duration * 1000000 / time_freq();
+	CScopeStats &Stats = m_vScopes[Scope];
+	Stats.m_NumSamples++;
+	Stats.m_TotalTime += Microseconds;
+	Stats.m_MaxTime = maximum(Stats.m_MaxTime, Microseconds);
+	Stats.m_aBuckets[BucketIndex(Microseconds)]++;
+}
+
+void CProfiler::Reset()
+{
+	for(auto &Stats : m_vScopes)
+	{
+		Stats.m_NumSamples = 0;
+		Stats.m_TotalTime = 0;
+		Stats.m_MaxTime = 0;
+		mem_zero(Stats.m_aBuckets, sizeof(Stats.m_aBuckets));
+	}
+	m_SampleCounter = 0;
+	m_NumSamples = 0;
+}
+
+void CProfiler::FormatSummary(int Scope, char *pBuf, int BufSize) const
+{
+	const CScopeStats &Stats = m_vScopes[Scope];
+	str_format(pBuf, BufSize, "%s: samples=%" PRId64 " avg=%" PRId64 "us p50<=%" PRId64 "us p99<=%" PRId64 "us max=%" PRId64 "us",
+		Stats.m_pName, Stats.m_NumSamples, Stats.Average(), Stats.Percentile(50.0f), Stats.Percentile(99.0f), Stats.m_MaxTime);
+}
+
+void CProfiler::FormatHistogram(int Scope, char *pBuf, int BufSize) const
+{
+	const CScopeStats &Stats = m_vScopes[Scope];
+	str_copy(pBuf, "  ", BufSize);
+	for(int i = 0; i < NUM_BUCKETS; i++)
+	{
+		if(Stats.m_aBuckets[i] == 0)
+			continue;
+		char aBucket[64];
+		if(i == NUM_BUCKETS - 1)
+			str_format(aBucket, sizeof(aBucket), " >=%" PRId64 "us:%" PRId64, BucketUpperBound(i - 1), Stats.m_aBuckets[i]);
+		else
+			str_format(aBucket, sizeof(aBucket), " <%" PRId64 "us:%" PRId64, BucketUpperBound(i), Stats.m_aBuckets[i]);
+		str_append(pBuf, aBucket, BufSize);
+	}
+}
+
+void CProfiler::WriteCsv(IOHANDLE File, const char *pTag) const
+{
+	const char *apHeader[] = {"tag", "scope", "bucket_upper_us", "count"};
+	CsvWrite(File, std::size(apHeader), apHeader);
+	for(const auto &Stats : m_vScopes)
+	{
+		for(int i = 0; i < NUM_BUCKETS; i++)
+		{
+			char aUpper[32];
+			char aCount[32];
+			if(i == NUM_BUCKETS - 1)
+				str_copy(aUpper, "inf");
+			else
+				str_format(aUpper, sizeof(aUpper), "%" PRId64, BucketUpperBound(i));
+			str_format(aCount, sizeof(aCount), "%" PRId64, Stats.m_aBuckets[i]);
+			const char *apColumns[] = {pTag, Stats.m_pName, aUpper, aCount};
+			CsvWrite(File, std::size(apColumns), apColumns);
+		}
+	}
+}
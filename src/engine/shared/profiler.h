@@ -0,0 +1,143 @@
+#ifndef ENGINE_SHARED_PROFILER_H
+#define ENGINE_SHARED_PROFILER_H
+
+#include <base/system.h>
+
+#include <vector>
+
+/**
+ * Collects latency histograms for a fixed set of named scopes.
+ *
+ * Only every n-th sample (usually a tick or a frame) is recorded, so the
+ * profiler can stay enabled in production with negligible overhead.
+ *
+ * @see CProfileScope
+ */
+class CProfiler
+{
+public:
+	enum
+	{
+		/**
+		 * Number of power-of-two histogram buckets. Bucket `i` counts durations
+		 * below `2^(i+1)` microseconds, the last bucket counts everything longer.
+		 */
+		NUM_BUCKETS = 24,
+	};
+
+	class CScopeStats
+	{
+	public:
+		const char *m_pName;
+		int64_t m_NumSamples;
+		int64_t m_TotalTime; // in microseconds
+		int64_t m_MaxTime; // in microseconds
+		int64_t m_aBuckets[NUM_BUCKETS];
+
+		/**
+		 * Returns an upper bound for the given percentile in microseconds,
+		 * based on the histogram buckets.
+		 *
+		 * @param Percentile Value between 0 and 100.
+		 */
+		int64_t Percentile(float Percentile) const;
+		int64_t Average() const { return m_NumSamples ? m_TotalTime / m_NumSamples : 0; }
+	};
+
+private:
+	std::vector<CScopeStats> m_vScopes;
+	int m_SampleInterval = 0;
+	int64_t m_SampleCounter = 0;
+	int64_t m_NumSamples = 0;
+	bool m_Sampling = false;
+
+public:
+	static int BucketIndex(int64_t Microseconds);
+	static int64_t BucketUpperBound(int Bucket);
+
+	/**
+	 * Sets the names of the profiled scopes. Resets all statistics.
+	 *
+	 * @param ppNames Scope names, must stay valid for the lifetime of the profiler.
+	 * @param NumScopes Number of scopes.
+	 */
+	void Init(const char *const *ppNames, int NumScopes);
+
+	/**
+	 * Sets how often samples are recorded.
+	 *
+	 * @param Interval Record every `Interval`-th sample, `0` disables the profiler.
+	 */
+	void SetSampleInterval(int Interval);
+	int SampleInterval() const { return m_SampleInterval; }
+
+	/**
+	 * Starts a new sample and decides whether it is recorded.
+	 *
+	 * @return `true` if scopes should be measured until @link EndSample @endlink.
+	 */
+	bool BeginSample();
+	void EndSample() { m_Sampling = false; }
+	bool IsSampling() const { return m_Sampling; }
+	int64_t NumSamples() const { return m_NumSamples; }
+
+	/**
+	 * Adds a measurement for a scope, independent of the sampling state.
+	 *
+	 * @param Scope Index of the scope.
+	 * @param Duration Duration in @link time_get @endlink units.
+	 */
+	void Record(int Scope, int64_t Duration);
+	void Reset();
+
+	int NumScopes() const { return m_vScopes.size(); }
+	const CScopeStats &Stats(int Scope) const { return m_vScopes[Scope]; }
+
+	/**
+	 * Formats a one-line summary of the given scope.
+	 */
+	void FormatSummary(int Scope, char *pBuf, int BufSize) const;
+
+	/**
+	 * Formats the non-empty histogram buckets of the given scope.
+	 */
+	void FormatHistogram(int Scope, char *pBuf, int BufSize) const;
+
+	/**
+	 * Writes one CSV line per scope and bucket, preceded by a header line.
+	 *
+	 * @param File Handle to write to.
+	 * @param pTag Value of the first column, e.g. the current map name.
+	 */
+	void WriteCsv(IOHANDLE File, const char *pTag) const;
+};
+
+/**
+ * Measures the lifetime of the object and records it in a @link CProfiler @endlink
+ * if the profiler is currently sampling.
+ */
+class CProfileScope
+{
+	CProfiler *m_pProfiler;
+	int m_Scope;
+	int64_t m_Start;
+
+public:
+	CProfileScope(CProfiler *pProfiler, int Scope) :
+		m_pProfiler(pProfiler->IsSampling() ? pProfiler : nullptr),
+		m_Scope(Scope),
+		m_Start(m_pProfiler ? time_get() : 0)
+	{
+	}
+
+	~CProfileScope()
+	{
+		if(m_pProfiler)
+			m_pProfiler->Record(m_Scope, time_get() - m_Start);
+	}
+
+	CProfileScope(const CProfileScope &Other) = delete;
+	CProfileScope &operator=(const CProfileScope &Other) = delete;
+};
+
+#endif
@@ -0,0 +1,117 @@
+#include "trace.h"
+
+#include "jsonwriter.h"
+
+#include <base/math.h>
+
+void CTraceRecorder::Add(const char *pName, EPhase Phase)
+{
+	CEvent &Event = m_vEvents[m_Next];
+	Event.m_pName = pName;
+	Event.m_Time = time_get_nanoseconds().count();
+	Event.m_Phase = Phase;
+	m_Next = (m_Next + 1) % m_vEvents.size();
+	if(m_NumEvents < m_vEvents.size())
+		m_NumEvents++;
+}
+
+void CTraceRecorder::SetEnabled(bool Enabled, size_t Capacity)
+{
+	dbg_assert(Capacity > 0, "trace capacity must be positive");
+	if(Capacity != m_vEvents.size())
+	{
+		m_vEvents.resize(Capacity);
+		Clear();
+	}
+	m_Enabled = Enabled;
+}
+
+void CTraceRecorder::Clear()
+{
+	m_Next = 0;
+	m_NumEvents = 0;
+}
+
+const CTraceRecorder::CEvent &CTraceRecorder::Event(size_t Index) const
+{
+	dbg_assert(Index < m_NumEvents, "trace event index out of range");
+	const size_t First = m_NumEvents < m_vEvents.size() ? 0 : m_Next;
+	return m_vEvents[(First + Index) % m_vEvents.size()];
+}
+
+CTraceSummary::CScope &CTraceSummary::Find(const char *pName)
+{
+	for(auto &Scope : m_vScopes)
+	{
+		if(Scope.m_pName == pName || str_comp(Scope.m_pName, pName) == 0)
+			return Scope;
+	}
+	m_vScopes.push_back({pName, 0, 0, 0});
+	return m_vScopes.back();
+}
+
+void CTraceSummary::Add(const CTraceRecorder &Recorder)
+{
+	m_vStack.clear();
+	for(size_t i = 0; i < Recorder.NumEvents(); i++)
+	{
+		const CTraceRecorder::CEvent &Ev = Recorder.Event(i);
+		if(Ev.m_Phase == CTraceRecorder::PHASE_BEGIN)
+		{
+			m_vStack.push_back(i);
+			continue;
+		}
+		if(m_vStack.empty())
+			continue;
+
+		const CTraceRecorder::CEvent &Begin = Recorder.Event(m_vStack.back());
+		m_vStack.pop_back();
+		const int64_t Duration = Ev.m_Time - Begin.m_Time;
+		CScope &Scope = Find(Begin.m_pName);
+		Scope.m_Count++;
+		Scope.m_TotalTime += Duration;
+		Scope.m_MaxTime = maximum(Scope.m_MaxTime, Duration);
+	}
+}
+
+void CTraceRecorder::WriteChromeTrace(CJsonWriter *pWriter) const
+{
+	pWriter->BeginObject();
+	pWriter->WriteAttribute("displayTimeUnit");
+	pWriter->WriteStrValue("ms");
+	pWriter->WriteAttribute("traceEvents");
+	pWriter->BeginArray();
+
+	const int64_t StartTime = m_NumEvents ? Event(0).m_Time : 0;
+	int Depth = 0;
+	for(size_t i = 0; i < m_NumEvents; i++)
+	{
+		const CEvent &Ev = Event(i);
+		if(Ev.m_Phase == PHASE_END)
+		{
+			if(Depth == 0)
+				continue;
+			Depth--;
+		}
+		else
+		{
+			Depth++;
+		}
+
+		pWriter->BeginObject();
+		pWriter->WriteAttribute("name");
+		pWriter->WriteStrValue(Ev.m_pName);
+		pWriter->WriteAttribute("ph");
+		pWriter->WriteStrValue(Ev.m_Phase == PHASE_BEGIN ? "B" : "E");
+		pWriter->WriteAttribute("ts");
+		pWriter->WriteIntValue((Ev.m_Time - StartTime) / 1000);
+		pWriter->WriteAttribute("pid");
+		pWriter->WriteIntValue(1);
+		pWriter->WriteAttribute("tid");
+		pWriter->WriteIntValue(1);
+		pWriter->EndObject();
+	}
+
+	pWriter->EndArray();
+	pWriter->EndObject();
+}
@@ -0,0 +1,148 @@
+#ifndef ENGINE_SHARED_TRACE_H
+#define ENGINE_SHARED_TRACE_H
+
+#include <base/system.h>
+
+#include <vector>
+
+class CJsonWriter;
+
+/**
+ * Records begin/end events of named scopes into a fixed-size ring buffer,
+ * which can be exported in the Chrome trace event format and viewed with
+ * chrome://tracing or Perfetto.
+ *
+ * @remark Not thread-safe, events must be recorded from a single thread.
+ *
+ * @see CTraceScope
+ */
+class CTraceRecorder
+{
+public:
+	enum EPhase
+	{
+		PHASE_BEGIN,
+		PHASE_END,
+	};
+
+	class CEvent
+	{
+	public:
+		const char *m_pName;
+		int64_t m_Time; // in nanoseconds
+		EPhase m_Phase;
+	};
+
+private:
+	std::vector<CEvent> m_vEvents;
+	size_t m_Next = 0;
+	size_t m_NumEvents = 0;
+	bool m_Enabled = false;
+
+	void Add(const char *pName, EPhase Phase);
+
+public:
+	/**
+	 * Starts or stops recording. The buffer is kept when stopping.
+	 *
+	 * @param Enabled Whether events should be recorded.
+	 * @param Capacity Maximum number of events kept, older events are overwritten.
+	 */
+	void SetEnabled(bool Enabled, size_t Capacity);
+	bool Enabled() const { return m_Enabled; }
+
+	/**
+	 * Records the start of a scope.
+	 *
+	 * @param pName Name of the scope, must stay valid until the recorder is cleared.
+	 */
+	void Begin(const char *pName)
+	{
+		if(m_Enabled)
+			Add(pName, PHASE_BEGIN);
+	}
+	void End(const char *pName)
+	{
+		if(m_Enabled)
+			Add(pName, PHASE_END);
+	}
+
+	void Clear();
+	size_t NumEvents() const { return m_NumEvents; }
+
+	/**
+	 * Returns the recorded events in chronological order.
+	 *
+	 * @param Index Index of the event, `0` is the oldest one.
+	 */
+	const CEvent &Event(size_t Index) const;
+
+	/**
+	 * Writes all recorded events as a Chrome trace JSON object. End events whose
+	 * begin event was already overwritten are skipped.
+	 */
+	void WriteChromeTrace(CJsonWriter *pWriter) const;
+};
+
+/**
+ * Accumulates the durations of the scopes recorded by a @link CTraceRecorder @endlink
+ * over many frames, e.g. to report the CPU time of every component in a benchmark.
+ */
+class CTraceSummary
+{
+public:
+	class CScope
+	{
+	public:
+		const char *m_pName;
+		int64_t m_Count;
+		int64_t m_TotalTime; // in nanoseconds
+		int64_t m_MaxTime; // in nanoseconds
+	};
+
+private:
+	std::vector<CScope> m_vScopes;
+	std::vector<size_t> m_vStack;
+
+	CScope &Find(const char *pName);
+
+public:
+	/**
+	 * Adds the durations of all complete scopes in the recorder. Scopes are
+	 * identified by name, nested scopes are included in the time of their parent.
+	 * End events without a begin event are ignored.
+	 */
+	void Add(const CTraceRecorder &Recorder);
+	void Reset() { m_vScopes.clear(); }
+
+	/**
+	 * Returns the scopes in the order in which they first completed.
+	 */
+	const std::vector<CScope> &Scopes() const { return m_vScopes; }
+};
+
+/**
+ * Records a begin event on construction and the matching end event on destruction.
+ */
+class CTraceScope
+{
+	CTraceRecorder *m_pRecorder;
+	const char *m_pName;
+
+public:
+	CTraceScope(CTraceRecorder *pRecorder, const char *pName) :
+		m_pRecorder(pRecorder), m_pName(pName)
+	{
+		m_pRecorder->Begin(m_pName);
+	}
+
+	~CTraceScope()
+	{
+		m_pRecorder->End(m_pName);
+	}
+
+	CTraceScope(const CTraceScope &Other) = delete;
+	CTraceScope &operator=(const CTraceScope &Other) = delete;
+};
+
+#endif
@@ -308,4 +308,19 @@ int websocket_fd_set(int socket, fd_set *set)
 	return max;
 }
 
+void websocket_fds(int socket, std::vector<int> &fds)
+{
+	lws_context *context = contexts[socket].context;
+	if(context == NULL)
+		return;
+	lws_service(context, -1);
+	context_data *ctx_data = (context_data *)lws_context_user(context);
+	for(auto const &x : ctx_data->port_map)
+	{
+		if(x.second == NULL)
+			continue;
+		fds.push_back(lws_get_socket_fd(x.second->wsi));
+	}
+}
+
 #endif
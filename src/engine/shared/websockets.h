@@ -7,6 +7,7 @@
 #endif
 
 #include <cstddef>
+#include <vector>
 
 int websocket_create(const char *addr, int port);
 int websocket_destroy(int socket);
@@ -14,5 +15,6 @@ int websocket_recv(int socket, unsigned char *data, size_t maxsize, struct socka
 int websocket_send(int socket, const unsigned char *data, size_t size,
 	const char *addr_str, int port);
 int websocket_fd_set(int socket, fd_set *set);
+void websocket_fds(int socket, std::vector<int> &fds);
 
 #endif // ENGINE_SHARED_WEBSOCKETS_H
@@ -359,6 +359,8 @@ public:
 	virtual void TextSelectionColor(ColorRGBA rgb) = 0;
 	virtual void Text(float x, float y, float Size, const char *pText, float LineWidth = -1.0f) = 0;
 	virtual float TextWidth(float Size, const char *pText, int StrLength = -1, float LineWidth = -1.0f, int Flags = 0, const STextSizeProperties &TextSizeProps = {}) = 0;
+	// measures many single line texts at once, e.g. to size a list, returns the largest width
+	virtual float TextWidths(float Size, const char *const *ppTexts, int NumTexts, float *pWidths = nullptr, int Flags = 0) = 0;
 	virtual STextBoundingBox TextBoundingBox(float Size, const char *pText, int StrLength = -1, float LineWidth = -1.0f, float LineSpacing = 0.0f, int Flags = 0) = 0;
 
 	virtual ColorRGBA GetTextColor() const = 0;
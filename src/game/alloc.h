@@ -3,8 +3,12 @@
 #ifndef GAME_ALLOC_H
 #define GAME_ALLOC_H
 
+#include <cstddef>
+#include <memory>
 #include <new>
+#include <vector>
 
+#include <base/math.h>
 #include <base/system.h>
 #ifndef __has_feature
 #define __has_feature(x) 0
@@ -47,6 +51,100 @@ private:
 #define MACRO_ALLOC_GET_SIZE(POOLTYPE) (sizeof(POOLTYPE))
 #endif
 
+/*
+	Class: Slab allocator
+		Hands out fixed-size slots from contiguous chunks, so that objects of
+		one type end up close to each other in memory. Freed slots are reused
+		before a new chunk is allocated. Chunks are never released.
+		Not thread-safe.
+*/
+class CSlabAllocator
+{
+	struct CFreeSlot
+	{
+		CFreeSlot *m_pNext;
+	};
+
+	size_t m_SlotSize;
+	size_t m_SlotsPerChunk;
+	std::vector<std::unique_ptr<char[]>> m_vpChunks;
+	CFreeSlot *m_pFirstFree = nullptr;
+	size_t m_NumUsed = 0;
+
+	void AddChunk()
+	{
+		char *pChunk = new char[m_SlotSize * m_SlotsPerChunk];
+		m_vpChunks.emplace_back(pChunk);
+		// link the slots so that they are handed out in address order
+		for(size_t i = m_SlotsPerChunk; i-- > 0;)
+		{
+			CFreeSlot *pSlot = (CFreeSlot *)(pChunk + i * m_SlotSize);
+			pSlot->m_pNext = m_pFirstFree;
+			m_pFirstFree = pSlot;
+		}
+		ASAN_POISON_MEMORY_REGION(pChunk, m_SlotSize * m_SlotsPerChunk);
+	}
+
+public:
+	CSlabAllocator(size_t ObjectSize, size_t SlotsPerChunk) :
+		m_SlotSize((maximum(ObjectSize, sizeof(CFreeSlot)) + alignof(std::max_align_t) - 1) & ~(alignof(std::max_align_t) - 1)),
+		m_SlotsPerChunk(SlotsPerChunk)
+	{
+	}
+
+	void *Allocate(size_t Size)
+	{
+		dbg_assert(Size <= m_SlotSize, "size error");
+		if(!m_pFirstFree)
+			AddChunk();
+		CFreeSlot *pSlot = m_pFirstFree;
+		ASAN_UNPOISON_MEMORY_REGION(pSlot, m_SlotSize);
+		m_pFirstFree = pSlot->m_pNext;
+		m_NumUsed++;
+		mem_zero(pSlot, m_SlotSize);
+		return pSlot;
+	}
+
+	void Free(void *pPtr)
+	{
+		if(!pPtr)
+			return;
+		dbg_assert(m_NumUsed > 0, "not used");
+		CFreeSlot *pSlot = (CFreeSlot *)pPtr;
+		pSlot->m_pNext = m_pFirstFree;
+		m_pFirstFree = pSlot;
+		m_NumUsed--;
+		ASAN_POISON_MEMORY_REGION((char *)pSlot + sizeof(CFreeSlot), m_SlotSize - sizeof(CFreeSlot));
+	}
+
+	size_t NumUsed() const { return m_NumUsed; }
+	size_t NumChunks() const { return m_vpChunks.size(); }
+	size_t SlotSize() const { return m_SlotSize; }
+};
+
+#define MACRO_ALLOC_POOL_SLAB() \
+public: \
+	void *operator new(size_t Size); \
+	void operator delete(void *pPtr); \
+	static CSlabAllocator &SlabAllocator(); \
+\
+private:
+
+#define MACRO_ALLOC_POOL_SLAB_IMPL(POOLTYPE, ChunkSize) \
+	CSlabAllocator &POOLTYPE::SlabAllocator() \
+	{ \
+		static CSlabAllocator s_Allocator(sizeof(POOLTYPE), ChunkSize); \
+		return s_Allocator; \
+	} \
+	void *POOLTYPE::operator new(size_t Size) \
+	{ \
+		return SlabAllocator().Allocate(Size); \
+	} \
+	void POOLTYPE::operator delete(void *pPtr) \
+	{ \
+		SlabAllocator().Free(pPtr); \
+	}
+
 #define MACRO_ALLOC_POOL_ID_IMPL(POOLTYPE, PoolSize) \
 	static char gs_PoolData##POOLTYPE[PoolSize][MACRO_ALLOC_GET_SIZE(POOLTYPE)] = {{0}}; \
 	static int gs_PoolUsed##POOLTYPE[PoolSize] = {0}; \
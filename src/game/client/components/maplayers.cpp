@@ -1,6 +1,7 @@
 /* (c) Magnus Auvinen. See licence.txt in the root of the distribution for more information. */
 /* If you are missing that file, acquire a complete release at teeworlds.com.                */
 #include <engine/demo.h>
+#include <engine/engine.h>
 #include <engine/graphics.h>
 #include <engine/keys.h>
 #include <engine/serverbrowser.h>
@@ -328,6 +329,337 @@ CMapLayers::~CMapLayers()
 	}
 }
 
+CMapLayers::CTileLayerJob::CTileLayerJob(std::shared_ptr<std::vector<unsigned char>> pTiles, int Width, int Height, int CurOverlay, bool DoTextureCoords) :
+	m_pTiles(std::move(pTiles)),
+	m_Width(Width),
+	m_Height(Height),
+	m_CurOverlay(CurOverlay),
+	m_DoTextureCoords(DoTextureCoords)
+{
+}
+
+CMapLayers::CTileLayerJob::~CTileLayerJob()
+{
+	free(m_pUploadData);
+}
+
+void CMapLayers::CTileLayerJob::Run()
+{
+	m_pVisuals = std::make_unique<STileLayerVisuals>();
+	STileLayerVisuals &Visuals = *m_pVisuals;
+	if(!Visuals.Init(m_Width, m_Height))
+		return;
+	Visuals.m_IsTextured = m_DoTextureCoords;
+
+	void *pTiles = m_pTiles->data();
+	std::vector<SGraphicTile> vtmpTiles;
+	std::vector<SGraphicTileTexureCoords> vtmpTileTexCoords;
+	std::vector<SGraphicTile> vtmpBorderTopTiles;
+	std::vector<SGraphicTileTexureCoords> vtmpBorderTopTilesTexCoords;
+	std::vector<SGraphicTile> vtmpBorderLeftTiles;
+	std::vector<SGraphicTileTexureCoords> vtmpBorderLeftTilesTexCoords;
+	std::vector<SGraphicTile> vtmpBorderRightTiles;
+	std::vector<SGraphicTileTexureCoords> vtmpBorderRightTilesTexCoords;
+	std::vector<SGraphicTile> vtmpBorderBottomTiles;
+	std::vector<SGraphicTileTexureCoords> vtmpBorderBottomTilesTexCoords;
+	std::vector<SGraphicTile> vtmpBorderCorners;
+	std::vector<SGraphicTileTexureCoords> vtmpBorderCornersTexCoords;
+
+	if(!m_DoTextureCoords)
+	{
+		vtmpTiles.reserve((size_t)m_Width * m_Height);
+		vtmpBorderTopTiles.reserve((size_t)m_Width);
+		vtmpBorderBottomTiles.reserve((size_t)m_Width);
+		vtmpBorderLeftTiles.reserve((size_t)m_Height);
+		vtmpBorderRightTiles.reserve((size_t)m_Height);
+		vtmpBorderCorners.reserve((size_t)4);
+	}
+	else
+	{
+		vtmpTileTexCoords.reserve((size_t)m_Width * m_Height);
+		vtmpBorderTopTilesTexCoords.reserve((size_t)m_Width);
+		vtmpBorderBottomTilesTexCoords.reserve((size_t)m_Width);
+		vtmpBorderLeftTilesTexCoords.reserve((size_t)m_Height);
+		vtmpBorderRightTilesTexCoords.reserve((size_t)m_Height);
+		vtmpBorderCornersTexCoords.reserve((size_t)4);
+	}
+
+	int x = 0;
+	int y = 0;
+	for(y = 0; y < m_Height; ++y)
+	{
+		for(x = 0; x < m_Width; ++x)
+		{
+			unsigned char Index = 0;
+			unsigned char Flags = 0;
+			int AngleRotate = -1;
+			if(m_IsEntityLayer)
+			{
+				if(m_IsGameLayer)
+				{
+					Index = ((CTile *)pTiles)[y * m_Width + x].m_Index;
+					Flags = ((CTile *)pTiles)[y * m_Width + x].m_Flags;
+				}
+				if(m_IsFrontLayer)
+				{
+					Index = ((CTile *)pTiles)[y * m_Width + x].m_Index;
+					Flags = ((CTile *)pTiles)[y * m_Width + x].m_Flags;
+				}
+				if(m_IsSwitchLayer)
+				{
+					Flags = 0;
+					Index = ((CSwitchTile *)pTiles)[y * m_Width + x].m_Type;
+					if(m_CurOverlay == 0)
+					{
+						Flags = ((CSwitchTile *)pTiles)[y * m_Width + x].m_Flags;
+						if(Index == TILE_SWITCHTIMEDOPEN)
+							Index = 8;
+					}
+					else if(m_CurOverlay == 1)
+						Index = ((CSwitchTile *)pTiles)[y * m_Width + x].m_Number;
+					else if(m_CurOverlay == 2)
+						Index = ((CSwitchTile *)pTiles)[y * m_Width + x].m_Delay;
+				}
+				if(m_IsTeleLayer)
+				{
+					Index = ((CTeleTile *)pTiles)[y * m_Width + x].m_Type;
+					Flags = 0;
+					if(m_CurOverlay == 1)
+					{
+						if(IsTeleTileNumberUsedAny(Index))
+							Index = ((CTeleTile *)pTiles)[y * m_Width + x].m_Number;
+						else
+							Index = 0;
+					}
+				}
+				if(m_IsSpeedupLayer)
+				{
+					Index = ((CSpeedupTile *)pTiles)[y * m_Width + x].m_Type;
+					Flags = 0;
+					AngleRotate = ((CSpeedupTile *)pTiles)[y * m_Width + x].m_Angle;
+					if(((CSpeedupTile *)pTiles)[y * m_Width + x].m_Force == 0)
+						Index = 0;
+					else if(m_CurOverlay == 1)
+						Index = ((CSpeedupTile *)pTiles)[y * m_Width + x].m_Force;
+					else if(m_CurOverlay == 2)
+						Index = ((CSpeedupTile *)pTiles)[y * m_Width + x].m_MaxSpeed;
+				}
+				if(m_IsTuneLayer)
+				{
+					Index = ((CTuneTile *)pTiles)[y * m_Width + x].m_Type;
+					Flags = 0;
+				}
+			}
+			else
+			{
+				Index = ((CTile *)pTiles)[y * m_Width + x].m_Index;
+				Flags = ((CTile *)pTiles)[y * m_Width + x].m_Flags;
+			}
+
+			//the amount of tiles handled before this tile
+			int TilesHandledCount = vtmpTiles.size();
+			Visuals.m_pTilesOfLayer[y * m_Width + x].SetIndexBufferByteOffset((offset_ptr32)(TilesHandledCount));
+
+			bool AddAsSpeedup = false;
+			if(m_IsSpeedupLayer && m_CurOverlay == 0)
+				AddAsSpeedup = true;
+
+			if(AddTile(vtmpTiles, vtmpTileTexCoords, Index, Flags, x, y, nullptr, m_DoTextureCoords, AddAsSpeedup, AngleRotate))
+				Visuals.m_pTilesOfLayer[y * m_Width + x].Draw(true);
+
+			//do the border tiles
+			if(x == 0)
+			{
+				if(y == 0)
+				{
+					Visuals.m_BorderTopLeft.SetIndexBufferByteOffset((offset_ptr32)(vtmpBorderCorners.size()));
+					if(AddTile(vtmpBorderCorners, vtmpBorderCornersTexCoords, Index, Flags, 0, 0, nullptr, m_DoTextureCoords, AddAsSpeedup, AngleRotate, ivec2{-32, -32}))
+						Visuals.m_BorderTopLeft.Draw(true);
+				}
+				else if(y == m_Height - 1)
+				{
+					Visuals.m_BorderBottomLeft.SetIndexBufferByteOffset((offset_ptr32)(vtmpBorderCorners.size()));
+					if(AddTile(vtmpBorderCorners, vtmpBorderCornersTexCoords, Index, Flags, 0, 0, nullptr, m_DoTextureCoords, AddAsSpeedup, AngleRotate, ivec2{-32, 0}))
+						Visuals.m_BorderBottomLeft.Draw(true);
+				}
+				Visuals.m_vBorderLeft[y].SetIndexBufferByteOffset((offset_ptr32)(vtmpBorderLeftTiles.size()));
+				if(AddTile(vtmpBorderLeftTiles, vtmpBorderLeftTilesTexCoords, Index, Flags, 0, y, nullptr, m_DoTextureCoords, AddAsSpeedup, AngleRotate, ivec2{-32, 0}))
+					Visuals.m_vBorderLeft[y].Draw(true);
+			}
+			else if(x == m_Width - 1)
+			{
+				if(y == 0)
+				{
+					Visuals.m_BorderTopRight.SetIndexBufferByteOffset((offset_ptr32)(vtmpBorderCorners.size()));
+					if(AddTile(vtmpBorderCorners, vtmpBorderCornersTexCoords, Index, Flags, 0, 0, nullptr, m_DoTextureCoords, AddAsSpeedup, AngleRotate, ivec2{0, -32}))
+						Visuals.m_BorderTopRight.Draw(true);
+				}
+				else if(y == m_Height - 1)
+				{
+					Visuals.m_BorderBottomRight.SetIndexBufferByteOffset((offset_ptr32)(vtmpBorderCorners.size()));
+					if(AddTile(vtmpBorderCorners, vtmpBorderCornersTexCoords, Index, Flags, 0, 0, nullptr, m_DoTextureCoords, AddAsSpeedup, AngleRotate, ivec2{0, 0}))
+						Visuals.m_BorderBottomRight.Draw(true);
+				}
+				Visuals.m_vBorderRight[y].SetIndexBufferByteOffset((offset_ptr32)(vtmpBorderRightTiles.size()));
+				if(AddTile(vtmpBorderRightTiles, vtmpBorderRightTilesTexCoords, Index, Flags, 0, y, nullptr, m_DoTextureCoords, AddAsSpeedup, AngleRotate, ivec2{0, 0}))
+					Visuals.m_vBorderRight[y].Draw(true);
+			}
+			if(y == 0)
+			{
+				Visuals.m_vBorderTop[x].SetIndexBufferByteOffset((offset_ptr32)(vtmpBorderTopTiles.size()));
+				if(AddTile(vtmpBorderTopTiles, vtmpBorderTopTilesTexCoords, Index, Flags, x, 0, nullptr, m_DoTextureCoords, AddAsSpeedup, AngleRotate, ivec2{0, -32}))
+					Visuals.m_vBorderTop[x].Draw(true);
+			}
+			else if(y == m_Height - 1)
+			{
+				Visuals.m_vBorderBottom[x].SetIndexBufferByteOffset((offset_ptr32)(vtmpBorderBottomTiles.size()));
+				if(AddTile(vtmpBorderBottomTiles, vtmpBorderBottomTilesTexCoords, Index, Flags, x, 0, nullptr, m_DoTextureCoords, AddAsSpeedup, AngleRotate, ivec2{0, 0}))
+					Visuals.m_vBorderBottom[x].Draw(true);
+			}
+		}
+	}
+
+	//append one kill tile to the gamelayer
+	if(m_IsGameLayer)
+	{
+		Visuals.m_BorderKillTile.SetIndexBufferByteOffset((offset_ptr32)(vtmpTiles.size()));
+		if(AddTile(vtmpTiles, vtmpTileTexCoords, TILE_DEATH, 0, 0, 0, nullptr, m_DoTextureCoords))
+			Visuals.m_BorderKillTile.Draw(true);
+	}
+
+	//add the border corners, then the borders and fix their byte offsets
+	int TilesHandledCount = vtmpTiles.size();
+	Visuals.m_BorderTopLeft.AddIndexBufferByteOffset(TilesHandledCount);
+	Visuals.m_BorderTopRight.AddIndexBufferByteOffset(TilesHandledCount);
+	Visuals.m_BorderBottomLeft.AddIndexBufferByteOffset(TilesHandledCount);
+	Visuals.m_BorderBottomRight.AddIndexBufferByteOffset(TilesHandledCount);
+	//add the Corners to the tiles
+	vtmpTiles.insert(vtmpTiles.end(), vtmpBorderCorners.begin(), vtmpBorderCorners.end());
+	vtmpTileTexCoords.insert(vtmpTileTexCoords.end(), vtmpBorderCornersTexCoords.begin(), vtmpBorderCornersTexCoords.end());
+
+	//now the borders
+	TilesHandledCount = vtmpTiles.size();
+	if(m_Width > 0)
+	{
+		for(int i = 0; i < m_Width; ++i)
+		{
+			Visuals.m_vBorderTop[i].AddIndexBufferByteOffset(TilesHandledCount);
+		}
+	}
+	vtmpTiles.insert(vtmpTiles.end(), vtmpBorderTopTiles.begin(), vtmpBorderTopTiles.end());
+	vtmpTileTexCoords.insert(vtmpTileTexCoords.end(), vtmpBorderTopTilesTexCoords.begin(), vtmpBorderTopTilesTexCoords.end());
+
+	TilesHandledCount = vtmpTiles.size();
+	if(m_Width > 0)
+	{
+		for(int i = 0; i < m_Width; ++i)
+		{
+			Visuals.m_vBorderBottom[i].AddIndexBufferByteOffset(TilesHandledCount);
+		}
+	}
+	vtmpTiles.insert(vtmpTiles.end(), vtmpBorderBottomTiles.begin(), vtmpBorderBottomTiles.end());
+	vtmpTileTexCoords.insert(vtmpTileTexCoords.end(), vtmpBorderBottomTilesTexCoords.begin(), vtmpBorderBottomTilesTexCoords.end());
+
+	TilesHandledCount = vtmpTiles.size();
+	if(m_Height > 0)
+	{
+		for(int i = 0; i < m_Height; ++i)
+		{
+			Visuals.m_vBorderLeft[i].AddIndexBufferByteOffset(TilesHandledCount);
+		}
+	}
+	vtmpTiles.insert(vtmpTiles.end(), vtmpBorderLeftTiles.begin(), vtmpBorderLeftTiles.end());
+	vtmpTileTexCoords.insert(vtmpTileTexCoords.end(), vtmpBorderLeftTilesTexCoords.begin(), vtmpBorderLeftTilesTexCoords.end());
+
+	TilesHandledCount = vtmpTiles.size();
+	if(m_Height > 0)
+	{
+		for(int i = 0; i < m_Height; ++i)
+		{
+			Visuals.m_vBorderRight[i].AddIndexBufferByteOffset(TilesHandledCount);
+		}
+	}
+	vtmpTiles.insert(vtmpTiles.end(), vtmpBorderRightTiles.begin(), vtmpBorderRightTiles.end());
+	vtmpTileTexCoords.insert(vtmpTileTexCoords.end(), vtmpBorderRightTilesTexCoords.begin(), vtmpBorderRightTilesTexCoords.end());
+
+	//setup params
+	float *pTmpTiles = vtmpTiles.empty() ? NULL : (float *)vtmpTiles.data();
+	unsigned char *pTmpTileTexCoords = vtmpTileTexCoords.empty() ? NULL : (unsigned char *)vtmpTileTexCoords.data();
+
+	m_NumTiles = vtmpTiles.size();
+	m_UploadDataSize = vtmpTileTexCoords.size() * sizeof(SGraphicTileTexureCoords) + vtmpTiles.size() * sizeof(SGraphicTile);
+	if(m_UploadDataSize > 0)
+	{
+		m_pUploadData = (char *)malloc(sizeof(char) * m_UploadDataSize);
+
+		mem_copy_special(m_pUploadData, pTmpTiles, sizeof(vec2), vtmpTiles.size() * 4, (m_DoTextureCoords ? sizeof(ubvec4) : 0));
+		if(m_DoTextureCoords)
+		{
+			mem_copy_special(m_pUploadData + sizeof(vec2), pTmpTileTexCoords, sizeof(ubvec4), vtmpTiles.size() * 4, sizeof(vec2));
+		}
+	}
+}
+
+void CMapLayers::UploadFinishedTileLayers()
+{
+	for(auto It = m_vPendingTileLayers.begin(); It != m_vPendingTileLayers.end();)
+	{
+		CTileLayerJob &Job = *It->second;
+		if(!Job.Done())
+		{
+			++It;
+			continue;
+		}
+
+		delete m_vpTileLayerVisuals[It->first];
+		m_vpTileLayerVisuals[It->first] = Job.m_pVisuals.release();
+		STileLayerVisuals &Visuals = *m_vpTileLayerVisuals[It->first];
+		if(Job.m_pUploadData)
+		{
+			// first create the buffer object, it takes ownership of the data
+			int BufferObjectIndex = Graphics()->CreateBufferObject(Job.m_UploadDataSize, Job.m_pUploadData, 0, true);
+			Job.m_pUploadData = nullptr;
+
+			// then create the buffer container
+			SBufferContainerInfo ContainerInfo;
+			ContainerInfo.m_Stride = (Job.m_DoTextureCoords ? (sizeof(float) * 2 + sizeof(ubvec4)) : 0);
+			ContainerInfo.m_VertBufferBindingIndex = BufferObjectIndex;
+			ContainerInfo.m_vAttributes.emplace_back();
+			SBufferContainerInfo::SAttribute *pAttr = &ContainerInfo.m_vAttributes.back();
+			pAttr->m_DataTypeCount = 2;
+			pAttr->m_Type = GRAPHICS_TYPE_FLOAT;
+			pAttr->m_Normalized = false;
+			pAttr->m_pOffset = 0;
+			pAttr->m_FuncType = 0;
+			if(Job.m_DoTextureCoords)
+			{
+				ContainerInfo.m_vAttributes.emplace_back();
+				pAttr = &ContainerInfo.m_vAttributes.back();
+				pAttr->m_DataTypeCount = 4;
+				pAttr->m_Type = GRAPHICS_TYPE_UNSIGNED_BYTE;
+				pAttr->m_Normalized = false;
+				pAttr->m_pOffset = (void *)(sizeof(vec2));
+				pAttr->m_FuncType = 1;
+			}
+
+			Visuals.m_BufferContainerIndex = Graphics()->CreateBufferContainer(&ContainerInfo);
+			// and finally inform the backend how many indices are required
+			Graphics()->IndicesNumRequiredNotify(Job.m_NumTiles * 6);
+		}
+		It = m_vPendingTileLayers.erase(It);
+	}
+}
+
+void CMapLayers::FinishTileLayers()
+{
+	UploadFinishedTileLayers();
+	while(TileLayersPending())
+	{
+		thread_yield();
+		UploadFinishedTileLayers();
+	}
+}
+
 void CMapLayers::OnMapLoad()
 {
 	if(!Graphics()->IsTileBufferingEnabled() && !Graphics()->IsQuadBufferingEnabled())
@@ -355,6 +687,7 @@ void CMapLayers::OnMapLoad()
 		}
 		m_vpTileLayerVisuals.clear();
 	}
+	m_vPendingTileLayers.clear();
 	if(!m_vpQuadLayerVisuals.empty())
 	{
 		int s = m_vpQuadLayerVisuals.size();
@@ -369,20 +702,7 @@ void CMapLayers::OnMapLoad()
 	}
 
 	bool PassedGameLayer = false;
-	//prepare all visuals for all tile layers
-	std::vector<SGraphicTile> vtmpTiles;
-	std::vector<SGraphicTileTexureCoords> vtmpTileTexCoords;
-	std::vector<SGraphicTile> vtmpBorderTopTiles;
-	std::vector<SGraphicTileTexureCoords> vtmpBorderTopTilesTexCoords;
-	std::vector<SGraphicTile> vtmpBorderLeftTiles;
-	std::vector<SGraphicTileTexureCoords> vtmpBorderLeftTilesTexCoords;
-	std::vector<SGraphicTile> vtmpBorderRightTiles;
-	std::vector<SGraphicTileTexureCoords> vtmpBorderRightTilesTexCoords;
-	std::vector<SGraphicTile> vtmpBorderBottomTiles;
-	std::vector<SGraphicTileTexureCoords> vtmpBorderBottomTilesTexCoords;
-	std::vector<SGraphicTile> vtmpBorderCorners;
-	std::vector<SGraphicTileTexureCoords> vtmpBorderCornersTexCoords;
-
+	//prepare all visuals for all tile layers, the vertices are generated on the job pool
 	std::vector<STmpQuad> vtmpQuads;
 	std::vector<STmpQuadTextured> vtmpQuadsTextured;
 
@@ -494,299 +814,23 @@ void CMapLayers::OnMapLoad()
 
 				if(Size >= pTMap->m_Width * pTMap->m_Height * TileSize)
 				{
-					int CurOverlay = 0;
-					while(CurOverlay < OverlayCount + 1)
+					// the map data may be unloaded before the jobs are done
+					auto pTileData = std::make_shared<std::vector<unsigned char>>((unsigned char *)pTiles, (unsigned char *)pTiles + Size);
+					for(int CurOverlay = 0; CurOverlay < OverlayCount + 1; ++CurOverlay)
 					{
-						// We can later just count the tile layers to get the idx in the vector
+						// We can later just count the tile layers to get the idx in the vector,
+						// the placeholder is not rendered until the job has finished
 						m_vpTileLayerVisuals.push_back(new STileLayerVisuals());
-						STileLayerVisuals &Visuals = *m_vpTileLayerVisuals.back();
-						if(!Visuals.Init(pTMap->m_Width, pTMap->m_Height))
-						{
-							++CurOverlay;
-							continue;
-						}
-						Visuals.m_IsTextured = DoTextureCoords;
-
-						vtmpTiles.clear();
-						vtmpTileTexCoords.clear();
-
-						vtmpBorderTopTiles.clear();
-						vtmpBorderLeftTiles.clear();
-						vtmpBorderRightTiles.clear();
-						vtmpBorderBottomTiles.clear();
-						vtmpBorderCorners.clear();
-						vtmpBorderTopTilesTexCoords.clear();
-						vtmpBorderLeftTilesTexCoords.clear();
-						vtmpBorderRightTilesTexCoords.clear();
-						vtmpBorderBottomTilesTexCoords.clear();
-						vtmpBorderCornersTexCoords.clear();
-
-						if(!DoTextureCoords)
-						{
-							vtmpTiles.reserve((size_t)pTMap->m_Width * pTMap->m_Height);
-							vtmpBorderTopTiles.reserve((size_t)pTMap->m_Width);
-							vtmpBorderBottomTiles.reserve((size_t)pTMap->m_Width);
-							vtmpBorderLeftTiles.reserve((size_t)pTMap->m_Height);
-							vtmpBorderRightTiles.reserve((size_t)pTMap->m_Height);
-							vtmpBorderCorners.reserve((size_t)4);
-						}
-						else
-						{
-							vtmpTileTexCoords.reserve((size_t)pTMap->m_Width * pTMap->m_Height);
-							vtmpBorderTopTilesTexCoords.reserve((size_t)pTMap->m_Width);
-							vtmpBorderBottomTilesTexCoords.reserve((size_t)pTMap->m_Width);
-							vtmpBorderLeftTilesTexCoords.reserve((size_t)pTMap->m_Height);
-							vtmpBorderRightTilesTexCoords.reserve((size_t)pTMap->m_Height);
-							vtmpBorderCornersTexCoords.reserve((size_t)4);
-						}
-
-						int x = 0;
-						int y = 0;
-						for(y = 0; y < pTMap->m_Height; ++y)
-						{
-							for(x = 0; x < pTMap->m_Width; ++x)
-							{
-								unsigned char Index = 0;
-								unsigned char Flags = 0;
-								int AngleRotate = -1;
-								if(IsEntityLayer)
-								{
-									if(IsGameLayer)
-									{
-										Index = ((CTile *)pTiles)[y * pTMap->m_Width + x].m_Index;
-										Flags = ((CTile *)pTiles)[y * pTMap->m_Width + x].m_Flags;
-									}
-									if(IsFrontLayer)
-									{
-										Index = ((CTile *)pTiles)[y * pTMap->m_Width + x].m_Index;
-										Flags = ((CTile *)pTiles)[y * pTMap->m_Width + x].m_Flags;
-									}
-									if(IsSwitchLayer)
-									{
-										Flags = 0;
-										Index = ((CSwitchTile *)pTiles)[y * pTMap->m_Width + x].m_Type;
-										if(CurOverlay == 0)
-										{
-											Flags = ((CSwitchTile *)pTiles)[y * pTMap->m_Width + x].m_Flags;
-											if(Index == TILE_SWITCHTIMEDOPEN)
-												Index = 8;
-										}
-										else if(CurOverlay == 1)
-											Index = ((CSwitchTile *)pTiles)[y * pTMap->m_Width + x].m_Number;
-										else if(CurOverlay == 2)
-											Index = ((CSwitchTile *)pTiles)[y * pTMap->m_Width + x].m_Delay;
-									}
-									if(IsTeleLayer)
-									{
-										Index = ((CTeleTile *)pTiles)[y * pTMap->m_Width + x].m_Type;
-										Flags = 0;
-										if(CurOverlay == 1)
-										{
-											if(IsTeleTileNumberUsedAny(Index))
-												Index = ((CTeleTile *)pTiles)[y * pTMap->m_Width + x].m_Number;
-											else
-												Index = 0;
-										}
-									}
-									if(IsSpeedupLayer)
-									{
-										Index = ((CSpeedupTile *)pTiles)[y * pTMap->m_Width + x].m_Type;
-										Flags = 0;
-										AngleRotate = ((CSpeedupTile *)pTiles)[y * pTMap->m_Width + x].m_Angle;
-										if(((CSpeedupTile *)pTiles)[y * pTMap->m_Width + x].m_Force == 0)
-											Index = 0;
-										else if(CurOverlay == 1)
-											Index = ((CSpeedupTile *)pTiles)[y * pTMap->m_Width + x].m_Force;
-										else if(CurOverlay == 2)
-											Index = ((CSpeedupTile *)pTiles)[y * pTMap->m_Width + x].m_MaxSpeed;
-									}
-									if(IsTuneLayer)
-									{
-										Index = ((CTuneTile *)pTiles)[y * pTMap->m_Width + x].m_Type;
-										Flags = 0;
-									}
-								}
-								else
-								{
-									Index = ((CTile *)pTiles)[y * pTMap->m_Width + x].m_Index;
-									Flags = ((CTile *)pTiles)[y * pTMap->m_Width + x].m_Flags;
-								}
-
-								//the amount of tiles handled before this tile
-								int TilesHandledCount = vtmpTiles.size();
-								Visuals.m_pTilesOfLayer[y * pTMap->m_Width + x].SetIndexBufferByteOffset((offset_ptr32)(TilesHandledCount));
-
-								bool AddAsSpeedup = false;
-								if(IsSpeedupLayer && CurOverlay == 0)
-									AddAsSpeedup = true;
-
-								if(AddTile(vtmpTiles, vtmpTileTexCoords, Index, Flags, x, y, pGroup, DoTextureCoords, AddAsSpeedup, AngleRotate))
-									Visuals.m_pTilesOfLayer[y * pTMap->m_Width + x].Draw(true);
-
-								//do the border tiles
-								if(x == 0)
-								{
-									if(y == 0)
-									{
-										Visuals.m_BorderTopLeft.SetIndexBufferByteOffset((offset_ptr32)(vtmpBorderCorners.size()));
-										if(AddTile(vtmpBorderCorners, vtmpBorderCornersTexCoords, Index, Flags, 0, 0, pGroup, DoTextureCoords, AddAsSpeedup, AngleRotate, ivec2{-32, -32}))
-											Visuals.m_BorderTopLeft.Draw(true);
-									}
-									else if(y == pTMap->m_Height - 1)
-									{
-										Visuals.m_BorderBottomLeft.SetIndexBufferByteOffset((offset_ptr32)(vtmpBorderCorners.size()));
-										if(AddTile(vtmpBorderCorners, vtmpBorderCornersTexCoords, Index, Flags, 0, 0, pGroup, DoTextureCoords, AddAsSpeedup, AngleRotate, ivec2{-32, 0}))
-											Visuals.m_BorderBottomLeft.Draw(true);
-									}
-									Visuals.m_vBorderLeft[y].SetIndexBufferByteOffset((offset_ptr32)(vtmpBorderLeftTiles.size()));
-									if(AddTile(vtmpBorderLeftTiles, vtmpBorderLeftTilesTexCoords, Index, Flags, 0, y, pGroup, DoTextureCoords, AddAsSpeedup, AngleRotate, ivec2{-32, 0}))
-										Visuals.m_vBorderLeft[y].Draw(true);
-								}
-								else if(x == pTMap->m_Width - 1)
-								{
-									if(y == 0)
-									{
-										Visuals.m_BorderTopRight.SetIndexBufferByteOffset((offset_ptr32)(vtmpBorderCorners.size()));
-										if(AddTile(vtmpBorderCorners, vtmpBorderCornersTexCoords, Index, Flags, 0, 0, pGroup, DoTextureCoords, AddAsSpeedup, AngleRotate, ivec2{0, -32}))
-											Visuals.m_BorderTopRight.Draw(true);
-									}
-									else if(y == pTMap->m_Height - 1)
-									{
-										Visuals.m_BorderBottomRight.SetIndexBufferByteOffset((offset_ptr32)(vtmpBorderCorners.size()));
-										if(AddTile(vtmpBorderCorners, vtmpBorderCornersTexCoords, Index, Flags, 0, 0, pGroup, DoTextureCoords, AddAsSpeedup, AngleRotate, ivec2{0, 0}))
-											Visuals.m_BorderBottomRight.Draw(true);
-									}
-									Visuals.m_vBorderRight[y].SetIndexBufferByteOffset((offset_ptr32)(vtmpBorderRightTiles.size()));
-									if(AddTile(vtmpBorderRightTiles, vtmpBorderRightTilesTexCoords, Index, Flags, 0, y, pGroup, DoTextureCoords, AddAsSpeedup, AngleRotate, ivec2{0, 0}))
-										Visuals.m_vBorderRight[y].Draw(true);
-								}
-								if(y == 0)
-								{
-									Visuals.m_vBorderTop[x].SetIndexBufferByteOffset((offset_ptr32)(vtmpBorderTopTiles.size()));
-									if(AddTile(vtmpBorderTopTiles, vtmpBorderTopTilesTexCoords, Index, Flags, x, 0, pGroup, DoTextureCoords, AddAsSpeedup, AngleRotate, ivec2{0, -32}))
-										Visuals.m_vBorderTop[x].Draw(true);
-								}
-								else if(y == pTMap->m_Height - 1)
-								{
-									Visuals.m_vBorderBottom[x].SetIndexBufferByteOffset((offset_ptr32)(vtmpBorderBottomTiles.size()));
-									if(AddTile(vtmpBorderBottomTiles, vtmpBorderBottomTilesTexCoords, Index, Flags, x, 0, pGroup, DoTextureCoords, AddAsSpeedup, AngleRotate, ivec2{0, 0}))
-										Visuals.m_vBorderBottom[x].Draw(true);
-								}
-							}
-						}
-
-						//append one kill tile to the gamelayer
-						if(IsGameLayer)
-						{
-							Visuals.m_BorderKillTile.SetIndexBufferByteOffset((offset_ptr32)(vtmpTiles.size()));
-							if(AddTile(vtmpTiles, vtmpTileTexCoords, TILE_DEATH, 0, 0, 0, pGroup, DoTextureCoords))
-								Visuals.m_BorderKillTile.Draw(true);
-						}
-
-						//add the border corners, then the borders and fix their byte offsets
-						int TilesHandledCount = vtmpTiles.size();
-						Visuals.m_BorderTopLeft.AddIndexBufferByteOffset(TilesHandledCount);
-						Visuals.m_BorderTopRight.AddIndexBufferByteOffset(TilesHandledCount);
-						Visuals.m_BorderBottomLeft.AddIndexBufferByteOffset(TilesHandledCount);
-						Visuals.m_BorderBottomRight.AddIndexBufferByteOffset(TilesHandledCount);
-						//add the Corners to the tiles
-						vtmpTiles.insert(vtmpTiles.end(), vtmpBorderCorners.begin(), vtmpBorderCorners.end());
-						vtmpTileTexCoords.insert(vtmpTileTexCoords.end(), vtmpBorderCornersTexCoords.begin(), vtmpBorderCornersTexCoords.end());
-
-						//now the borders
-						TilesHandledCount = vtmpTiles.size();
-						if(pTMap->m_Width > 0)
-						{
-							for(int i = 0; i < pTMap->m_Width; ++i)
-							{
-								Visuals.m_vBorderTop[i].AddIndexBufferByteOffset(TilesHandledCount);
-							}
-						}
-						vtmpTiles.insert(vtmpTiles.end(), vtmpBorderTopTiles.begin(), vtmpBorderTopTiles.end());
-						vtmpTileTexCoords.insert(vtmpTileTexCoords.end(), vtmpBorderTopTilesTexCoords.begin(), vtmpBorderTopTilesTexCoords.end());
-
-						TilesHandledCount = vtmpTiles.size();
-						if(pTMap->m_Width > 0)
-						{
-							for(int i = 0; i < pTMap->m_Width; ++i)
-							{
-								Visuals.m_vBorderBottom[i].AddIndexBufferByteOffset(TilesHandledCount);
-							}
-						}
-						vtmpTiles.insert(vtmpTiles.end(), vtmpBorderBottomTiles.begin(), vtmpBorderBottomTiles.end());
-						vtmpTileTexCoords.insert(vtmpTileTexCoords.end(), vtmpBorderBottomTilesTexCoords.begin(), vtmpBorderBottomTilesTexCoords.end());
-
-						TilesHandledCount = vtmpTiles.size();
-						if(pTMap->m_Height > 0)
-						{
-							for(int i = 0; i < pTMap->m_Height; ++i)
-							{
-								Visuals.m_vBorderLeft[i].AddIndexBufferByteOffset(TilesHandledCount);
-							}
-						}
-						vtmpTiles.insert(vtmpTiles.end(), vtmpBorderLeftTiles.begin(), vtmpBorderLeftTiles.end());
-						vtmpTileTexCoords.insert(vtmpTileTexCoords.end(), vtmpBorderLeftTilesTexCoords.begin(), vtmpBorderLeftTilesTexCoords.end());
-
-						TilesHandledCount = vtmpTiles.size();
-						if(pTMap->m_Height > 0)
-						{
-							for(int i = 0; i < pTMap->m_Height; ++i)
-							{
-								Visuals.m_vBorderRight[i].AddIndexBufferByteOffset(TilesHandledCount);
-							}
-						}
-						vtmpTiles.insert(vtmpTiles.end(), vtmpBorderRightTiles.begin(), vtmpBorderRightTiles.end());
-						vtmpTileTexCoords.insert(vtmpTileTexCoords.end(), vtmpBorderRightTilesTexCoords.begin(), vtmpBorderRightTilesTexCoords.end());
-
-						//setup params
-						float *pTmpTiles = vtmpTiles.empty() ? NULL : (float *)vtmpTiles.data();
-						unsigned char *pTmpTileTexCoords = vtmpTileTexCoords.empty() ? NULL : (unsigned char *)vtmpTileTexCoords.data();
-
-						Visuals.m_BufferContainerIndex = -1;
-						size_t UploadDataSize = vtmpTileTexCoords.size() * sizeof(SGraphicTileTexureCoords) + vtmpTiles.size() * sizeof(SGraphicTile);
-						if(UploadDataSize > 0)
-						{
-							char *pUploadData = (char *)malloc(sizeof(char) * UploadDataSize);
-
-							mem_copy_special(pUploadData, pTmpTiles, sizeof(vec2), vtmpTiles.size() * 4, (DoTextureCoords ? sizeof(ubvec4) : 0));
-							if(DoTextureCoords)
-							{
-								mem_copy_special(pUploadData + sizeof(vec2), pTmpTileTexCoords, sizeof(ubvec4), vtmpTiles.size() * 4, sizeof(vec2));
-							}
-
-							// first create the buffer object
-							int BufferObjectIndex = Graphics()->CreateBufferObject(UploadDataSize, pUploadData, 0, true);
-
-							// then create the buffer container
-							SBufferContainerInfo ContainerInfo;
-							ContainerInfo.m_Stride = (DoTextureCoords ? (sizeof(float) * 2 + sizeof(ubvec4)) : 0);
-							ContainerInfo.m_VertBufferBindingIndex = BufferObjectIndex;
-							ContainerInfo.m_vAttributes.emplace_back();
-							SBufferContainerInfo::SAttribute *pAttr = &ContainerInfo.m_vAttributes.back();
-							pAttr->m_DataTypeCount = 2;
-							pAttr->m_Type = GRAPHICS_TYPE_FLOAT;
-							pAttr->m_Normalized = false;
-							pAttr->m_pOffset = 0;
-							pAttr->m_FuncType = 0;
-							if(DoTextureCoords)
-							{
-								ContainerInfo.m_vAttributes.emplace_back();
-								pAttr = &ContainerInfo.m_vAttributes.back();
-								pAttr->m_DataTypeCount = 4;
-								pAttr->m_Type = GRAPHICS_TYPE_UNSIGNED_BYTE;
-								pAttr->m_Normalized = false;
-								pAttr->m_pOffset = (void *)(sizeof(vec2));
-								pAttr->m_FuncType = 1;
-							}
-
-							Visuals.m_BufferContainerIndex = Graphics()->CreateBufferContainer(&ContainerInfo);
-							// and finally inform the backend how many indices are required
-							Graphics()->IndicesNumRequiredNotify(vtmpTiles.size() * 6);
-
-							RenderLoading();
-						}
-
-						++CurOverlay;
+						auto pJob = std::make_shared<CTileLayerJob>(pTileData, pTMap->m_Width, pTMap->m_Height, CurOverlay, DoTextureCoords);
+						pJob->m_IsGameLayer = IsGameLayer;
+						pJob->m_IsEntityLayer = IsEntityLayer;
+						pJob->m_IsFrontLayer = IsFrontLayer;
+						pJob->m_IsSwitchLayer = IsSwitchLayer;
+						pJob->m_IsTeleLayer = IsTeleLayer;
+						pJob->m_IsSpeedupLayer = IsSpeedupLayer;
+						pJob->m_IsTuneLayer = IsTuneLayer;
+						m_vPendingTileLayers.emplace_back(m_vpTileLayerVisuals.size() - 1, pJob);
+						Engine()->AddJob(pJob);
 					}
 				}
 			}
@@ -1406,6 +1450,9 @@ void CMapLayers::LayersOfGroupCount(CMapItemGroup *pGroup, int &TileLayerCount,
 
 void CMapLayers::OnRender()
 {
+	if(!m_vPendingTileLayers.empty())
+		UploadFinishedTileLayers();
+
 	if(m_OnlineOnly && Client()->State() != IClient::STATE_ONLINE && Client()->State() != IClient::STATE_DEMOPLAYBACK)
 		return;
 
@@ -2,9 +2,12 @@
 /* If you are missing that file, acquire a complete release at teeworlds.com.                */
 #ifndef GAME_CLIENT_COMPONENTS_MAPLAYERS_H
 #define GAME_CLIENT_COMPONENTS_MAPLAYERS_H
+#include <engine/shared/jobs.h>
+
 #include <game/client/component.h>
 
 #include <cstdint>
+#include <memory>
 #include <vector>
 
 #define INDEX_BUFFER_GROUP_WIDTH 12
@@ -107,6 +110,38 @@ class CMapLayers : public CComponent
 	};
 	std::vector<STileLayerVisuals *> m_vpTileLayerVisuals;
 
+	// generates the vertices of one tile layer overlay on the job pool,
+	// the buffers are uploaded on the main thread once it's done
+	class CTileLayerJob : public IJob
+	{
+		void Run() override;
+
+	public:
+		CTileLayerJob(std::shared_ptr<std::vector<unsigned char>> pTiles, int Width, int Height, int CurOverlay, bool DoTextureCoords);
+		~CTileLayerJob() override;
+
+		std::shared_ptr<std::vector<unsigned char>> m_pTiles;
+		int m_Width;
+		int m_Height;
+		int m_CurOverlay;
+		bool m_DoTextureCoords;
+		bool m_IsGameLayer = false;
+		bool m_IsEntityLayer = false;
+		bool m_IsFrontLayer = false;
+		bool m_IsSwitchLayer = false;
+		bool m_IsTeleLayer = false;
+		bool m_IsSpeedupLayer = false;
+		bool m_IsTuneLayer = false;
+
+		std::unique_ptr<STileLayerVisuals> m_pVisuals;
+		char *m_pUploadData = nullptr;
+		size_t m_UploadDataSize = 0;
+		size_t m_NumTiles = 0;
+	};
+	// index into m_vpTileLayerVisuals and the job filling it
+	std::vector<std::pair<size_t, std::shared_ptr<CTileLayerJob>>> m_vPendingTileLayers;
+	void UploadFinishedTileLayers();
+
 	struct SQuadLayerVisuals
 	{
 		SQuadLayerVisuals() :
@@ -152,6 +187,10 @@ public:
 	virtual void OnRender() override;
 	virtual void OnMapLoad() override;
 
+	bool TileLayersPending() const { return !m_vPendingTileLayers.empty(); }
+	// blocks until all tile layers are built and uploaded
+	void FinishTileLayers();
+
 	void RenderTileLayer(int LayerIndex, const ColorRGBA &Color, CMapItemLayerTilemap *pTileLayer, CMapItemGroup *pGroup);
 	void RenderTileBorder(int LayerIndex, const ColorRGBA &Color, CMapItemLayerTilemap *pTileLayer, CMapItemGroup *pGroup, int BorderX0, int BorderY0, int BorderX1, int BorderY1);
 	void RenderKillTileBorder(int LayerIndex, const ColorRGBA &Color, CMapItemLayerTilemap *pTileLayer, CMapItemGroup *pGroup);
@@ -6,6 +6,7 @@
 #include <base/system.h>
 
 #include <engine/engine.h>
+#include <engine/gfx/image_loader.h>
 #include <engine/gfx/image_manipulation.h>
 #include <engine/graphics.h>
 #include <engine/shared/config.h>
@@ -93,8 +94,23 @@ int CSkins::SkinScan(const char *pName, int IsDir, int DirType, void *pUser)
 
 	char aPath[IO_MAX_PATH_LENGTH];
 	str_format(aPath, sizeof(aPath), "skins/%s", pName);
-	pSelf->LoadSkin(aSkinName, aPath, DirType);
-	pUserReal->m_SkinLoadedFunc((int)pSelf->m_Skins.size());
+	if(pSelf->m_Skins.find(aSkinName) != pSelf->m_Skins.end() || pSelf->m_LoadingSkins.find(aSkinName) != pSelf->m_LoadingSkins.end())
+	{
+		// already found in a storage location with higher priority
+	}
+	else if(str_comp(aSkinName, "default") == 0)
+	{
+		// the default skin is the fallback for all others, so it must be available right away
+		pSelf->LoadSkin(aSkinName, aPath, DirType);
+	}
+	else
+	{
+		auto pJob = std::make_shared<CSkinLoadJob>(pSelf->Storage(), aSkinName, aPath, DirType);
+		pSelf->m_LoadingSkins.insert({pJob->m_aName, pJob});
+		pSelf->Engine()->AddJob(pJob);
+		pSelf->m_SkinsLoadedPending = true;
+	}
+	pUserReal->m_SkinLoadedFunc((int)(pSelf->m_Skins.size() + pSelf->m_LoadingSkins.size()));
 	return 0;
 }
 
@@ -151,29 +167,9 @@ bool CSkins::LoadSkinPng(CImageInfo &Info, const char *pName, const char *pPath,
 	return true;
 }
 
-const CSkin *CSkins::LoadSkin(const char *pName, CImageInfo &Info)
+bool CSkins::PrepareSkin(CSkinLoadData &Data)
 {
-	if(!Graphics()->CheckImageDivisibility(pName, Info, g_pData->m_aSprites[SPRITE_TEE_BODY].m_pSet->m_Gridx, g_pData->m_aSprites[SPRITE_TEE_BODY].m_pSet->m_Gridy, true))
-	{
-		log_error("skins", "Skin failed image divisibility: %s", pName);
-		return nullptr;
-	}
-	if(!Graphics()->IsImageFormatRgba(pName, Info))
-	{
-		log_error("skins", "Skin format is not RGBA: %s", pName);
-		return nullptr;
-	}
-
-	CSkin Skin{pName};
-	Skin.m_OriginalSkin.m_Body = Graphics()->LoadSpriteTexture(Info, &g_pData->m_aSprites[SPRITE_TEE_BODY]);
-	Skin.m_OriginalSkin.m_BodyOutline = Graphics()->LoadSpriteTexture(Info, &g_pData->m_aSprites[SPRITE_TEE_BODY_OUTLINE]);
-	Skin.m_OriginalSkin.m_Feet = Graphics()->LoadSpriteTexture(Info, &g_pData->m_aSprites[SPRITE_TEE_FOOT]);
-	Skin.m_OriginalSkin.m_FeetOutline = Graphics()->LoadSpriteTexture(Info, &g_pData->m_aSprites[SPRITE_TEE_FOOT_OUTLINE]);
-	Skin.m_OriginalSkin.m_Hands = Graphics()->LoadSpriteTexture(Info, &g_pData->m_aSprites[SPRITE_TEE_HAND]);
-	Skin.m_OriginalSkin.m_HandsOutline = Graphics()->LoadSpriteTexture(Info, &g_pData->m_aSprites[SPRITE_TEE_HAND_OUTLINE]);
-
-	for(int i = 0; i < 6; ++i)
-		Skin.m_OriginalSkin.m_aEyes[i] = Graphics()->LoadSpriteTexture(Info, &g_pData->m_aSprites[SPRITE_TEE_EYE_NORMAL + i]);
+	const CImageInfo &Info = Data.m_Info;
 
 	int FeetGridPixelsWidth = (Info.m_Width / g_pData->m_aSprites[SPRITE_TEE_FOOT].m_pSet->m_Gridx);
 	int FeetGridPixelsHeight = (Info.m_Height / g_pData->m_aSprites[SPRITE_TEE_FOOT].m_pSet->m_Gridy);
@@ -202,7 +198,7 @@ const CSkin *CSkins::LoadSkin(const char *pName, CImageInfo &Info)
 	size_t BodyWidth = g_pData->m_aSprites[SPRITE_TEE_BODY].m_W * (Info.m_Width / g_pData->m_aSprites[SPRITE_TEE_BODY].m_pSet->m_Gridx); // body width
 	size_t BodyHeight = g_pData->m_aSprites[SPRITE_TEE_BODY].m_H * (Info.m_Height / g_pData->m_aSprites[SPRITE_TEE_BODY].m_pSet->m_Gridy); // body height
 	if(BodyWidth > Info.m_Width || BodyHeight > Info.m_Height)
-		return nullptr;
+		return false;
 	uint8_t *pData = Info.m_pData;
 	const int PixelStep = 4;
 	int Pitch = Info.m_Width * PixelStep;
@@ -224,21 +220,30 @@ const CSkin *CSkins::LoadSkin(const char *pName, CImageInfo &Info)
 			}
 		}
 
-		Skin.m_BloodColor = ColorRGBA(normalize(vec3(aColors[0], aColors[1], aColors[2])));
+		Data.m_BloodColor = ColorRGBA(normalize(vec3(aColors[0], aColors[1], aColors[2])));
 	}
 
-	CheckMetrics(Skin.m_Metrics.m_Body, pData, Pitch, 0, 0, BodyWidth, BodyHeight);
+	CheckMetrics(Data.m_Metrics.m_Body, pData, Pitch, 0, 0, BodyWidth, BodyHeight);
 
 	// body outline metrics
-	CheckMetrics(Skin.m_Metrics.m_Body, pData, Pitch, BodyOutlineOffsetX, BodyOutlineOffsetY, BodyOutlineWidth, BodyOutlineHeight);
+	CheckMetrics(Data.m_Metrics.m_Body, pData, Pitch, BodyOutlineOffsetX, BodyOutlineOffsetY, BodyOutlineWidth, BodyOutlineHeight);
 
 	// get feet size
-	CheckMetrics(Skin.m_Metrics.m_Feet, pData, Pitch, FeetOffsetX, FeetOffsetY, FeetWidth, FeetHeight);
+	CheckMetrics(Data.m_Metrics.m_Feet, pData, Pitch, FeetOffsetX, FeetOffsetY, FeetWidth, FeetHeight);
 
 	// get feet outline size
-	CheckMetrics(Skin.m_Metrics.m_Feet, pData, Pitch, FeetOutlineOffsetX, FeetOutlineOffsetY, FeetOutlineWidth, FeetOutlineHeight);
+	CheckMetrics(Data.m_Metrics.m_Feet, pData, Pitch, FeetOutlineOffsetX, FeetOutlineOffsetY, FeetOutlineWidth, FeetOutlineHeight);
 
-	ConvertToGrayscale(Info);
+	// the colorable skin is made from a grayscale copy
+	CImageInfo &Grayscale = Data.m_InfoGrayscale;
+	Grayscale.m_Width = Info.m_Width;
+	Grayscale.m_Height = Info.m_Height;
+	Grayscale.m_Format = Info.m_Format;
+	Grayscale.m_pData = static_cast<uint8_t *>(malloc(Info.DataSize()));
+	mem_copy(Grayscale.m_pData, Info.m_pData, Info.DataSize());
+	pData = Grayscale.m_pData;
+
+	ConvertToGrayscale(Grayscale);
 
 	int aFreq[256] = {0};
 	int OrgWeight = 0;
@@ -278,17 +283,61 @@ const CSkin *CSkins::LoadSkin(const char *pName, CImageInfo &Info)
 			pData[y * Pitch + x * PixelStep + 2] = v;
 		}
 
-	Skin.m_ColorableSkin.m_Body = Graphics()->LoadSpriteTexture(Info, &g_pData->m_aSprites[SPRITE_TEE_BODY]);
-	Skin.m_ColorableSkin.m_BodyOutline = Graphics()->LoadSpriteTexture(Info, &g_pData->m_aSprites[SPRITE_TEE_BODY_OUTLINE]);
-	Skin.m_ColorableSkin.m_Feet = Graphics()->LoadSpriteTexture(Info, &g_pData->m_aSprites[SPRITE_TEE_FOOT]);
-	Skin.m_ColorableSkin.m_FeetOutline = Graphics()->LoadSpriteTexture(Info, &g_pData->m_aSprites[SPRITE_TEE_FOOT_OUTLINE]);
-	Skin.m_ColorableSkin.m_Hands = Graphics()->LoadSpriteTexture(Info, &g_pData->m_aSprites[SPRITE_TEE_HAND]);
-	Skin.m_ColorableSkin.m_HandsOutline = Graphics()->LoadSpriteTexture(Info, &g_pData->m_aSprites[SPRITE_TEE_HAND_OUTLINE]);
+	return true;
+}
+
+const CSkin *CSkins::LoadSkin(const char *pName, CImageInfo &Info)
+{
+	if(!Graphics()->CheckImageDivisibility(pName, Info, g_pData->m_aSprites[SPRITE_TEE_BODY].m_pSet->m_Gridx, g_pData->m_aSprites[SPRITE_TEE_BODY].m_pSet->m_Gridy, true))
+	{
+		log_error("skins", "Skin failed image divisibility: %s", pName);
+		return nullptr;
+	}
+	if(!Graphics()->IsImageFormatRgba(pName, Info))
+	{
+		log_error("skins", "Skin format is not RGBA: %s", pName);
+		return nullptr;
+	}
+
+	CSkinLoadData Data;
+	Data.m_Info = Info;
+	Info = CImageInfo();
+	if(!PrepareSkin(Data))
+	{
+		Data.m_Info.Free();
+		return nullptr;
+	}
+	return UploadSkin(pName, Data);
+}
+
+const CSkin *CSkins::UploadSkin(const char *pName, CSkinLoadData &Data)
+{
+	CSkin Skin{pName};
+	Skin.m_OriginalSkin.m_Body = Graphics()->LoadSpriteTexture(Data.m_Info, &g_pData->m_aSprites[SPRITE_TEE_BODY]);
+	Skin.m_OriginalSkin.m_BodyOutline = Graphics()->LoadSpriteTexture(Data.m_Info, &g_pData->m_aSprites[SPRITE_TEE_BODY_OUTLINE]);
+	Skin.m_OriginalSkin.m_Feet = Graphics()->LoadSpriteTexture(Data.m_Info, &g_pData->m_aSprites[SPRITE_TEE_FOOT]);
+	Skin.m_OriginalSkin.m_FeetOutline = Graphics()->LoadSpriteTexture(Data.m_Info, &g_pData->m_aSprites[SPRITE_TEE_FOOT_OUTLINE]);
+	Skin.m_OriginalSkin.m_Hands = Graphics()->LoadSpriteTexture(Data.m_Info, &g_pData->m_aSprites[SPRITE_TEE_HAND]);
+	Skin.m_OriginalSkin.m_HandsOutline = Graphics()->LoadSpriteTexture(Data.m_Info, &g_pData->m_aSprites[SPRITE_TEE_HAND_OUTLINE]);
+
+	for(int i = 0; i < 6; ++i)
+		Skin.m_OriginalSkin.m_aEyes[i] = Graphics()->LoadSpriteTexture(Data.m_Info, &g_pData->m_aSprites[SPRITE_TEE_EYE_NORMAL + i]);
+
+	Skin.m_ColorableSkin.m_Body = Graphics()->LoadSpriteTexture(Data.m_InfoGrayscale, &g_pData->m_aSprites[SPRITE_TEE_BODY]);
+	Skin.m_ColorableSkin.m_BodyOutline = Graphics()->LoadSpriteTexture(Data.m_InfoGrayscale, &g_pData->m_aSprites[SPRITE_TEE_BODY_OUTLINE]);
+	Skin.m_ColorableSkin.m_Feet = Graphics()->LoadSpriteTexture(Data.m_InfoGrayscale, &g_pData->m_aSprites[SPRITE_TEE_FOOT]);
+	Skin.m_ColorableSkin.m_FeetOutline = Graphics()->LoadSpriteTexture(Data.m_InfoGrayscale, &g_pData->m_aSprites[SPRITE_TEE_FOOT_OUTLINE]);
+	Skin.m_ColorableSkin.m_Hands = Graphics()->LoadSpriteTexture(Data.m_InfoGrayscale, &g_pData->m_aSprites[SPRITE_TEE_HAND]);
+	Skin.m_ColorableSkin.m_HandsOutline = Graphics()->LoadSpriteTexture(Data.m_InfoGrayscale, &g_pData->m_aSprites[SPRITE_TEE_HAND_OUTLINE]);
 
 	for(int i = 0; i < 6; ++i)
-		Skin.m_ColorableSkin.m_aEyes[i] = Graphics()->LoadSpriteTexture(Info, &g_pData->m_aSprites[SPRITE_TEE_EYE_NORMAL + i]);
+		Skin.m_ColorableSkin.m_aEyes[i] = Graphics()->LoadSpriteTexture(Data.m_InfoGrayscale, &g_pData->m_aSprites[SPRITE_TEE_EYE_NORMAL + i]);
 
-	Info.Free();
+	Skin.m_Metrics = Data.m_Metrics;
+	Skin.m_BloodColor = Data.m_BloodColor;
+
+	Data.m_Info.Free();
+	Data.m_InfoGrayscale.Free();
 
 	if(g_Config.m_Debug)
 	{
@@ -301,6 +350,53 @@ const CSkin *CSkins::LoadSkin(const char *pName, CImageInfo &Info)
 	return SkinInsertIt.first->second.get();
 }
 
+CSkins::CSkinLoadJob::CSkinLoadJob(IStorage *pStorage, const char *pName, const char *pPath, int StorageType) :
+	m_pStorage(pStorage),
+	m_StorageType(StorageType)
+{
+	str_copy(m_aName, pName);
+	str_copy(m_aPath, pPath);
+}
+
+CSkins::CSkinLoadJob::~CSkinLoadJob()
+{
+	m_Data.m_Info.Free();
+	m_Data.m_InfoGrayscale.Free();
+}
+
+void CSkins::CSkinLoadJob::Run()
+{
+	IOHANDLE File = m_pStorage->OpenFile(m_aPath, IOFLAG_READ, m_StorageType);
+	m_PngLoaded = CImageLoader::LoadPng(File, m_aPath, m_Data.m_Info, m_PngliteIncompatible);
+	if(!m_PngLoaded)
+		return;
+
+	// images that are not divisible by the grid are resized on the main thread
+	const CDataSprite &Body = g_pData->m_aSprites[SPRITE_TEE_BODY];
+	const CImageInfo &Info = m_Data.m_Info;
+	if(Info.m_Format != CImageInfo::FORMAT_RGBA ||
+		Info.m_Width == 0 || Info.m_Width % Body.m_pSet->m_Gridx != 0 ||
+		Info.m_Height == 0 || Info.m_Height % Body.m_pSet->m_Gridy != 0)
+		return;
+
+	m_Prepared = PrepareSkin(m_Data);
+	if(!m_Prepared)
+		m_Data.m_InfoGrayscale.Free();
+}
+
+const CSkin *CSkins::FinishLoadSkin(CSkinLoadJob &Job)
+{
+	if(!Job.m_PngLoaded)
+	{
+		log_error("skins", "Failed to load skin PNG: %s", Job.m_aName);
+		return nullptr;
+	}
+	Graphics()->WarnPngliteIncompatibility(Job.m_PngliteIncompatible, Job.m_aName);
+	if(Job.m_Prepared)
+		return UploadSkin(Job.m_aName, Job.m_Data);
+	return LoadSkin(Job.m_aName, Job.m_Data.m_Info);
+}
+
 void CSkins::OnInit()
 {
 	m_aEventSkinPrefix[0] = '\0';
@@ -328,6 +424,7 @@ void CSkins::Refresh(TSkinLoadedCBFunc &&SkinLoadedFunc)
 	}
 
 	m_Skins.clear();
+	m_LoadingSkins.clear();
 	m_DownloadSkins.clear();
 	m_DownloadingSkins = 0;
 	SSkinScanUser SkinScanUser;
@@ -336,6 +433,29 @@ void CSkins::Refresh(TSkinLoadedCBFunc &&SkinLoadedFunc)
 	Storage()->ListDirectory(IStorage::TYPE_ALL, "skins", SkinScan, &SkinScanUser);
 }
 
+void CSkins::OnRender()
+{
+	// upload finished skins, but limit the time spent per frame
+	const int64_t Deadline = time_get() + time_freq() / 500;
+	for(auto It = m_LoadingSkins.begin(); It != m_LoadingSkins.end() && time_get() < Deadline;)
+	{
+		if(!It->second->Done())
+		{
+			++It;
+			continue;
+		}
+		const std::shared_ptr<CSkinLoadJob> pJob = It->second;
+		It = m_LoadingSkins.erase(It);
+		FinishLoadSkin(*pJob);
+	}
+
+	if(m_LoadingSkins.empty() && m_SkinsLoadedPending)
+	{
+		m_SkinsLoadedPending = false;
+		GameClient()->OnSkinsLoaded();
+	}
+}
+
 int CSkins::Num()
 {
 	return m_Skins.size();
@@ -384,6 +504,17 @@ const CSkin *CSkins::FindImpl(const char *pName)
 	if(SkinIt != m_Skins.end())
 		return SkinIt->second.get();
 
+	const auto LoadingIt = m_LoadingSkins.find(pName);
+	if(LoadingIt != m_LoadingSkins.end())
+	{
+		// skins that are still being loaded fall back to the default skin
+		if(!LoadingIt->second->Done())
+			return nullptr;
+		const std::shared_ptr<CSkinLoadJob> pJob = LoadingIt->second;
+		m_LoadingSkins.erase(LoadingIt);
+		return FinishLoadSkin(*pJob);
+	}
+
 	if(str_comp(pName, "default") == 0)
 		return nullptr;
 
@@ -5,6 +5,7 @@
 
 #include <base/system.h>
 #include <engine/shared/http.h>
+#include <engine/shared/jobs.h>
 #include <game/client/component.h>
 #include <game/client/skin.h>
 #include <string_view>
@@ -60,10 +61,12 @@ public:
 
 	virtual int Sizeof() const override { return sizeof(*this); }
 	void OnInit() override;
+	void OnRender() override;
 
 	void Refresh(TSkinLoadedCBFunc &&SkinLoadedFunc);
 	int Num();
 	std::unordered_map<std::string_view, std::unique_ptr<CSkin>> &GetSkinsUnsafe() { return m_Skins; }
+	bool IsLoadingSkins() const { return !m_LoadingSkins.empty(); }
 	const CSkin *FindOrNullptr(const char *pName, bool IgnorePrefix = false);
 	const CSkin *Find(const char *pName);
 	void RandomizeSkin(int Dummy);
@@ -78,15 +81,51 @@ public:
 		"twinbop", "twintri", "warpaint", "x_ninja", "x_spec"};
 
 private:
+	// everything needed to create the textures of a skin, prepared without touching the graphics
+	class CSkinLoadData
+	{
+	public:
+		CImageInfo m_Info;
+		CImageInfo m_InfoGrayscale;
+		CSkin::SSkinMetrics m_Metrics;
+		ColorRGBA m_BloodColor;
+	};
+
+	// decodes a skin PNG and prepares its data on a worker thread
+	class CSkinLoadJob : public IJob
+	{
+		IStorage *m_pStorage;
+		char m_aPath[IO_MAX_PATH_LENGTH];
+		int m_StorageType;
+
+		void Run() override;
+
+	public:
+		CSkinLoadJob(IStorage *pStorage, const char *pName, const char *pPath, int StorageType);
+		~CSkinLoadJob() override;
+
+		char m_aName[24];
+		bool m_PngLoaded = false;
+		int m_PngliteIncompatible = 0;
+		// false if the image needs to be validated on the main thread, which may resize it
+		bool m_Prepared = false;
+		CSkinLoadData m_Data;
+	};
+
 	std::unordered_map<std::string_view, std::unique_ptr<CSkin>> m_Skins;
+	std::unordered_map<std::string_view, std::shared_ptr<CSkinLoadJob>> m_LoadingSkins;
 	std::unordered_map<std::string_view, std::unique_ptr<CDownloadSkin>> m_DownloadSkins;
 	CSkin m_PlaceholderSkin;
 	size_t m_DownloadingSkins = 0;
+	bool m_SkinsLoadedPending = false;
 	char m_aEventSkinPrefix[24];
 
 	bool LoadSkinPng(CImageInfo &Info, const char *pName, const char *pPath, int DirType);
 	const CSkin *LoadSkin(const char *pName, const char *pPath, int DirType);
 	const CSkin *LoadSkin(const char *pName, CImageInfo &Info);
+	const CSkin *FinishLoadSkin(CSkinLoadJob &Job);
+	const CSkin *UploadSkin(const char *pName, CSkinLoadData &Data);
+	static bool PrepareSkin(CSkinLoadData &Data);
 	const CSkin *FindImpl(const char *pName);
 	static int SkinScan(const char *pName, int IsDir, int DirType, void *pUser);
 };
@@ -3,6 +3,11 @@
 
 #include <chrono>
 #include <limits>
+#include <typeinfo>
+
+#if defined(__GNUC__)
+#include <cxxabi.h>
+#endif
 
 #include <engine/client/checksum.h>
 #include <engine/client/enums.h>
@@ -15,6 +20,7 @@
 #include <engine/map.h>
 #include <engine/serverbrowser.h>
 #include <engine/shared/config.h>
+#include <engine/shared/trace.h>
 #include <engine/sound.h>
 #include <engine/storage.h>
 #include <engine/textrender.h>
@@ -88,6 +94,24 @@ const char *CGameClient::DDNetVersionStr() const { return m_aDDNetVersionStr; }
 int CGameClient::ClientVersion7() const { return CLIENT_VERSION7; }
 const char *CGameClient::GetItemName(int Type) const { return m_NetObjHandler.GetObjName(Type); }
 
+static std::string ComponentTraceName(const CComponent *pComponent)
+{
+	const char *pName = typeid(*pComponent).name();
+#if defined(__GNUC__)
+	int Status;
+	char *pDemangled = abi::__cxa_demangle(pName, nullptr, nullptr, &Status);
+	if(pDemangled)
+	{
+		std::string Result = pDemangled;
+		free(pDemangled);
+		return Result;
+	}
+#endif
+	if(str_startswith(pName, "class "))
+		pName += str_length("class ");
+	return pName;
+}
+
 void CGameClient::OnConsoleInit()
 {
 	m_pEngine = Kernel()->RequestInterface<IEngine>();
@@ -177,6 +201,10 @@ void CGameClient::OnConsoleInit()
 	for(auto &pComponent : m_vpAll)
 		pComponent->m_pClient = this;
 
+	m_vComponentTraceNames.clear();
+	for(auto &pComponent : m_vpAll)
+		m_vComponentTraceNames.push_back(ComponentTraceName(pComponent));
+
 	// let all the other components register their console commands
 	for(auto &pComponent : m_vpAll)
 		pComponent->OnConsoleInit();
@@ -756,8 +784,12 @@ void CGameClient::OnRender()
 	}
 
 	// render all systems
-	for(auto &pComponent : m_vpAll)
-		pComponent->OnRender();
+	CTraceRecorder *pTraceRecorder = Client()->TraceRecorder();
+	for(size_t i = 0; i < m_vpAll.size(); i++)
+	{
+		CTraceScope TraceScope(pTraceRecorder, m_vComponentTraceNames[i].c_str());
+		m_vpAll[i]->OnRender();
+	}
 
 	// clear all events/input for this frame
 	Input()->Clear();
@@ -1191,6 +1223,12 @@ void CGameClient::HandleLanguageChanged()
 	Client()->OnWindowResize();
 }
 
+void CGameClient::FinishMapLoad()
+{
+	m_MapLayersBackground.FinishTileLayers();
+	m_MapLayersForeground.FinishTileLayers();
+}
+
 void CGameClient::RenderShutdownMessage()
 {
 	const char *pMessage = nullptr;
@@ -1465,6 +1503,8 @@ void CGameClient::InvalidateSnapshot()
 
 void CGameClient::OnNewSnapshot()
 {
+	CTraceScope TraceScope(Client()->TraceRecorder(), "OnNewSnapshot");
+
 	auto &&Evolve = [this](CNetObj_Character *pCharacter, int Tick) {
 		CWorldCore TempWorld;
 		CCharacterCore TempCore = CCharacterCore();
@@ -2126,6 +2166,8 @@ void CGameClient::UpdateEditorIngameMoved()
 
 void CGameClient::OnPredict()
 {
+	CTraceScope TraceScope(Client()->TraceRecorder(), "OnPredict");
+
 	// store the previous values so we can detect prediction errors
 	CCharacterCore BeforePrevChar = m_PredictedPrevChar;
 	CCharacterCore BeforeChar = m_PredictedChar;
@@ -3747,7 +3789,11 @@ void CGameClient::RefreshSkins()
 			m_Menus.RenderLoading(Localize("Loading skin files"), "", 0, false);
 		}
 	});
+	OnSkinsLoaded();
+}
 
+void CGameClient::OnSkinsLoaded()
+{
 	for(auto &Client : m_aClients)
 	{
 		if(Client.m_aSkinName[0] != '\0')
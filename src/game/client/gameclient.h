@@ -170,6 +170,7 @@ public:
 private:
 	std::vector<class CComponent *> m_vpAll;
 	std::vector<class CComponent *> m_vpInput;
+	std::vector<std::string> m_vComponentTraceNames;
 	CNetObjHandler m_NetObjHandler;
 	protocol7::CNetObjHandler m_NetObjHandler7;
 
@@ -539,8 +540,10 @@ public:
 	void HandleLanguageChanged();
 
 	void RefreshSkins();
+	void OnSkinsLoaded();
 
 	void RenderShutdownMessage() override;
+	void FinishMapLoad() override;
 
 	const char *GetItemName(int Type) const override;
 	const char *Version() const override;
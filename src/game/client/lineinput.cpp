@@ -566,9 +566,11 @@ void CLineInput::RenderCandidates()
 	Graphics()->MapScreen(0.0f, 0.0f, Width, Height);
 
 	// Determine longest candidate width
-	float LongestCandidateWidth = 0.0f;
+	std::vector<const char *> vpCandidates;
+	vpCandidates.reserve(Input()->GetCandidateCount());
 	for(int i = 0; i < Input()->GetCandidateCount(); ++i)
-		LongestCandidateWidth = maximum(LongestCandidateWidth, TextRender()->TextWidth(FontSize, Input()->GetCandidate(i)));
+		vpCandidates.push_back(Input()->GetCandidate(i));
+	const float LongestCandidateWidth = TextRender()->TextWidths(FontSize, vpCandidates.data(), vpCandidates.size());
 
 	const float NumOffset = 8.0f;
 	const float RectWidth = LongestCandidateWidth + Margin + NumOffset + 2.0f * Padding;
@@ -1,7 +1,15 @@
+#include <atomic>
 #include <cinttypes>
 #include <cstdio> // sscanf
+#include <functional>
+#include <memory>
+#include <thread>
+
+#include <base/math.h>
 
 #include <engine/console.h>
+#include <engine/engine.h>
+#include <engine/shared/jobs.h>
 #include <engine/shared/linereader.h>
 #include <engine/storage.h>
 
@@ -40,6 +48,66 @@ static int HashLocation(uint32_t Seed, uint32_t Run, uint32_t Rule, uint32_t X,
 	return Hash % HASH_MAX;
 }
 
+// hands out blocks of rows to the calling thread and the job pool
+class CAutoMapRows
+{
+public:
+	enum
+	{
+		ROWS_PER_BLOCK = 8,
+	};
+
+	std::atomic<int> m_NextRow{0};
+	std::atomic<int> m_RowsDone{0};
+	int m_NumRows;
+	std::function<void(int)> m_fnRow;
+
+	void Process()
+	{
+		while(true)
+		{
+			const int Start = m_NextRow.fetch_add(ROWS_PER_BLOCK);
+			if(Start >= m_NumRows)
+				return;
+			const int End = minimum(Start + (int)ROWS_PER_BLOCK, m_NumRows);
+			for(int y = Start; y < End; y++)
+				m_fnRow(y);
+			m_RowsDone.fetch_add(End - Start);
+		}
+	}
+};
+
+class CAutoMapRowsJob : public IJob
+{
+	std::shared_ptr<CAutoMapRows> m_pRows;
+
+	void Run() override { m_pRows->Process(); }
+
+public:
+	CAutoMapRowsJob(std::shared_ptr<CAutoMapRows> pRows) :
+		m_pRows(std::move(pRows)) {}
+};
+
+static void ForEachRow(IEngine *pEngine, int Width, int Height, std::function<void(int)> &&fnRow)
+{
+	auto pRows = std::make_shared<CAutoMapRows>();
+	pRows->m_NumRows = Height;
+	pRows->m_fnRow = std::move(fnRow);
+
+	// small areas like the ones of live automapping are not worth the overhead
+	int NumJobs = 0;
+	if(pEngine && Width * Height >= 128 * 128)
+		NumJobs = minimum((int)std::thread::hardware_concurrency(), (Height + CAutoMapRows::ROWS_PER_BLOCK - 1) / CAutoMapRows::ROWS_PER_BLOCK) - 1;
+	for(int i = 0; i < NumJobs; i++)
+		pEngine->AddJob(std::make_shared<CAutoMapRowsJob>(pRows));
+
+	// jobs that start after all rows were taken return right away, so this
+	// never waits for jobs stuck behind others in the queue
+	pRows->Process();
+	while(pRows->m_RowsDone.load() < Height)
+		thread_yield();
+}
+
 CAutoMapper::CAutoMapper(CEditor *pEditor)
 {
 	OnInit(pEditor);
@@ -420,26 +488,30 @@ void CAutoMapper::ProceedLocalized(CLayerTiles *pLayer, int ConfigId, int Seed,
 	int UpdateToX = clamp(X + Width + 3 * pConf->m_EndX, 0, pLayer->m_Width);
 	int UpdateToY = clamp(Y + Height + 3 * pConf->m_EndY, 0, pLayer->m_Height);
 
-	CLayerTiles *pUpdateLayer = new CLayerTiles(Editor(), UpdateToX - UpdateFromX, UpdateToY - UpdateFromY);
-
+	// only the area the rules can reach is automapped
+	const int UpdateWidth = UpdateToX - UpdateFromX;
+	const int UpdateHeight = UpdateToY - UpdateFromY;
+	std::vector<CTile> vUpdateTiles(UpdateWidth * UpdateHeight);
 	for(int y = UpdateFromY; y < UpdateToY; y++)
 	{
 		for(int x = UpdateFromX; x < UpdateToX; x++)
 		{
-			CTile *pIn = &pLayer->m_pTiles[y * pLayer->m_Width + x];
-			CTile *pOut = &pUpdateLayer->m_pTiles[(y - UpdateFromY) * pUpdateLayer->m_Width + x - UpdateFromX];
+			const CTile *pIn = &pLayer->m_pTiles[y * pLayer->m_Width + x];
+			CTile *pOut = &vUpdateTiles[(y - UpdateFromY) * UpdateWidth + x - UpdateFromX];
 			pOut->m_Index = pIn->m_Index;
 			pOut->m_Flags = pIn->m_Flags;
 		}
 	}
 
-	Proceed(pUpdateLayer, ConfigId, Seed, UpdateFromX, UpdateFromY);
+	Editor()->m_Map.OnModify();
+	std::vector<unsigned char> vChanged(vUpdateTiles.size(), 0);
+	ProceedTiles(pConf, vUpdateTiles.data(), UpdateWidth, UpdateHeight, Seed, UpdateFromX, UpdateFromY, vChanged.data());
 
 	for(int y = CommitFromY; y < CommitToY; y++)
 	{
 		for(int x = CommitFromX; x < CommitToX; x++)
 		{
-			CTile *pIn = &pUpdateLayer->m_pTiles[(y - UpdateFromY) * pUpdateLayer->m_Width + x - UpdateFromX];
+			const CTile *pIn = &vUpdateTiles[(y - UpdateFromY) * UpdateWidth + x - UpdateFromX];
 			CTile *pOut = &pLayer->m_pTiles[y * pLayer->m_Width + x];
 			CTile Previous = *pOut;
 			pOut->m_Index = pIn->m_Index;
@@ -447,8 +519,6 @@ void CAutoMapper::ProceedLocalized(CLayerTiles *pLayer, int ConfigId, int Seed,
 			pLayer->RecordStateChange(x, y, Previous, *pOut);
 		}
 	}
-
-	delete pUpdateLayer;
 }
 
 void CAutoMapper::Proceed(CLayerTiles *pLayer, int ConfigId, int Seed, int SeedOffsetX, int SeedOffsetY)
@@ -456,115 +526,122 @@ void CAutoMapper::Proceed(CLayerTiles *pLayer, int ConfigId, int Seed, int SeedO
 	if(!m_FileLoaded || pLayer->m_Readonly || ConfigId < 0 || ConfigId >= (int)m_vConfigs.size())
 		return;
 
-	if(Seed == 0)
-		Seed = rand();
-
 	CConfiguration *pConf = &m_vConfigs[ConfigId];
 	pLayer->ClearHistory();
+	Editor()->m_Map.OnModify();
+
+	const int NumTiles = pLayer->m_Width * pLayer->m_Height;
+	std::vector<CTile> vPrevious(pLayer->m_pTiles, pLayer->m_pTiles + NumTiles);
+	std::vector<unsigned char> vChanged(NumTiles, 0);
+	ProceedTiles(pConf, pLayer->m_pTiles, pLayer->m_Width, pLayer->m_Height, Seed, SeedOffsetX, SeedOffsetY, vChanged.data());
+
+	// the history is not thread-safe, so it's recorded afterwards
+	for(int y = 0; y < pLayer->m_Height; y++)
+	{
+		for(int x = 0; x < pLayer->m_Width; x++)
+		{
+			const int Index = y * pLayer->m_Width + x;
+			if(vChanged[Index])
+				pLayer->RecordStateChange(x, y, vPrevious[Index], pLayer->m_pTiles[Index]);
+		}
+	}
+}
+
+void CAutoMapper::ProceedTiles(const CConfiguration *pConf, CTile *pTiles, int Width, int Height, int Seed, int SeedOffsetX, int SeedOffsetY, unsigned char *pChanged)
+{
+	if(Seed == 0)
+		Seed = rand();
 
 	// for every run: copy tiles, automap, overwrite tiles
+	std::vector<CTile> vReadTiles;
 	for(size_t h = 0; h < pConf->m_vRuns.size(); ++h)
 	{
-		CRun *pRun = &pConf->m_vRuns[h];
-
-		// don't make copy if it's requested
-		CLayerTiles *pReadLayer;
+		const CRun *pRun = &pConf->m_vRuns[h];
 		if(pRun->m_AutomapCopy)
 		{
-			pReadLayer = new CLayerTiles(Editor(), pLayer->m_Width, pLayer->m_Height);
-
-			for(int y = 0; y < pLayer->m_Height; y++)
-			{
-				for(int x = 0; x < pLayer->m_Width; x++)
-				{
-					CTile *pIn = &pLayer->m_pTiles[y * pLayer->m_Width + x];
-					CTile *pOut = &pReadLayer->m_pTiles[y * pLayer->m_Width + x];
-					pOut->m_Index = pIn->m_Index;
-					pOut->m_Flags = pIn->m_Flags;
-				}
-			}
+			// every tile only reads from the copy, so the rows are independent
+			vReadTiles.assign(pTiles, pTiles + Width * Height);
+			const CTile *pReadTiles = vReadTiles.data();
+			ForEachRow(Engine(), Width, Height, [&](int y) {
+				ProceedRow(pRun, h, pReadTiles, pTiles, Width, Height, y, Seed, SeedOffsetX, SeedOffsetY, pChanged);
+			});
 		}
 		else
 		{
-			pReadLayer = pLayer;
+			// rules see the tiles changed before them, so the order matters
+			for(int y = 0; y < Height; y++)
+				ProceedRow(pRun, h, pTiles, pTiles, Width, Height, y, Seed, SeedOffsetX, SeedOffsetY, pChanged);
 		}
+	}
+}
+
+void CAutoMapper::ProceedRow(const CRun *pRun, int RunIndex, const CTile *pReadTiles, CTile *pTiles, int Width, int Height, int y, int Seed, int SeedOffsetX, int SeedOffsetY, unsigned char *pChanged) const
+{
+	for(int x = 0; x < Width; x++)
+	{
+		CTile *pTile = &pTiles[y * Width + x];
+		const CTile *pReadTile = &pReadTiles[y * Width + x];
 
-		// auto map
-		for(int y = 0; y < pLayer->m_Height; y++)
+		for(size_t i = 0; i < pRun->m_vIndexRules.size(); ++i)
 		{
-			for(int x = 0; x < pLayer->m_Width; x++)
+			const CIndexRule *pIndexRule = &pRun->m_vIndexRules[i];
+			if(pIndexRule->m_SkipEmpty && pReadTile->m_Index == 0) // skip empty tiles
+				continue;
+			if(pIndexRule->m_SkipFull && pReadTile->m_Index != 0) // skip full tiles
+				continue;
+
+			bool RespectRules = true;
+			for(size_t j = 0; j < pIndexRule->m_vRules.size() && RespectRules; ++j)
 			{
-				CTile *pTile = &(pLayer->m_pTiles[y * pLayer->m_Width + x]);
-				const CTile *pReadTile = &(pReadLayer->m_pTiles[y * pLayer->m_Width + x]);
-				Editor()->m_Map.OnModify();
+				const CPosRule *pRule = &pIndexRule->m_vRules[j];
 
-				for(size_t i = 0; i < pRun->m_vIndexRules.size(); ++i)
+				int CheckIndex, CheckFlags;
+				int CheckX = x + pRule->m_X;
+				int CheckY = y + pRule->m_Y;
+				if(CheckX >= 0 && CheckX < Width && CheckY >= 0 && CheckY < Height)
 				{
-					CIndexRule *pIndexRule = &pRun->m_vIndexRules[i];
-					if(pIndexRule->m_SkipEmpty && pReadTile->m_Index == 0) // skip empty tiles
-						continue;
-					if(pIndexRule->m_SkipFull && pReadTile->m_Index != 0) // skip full tiles
-						continue;
-
-					bool RespectRules = true;
-					for(size_t j = 0; j < pIndexRule->m_vRules.size() && RespectRules; ++j)
-					{
-						CPosRule *pRule = &pIndexRule->m_vRules[j];
+					int CheckTile = CheckY * Width + CheckX;
+					CheckIndex = pReadTiles[CheckTile].m_Index;
+					CheckFlags = pReadTiles[CheckTile].m_Flags & (TILEFLAG_ROTATE | TILEFLAG_XFLIP | TILEFLAG_YFLIP);
+				}
+				else
+				{
+					CheckIndex = -1;
+					CheckFlags = 0;
+				}
 
-						int CheckIndex, CheckFlags;
-						int CheckX = x + pRule->m_X;
-						int CheckY = y + pRule->m_Y;
-						if(CheckX >= 0 && CheckX < pLayer->m_Width && CheckY >= 0 && CheckY < pLayer->m_Height)
-						{
-							int CheckTile = CheckY * pLayer->m_Width + CheckX;
-							CheckIndex = pReadLayer->m_pTiles[CheckTile].m_Index;
-							CheckFlags = pReadLayer->m_pTiles[CheckTile].m_Flags & (TILEFLAG_ROTATE | TILEFLAG_XFLIP | TILEFLAG_YFLIP);
-						}
-						else
+				if(pRule->m_Value == CPosRule::INDEX)
+				{
+					RespectRules = false;
+					for(const auto &Index : pRule->m_vIndexList)
+					{
+						if(CheckIndex == Index.m_Id && (!Index.m_TestFlag || CheckFlags == Index.m_Flag))
 						{
-							CheckIndex = -1;
-							CheckFlags = 0;
+							RespectRules = true;
+							break;
 						}
-
-						if(pRule->m_Value == CPosRule::INDEX)
+					}
+				}
+				else if(pRule->m_Value == CPosRule::NOTINDEX)
+				{
+					for(const auto &Index : pRule->m_vIndexList)
+					{
+						if(CheckIndex == Index.m_Id && (!Index.m_TestFlag || CheckFlags == Index.m_Flag))
 						{
 							RespectRules = false;
-							for(const auto &Index : pRule->m_vIndexList)
-							{
-								if(CheckIndex == Index.m_Id && (!Index.m_TestFlag || CheckFlags == Index.m_Flag))
-								{
-									RespectRules = true;
-									break;
-								}
-							}
-						}
-						else if(pRule->m_Value == CPosRule::NOTINDEX)
-						{
-							for(const auto &Index : pRule->m_vIndexList)
-							{
-								if(CheckIndex == Index.m_Id && (!Index.m_TestFlag || CheckFlags == Index.m_Flag))
-								{
-									RespectRules = false;
-									break;
-								}
-							}
+							break;
 						}
 					}
-
-					if(RespectRules &&
-						(pIndexRule->m_RandomProbability >= 1.0f || HashLocation(Seed, h, i, x + SeedOffsetX, y + SeedOffsetY) < HASH_MAX * pIndexRule->m_RandomProbability))
-					{
-						CTile Previous = *pTile;
-						pTile->m_Index = pIndexRule->m_Id;
-						pTile->m_Flags = pIndexRule->m_Flag;
-						pLayer->RecordStateChange(x, y, Previous, *pTile);
-					}
 				}
 			}
-		}
 
-		// clean-up
-		if(pRun->m_AutomapCopy && pReadLayer != pLayer)
-			delete pReadLayer;
+			if(RespectRules &&
+				(pIndexRule->m_RandomProbability >= 1.0f || HashLocation(Seed, RunIndex, i, x + SeedOffsetX, y + SeedOffsetY) < HASH_MAX * pIndexRule->m_RandomProbability))
+			{
+				pTile->m_Index = pIndexRule->m_Id;
+				pTile->m_Flags = pIndexRule->m_Flag;
+				pChanged[y * Width + x] = 1;
+			}
+		}
 	}
 }
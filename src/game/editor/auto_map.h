@@ -5,6 +5,8 @@
 
 #include "component.h"
 
+class CTile;
+
 class CAutoMapper : public CEditorComponent
 {
 	struct CIndexInfo
@@ -71,6 +73,10 @@ public:
 private:
 	std::vector<CConfiguration> m_vConfigs = {};
 	bool m_FileLoaded = false;
+
+	void ProceedRow(const CRun *pRun, int RunIndex, const CTile *pReadTiles, CTile *pTiles, int Width, int Height, int y, int Seed, int SeedOffsetX, int SeedOffsetY, unsigned char *pChanged) const;
+	// automaps the tiles in place, tiles changed by any rule are marked in pChanged
+	void ProceedTiles(const CConfiguration *pConf, CTile *pTiles, int Width, int Height, int Seed, int SeedOffsetX, int SeedOffsetY, unsigned char *pChanged);
 };
 
 #endif
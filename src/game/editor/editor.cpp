@@ -8518,7 +8518,8 @@ bool CEditor::PerformAutosave()
 	str_format(aAutosavePath, sizeof(aAutosavePath), "maps/auto/%s_%s.map", aFileNameNoExt, aDate);
 
 	m_Map.m_LastSaveTime = Client()->GlobalTime();
-	if(Save(aAutosavePath))
+	// autosaves are never shared, so favor saving quickly over file size
+	if(Save(aAutosavePath, CDataFileWriter::COMPRESSION_FAST))
 	{
 		m_Map.m_ModifiedAuto = false;
 		// Clean up autosaves
@@ -8721,12 +8722,17 @@ void CEditor::LoadCurrentMap()
 }
 
 bool CEditor::Save(const char *pFilename)
+{
+	return Save(pFilename, CDataFileWriter::COMPRESSION_DEFAULT);
+}
+
+bool CEditor::Save(const char *pFilename, CDataFileWriter::ECompressionLevel CompressionLevel)
 {
 	// Check if file with this name is already being saved at the moment
 	if(std::any_of(std::begin(m_WriterFinishJobs), std::end(m_WriterFinishJobs), [pFilename](const std::shared_ptr<CDataFileWriterFinishJob> &Job) { return str_comp(pFilename, Job->GetRealFileName()) == 0; }))
 		return false;
 
-	return m_Map.Save(pFilename);
+	return m_Map.Save(pFilename, CompressionLevel);
 }
 
 bool CEditor::HandleMapDrop(const char *pFileName, int StorageType)
@@ -200,7 +200,7 @@ public:
 	void CreateDefault(IGraphics::CTextureHandle EntitiesTexture);
 
 	// io
-	bool Save(const char *pFilename);
+	bool Save(const char *pFilename, CDataFileWriter::ECompressionLevel CompressionLevel = CDataFileWriter::COMPRESSION_DEFAULT);
 	bool Load(const char *pFilename, int StorageType, const std::function<void(const char *pErrorMessage)> &ErrorHandler);
 	void PerformSanityChecks(const std::function<void(const char *pErrorMessage)> &ErrorHandler);
 
@@ -504,6 +504,7 @@ public:
 
 	void Reset(bool CreateDefault = true);
 	bool Save(const char *pFilename) override;
+	bool Save(const char *pFilename, CDataFileWriter::ECompressionLevel CompressionLevel);
 	bool Load(const char *pFilename, int StorageType) override;
 	bool HandleMapDrop(const char *pFilename, int StorageType) override;
 	bool Append(const char *pFilename, int StorageType, bool IgnoreHistory = false);
@@ -1,6 +1,7 @@
 #ifndef GAME_EDITOR_EDITOR_ACTION_H
 #define GAME_EDITOR_EDITOR_ACTION_H
 
+#include <cstddef>
 #include <string>
 
 class CEditor;
@@ -19,6 +20,8 @@ public:
 	virtual void Redo() = 0;
 
 	virtual bool IsEmpty() { return false; }
+	// Approximate memory in bytes kept by the action to undo and redo it, used to limit the history size.
+	virtual size_t MemoryUsage() const { return 0; }
 
 	const char *DisplayText() const { return m_aDisplayText; }
 
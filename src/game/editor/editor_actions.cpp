@@ -17,7 +17,7 @@ CEditorBrushDrawAction::CEditorBrushDrawAction(CEditor *pEditor, int Group) :
 			{
 				if(!Map.m_pTeleLayer->m_History.empty())
 				{
-					m_TeleTileChanges = std::map(Map.m_pTeleLayer->m_History);
+					m_TeleTileChanges = CCompressedTileChanges(Map.m_pTeleLayer->m_History);
 					Map.m_pTeleLayer->ClearHistory();
 				}
 			}
@@ -25,7 +25,7 @@ CEditorBrushDrawAction::CEditorBrushDrawAction(CEditor *pEditor, int Group) :
 			{
 				if(!Map.m_pTuneLayer->m_History.empty())
 				{
-					m_TuneTileChanges = std::map(Map.m_pTuneLayer->m_History);
+					m_TuneTileChanges = CCompressedTileChanges(Map.m_pTuneLayer->m_History);
 					Map.m_pTuneLayer->ClearHistory();
 				}
 			}
@@ -33,7 +33,7 @@ CEditorBrushDrawAction::CEditorBrushDrawAction(CEditor *pEditor, int Group) :
 			{
 				if(!Map.m_pSwitchLayer->m_History.empty())
 				{
-					m_SwitchTileChanges = std::map(Map.m_pSwitchLayer->m_History);
+					m_SwitchTileChanges = CCompressedTileChanges(Map.m_pSwitchLayer->m_History);
 					Map.m_pSwitchLayer->ClearHistory();
 				}
 			}
@@ -41,14 +41,14 @@ CEditorBrushDrawAction::CEditorBrushDrawAction(CEditor *pEditor, int Group) :
 			{
 				if(!Map.m_pSpeedupLayer->m_History.empty())
 				{
-					m_SpeedupTileChanges = std::map(Map.m_pSpeedupLayer->m_History);
+					m_SpeedupTileChanges = CCompressedTileChanges(Map.m_pSpeedupLayer->m_History);
 					Map.m_pSpeedupLayer->ClearHistory();
 				}
 			}
 
 			if(!pLayerTiles->m_TilesHistory.empty())
 			{
-				m_vTileChanges.emplace_back(k, std::map(pLayerTiles->m_TilesHistory));
+				m_vTileChanges.emplace_back(k, CCompressedTileChanges(pLayerTiles->m_TilesHistory));
 				pLayerTiles->ClearHistory();
 			}
 		}
@@ -66,54 +66,33 @@ void CEditorBrushDrawAction::SetInfos()
 	// Process normal tiles
 	for(auto const &Pair : m_vTileChanges)
 	{
-		int Layer = Pair.first;
-		std::shared_ptr<CLayer> pLayer = m_pEditor->m_Map.m_vpGroups[m_Group]->m_vpLayers[Layer];
 		m_TotalLayers++;
-
-		if(pLayer->m_Type == LAYERTYPE_TILES)
-		{
-			std::shared_ptr<CLayerTiles> pLayerTiles = std::static_pointer_cast<CLayerTiles>(pLayer);
-			auto Changes = Pair.second;
-			for(auto &Change : Changes)
-			{
-				m_TotalTilesDrawn += Change.second.size();
-			}
-		}
-	}
-
-	// Process speedup tiles
-	for(auto const &SpeedupChange : m_SpeedupTileChanges)
-	{
-		m_TotalTilesDrawn += SpeedupChange.second.size();
+		m_TotalTilesDrawn += Pair.second.NumChanges();
 	}
 
-	// Process tele tiles
-	for(auto const &TeleChange : m_TeleTileChanges)
-	{
-		m_TotalTilesDrawn += TeleChange.second.size();
-	}
+	// Process speedup, tele, switch and tune tiles
+	m_TotalTilesDrawn += m_SpeedupTileChanges.NumChanges();
+	m_TotalTilesDrawn += m_TeleTileChanges.NumChanges();
+	m_TotalTilesDrawn += m_SwitchTileChanges.NumChanges();
+	m_TotalTilesDrawn += m_TuneTileChanges.NumChanges();
 
-	// Process switch tiles
-	for(auto const &SwitchChange : m_SwitchTileChanges)
-	{
-		m_TotalTilesDrawn += SwitchChange.second.size();
-	}
-
-	// Process tune tiles
-	for(auto const &TuneChange : m_TuneTileChanges)
-	{
-		m_TotalTilesDrawn += TuneChange.second.size();
-	}
-
-	m_TotalLayers += !m_SpeedupTileChanges.empty();
-	m_TotalLayers += !m_SwitchTileChanges.empty();
-	m_TotalLayers += !m_TeleTileChanges.empty();
-	m_TotalLayers += !m_TuneTileChanges.empty();
+	m_TotalLayers += !m_SpeedupTileChanges.Empty();
+	m_TotalLayers += !m_SwitchTileChanges.Empty();
+	m_TotalLayers += !m_TeleTileChanges.Empty();
+	m_TotalLayers += !m_TuneTileChanges.Empty();
 }
 
 bool CEditorBrushDrawAction::IsEmpty()
 {
-	return m_vTileChanges.empty() && m_SpeedupTileChanges.empty() && m_SwitchTileChanges.empty() && m_TeleTileChanges.empty() && m_TuneTileChanges.empty();
+	return m_vTileChanges.empty() && m_SpeedupTileChanges.Empty() && m_SwitchTileChanges.Empty() && m_TeleTileChanges.Empty() && m_TuneTileChanges.Empty();
+}
+
+size_t CEditorBrushDrawAction::MemoryUsage() const
+{
+	size_t Usage = m_SpeedupTileChanges.MemoryUsage() + m_SwitchTileChanges.MemoryUsage() + m_TeleTileChanges.MemoryUsage() + m_TuneTileChanges.MemoryUsage();
+	for(auto const &Pair : m_vTileChanges)
+		Usage += Pair.second.MemoryUsage();
+	return Usage;
 }
 
 void CEditorBrushDrawAction::Undo()
@@ -139,96 +118,55 @@ void CEditorBrushDrawAction::Apply(bool Undo)
 		if(pLayer->m_Type == LAYERTYPE_TILES)
 		{
 			std::shared_ptr<CLayerTiles> pLayerTiles = std::static_pointer_cast<CLayerTiles>(pLayer);
-			auto Changes = Pair.second;
-			for(auto &Change : Changes)
-			{
-				int y = Change.first;
-				auto Line = Change.second;
-				for(auto &Tile : Line)
-				{
-					int x = Tile.first;
-					STileStateChange State = Tile.second;
-					pLayerTiles->SetTileIgnoreHistory(x, y, Undo ? State.m_Previous : State.m_Current);
-				}
-			}
+			Pair.second.ForEach([&](int x, int y, const STileStateChange &State) {
+				pLayerTiles->SetTileIgnoreHistory(x, y, Undo ? State.m_Previous : State.m_Current);
+			});
 		}
 	}
 
 	// Process speedup tiles
-	for(auto const &SpeedupChange : m_SpeedupTileChanges)
-	{
-		int y = SpeedupChange.first;
-		auto Line = SpeedupChange.second;
-		for(auto &Tile : Line)
-		{
-			int x = Tile.first;
-			int Index = y * Map.m_pSpeedupLayer->m_Width + x;
-			SSpeedupTileStateChange State = Tile.second;
-			SSpeedupTileStateChange::SData Data = Undo ? State.m_Previous : State.m_Current;
-
-			Map.m_pSpeedupLayer->m_pSpeedupTile[Index].m_Force = Data.m_Force;
-			Map.m_pSpeedupLayer->m_pSpeedupTile[Index].m_MaxSpeed = Data.m_MaxSpeed;
-			Map.m_pSpeedupLayer->m_pSpeedupTile[Index].m_Angle = Data.m_Angle;
-			Map.m_pSpeedupLayer->m_pSpeedupTile[Index].m_Type = Data.m_Type;
-			Map.m_pSpeedupLayer->m_pTiles[Index].m_Index = Data.m_Index;
-		}
-	}
+	m_SpeedupTileChanges.ForEach([&](int x, int y, const SSpeedupTileStateChange &State) {
+		int Index = y * Map.m_pSpeedupLayer->m_Width + x;
+		SSpeedupTileStateChange::SData Data = Undo ? State.m_Previous : State.m_Current;
+
+		Map.m_pSpeedupLayer->m_pSpeedupTile[Index].m_Force = Data.m_Force;
+		Map.m_pSpeedupLayer->m_pSpeedupTile[Index].m_MaxSpeed = Data.m_MaxSpeed;
+		Map.m_pSpeedupLayer->m_pSpeedupTile[Index].m_Angle = Data.m_Angle;
+		Map.m_pSpeedupLayer->m_pSpeedupTile[Index].m_Type = Data.m_Type;
+		Map.m_pSpeedupLayer->m_pTiles[Index].m_Index = Data.m_Index;
+	});
 
 	// Process tele tiles
-	for(auto const &TeleChange : m_TeleTileChanges)
-	{
-		int y = TeleChange.first;
-		auto Line = TeleChange.second;
-		for(auto &Tile : Line)
-		{
-			int x = Tile.first;
-			int Index = y * Map.m_pTeleLayer->m_Width + x;
-			STeleTileStateChange State = Tile.second;
-			STeleTileStateChange::SData Data = Undo ? State.m_Previous : State.m_Current;
-
-			Map.m_pTeleLayer->m_pTeleTile[Index].m_Number = Data.m_Number;
-			Map.m_pTeleLayer->m_pTeleTile[Index].m_Type = Data.m_Type;
-			Map.m_pTeleLayer->m_pTiles[Index].m_Index = Data.m_Index;
-		}
-	}
+	m_TeleTileChanges.ForEach([&](int x, int y, const STeleTileStateChange &State) {
+		int Index = y * Map.m_pTeleLayer->m_Width + x;
+		STeleTileStateChange::SData Data = Undo ? State.m_Previous : State.m_Current;
+
+		Map.m_pTeleLayer->m_pTeleTile[Index].m_Number = Data.m_Number;
+		Map.m_pTeleLayer->m_pTeleTile[Index].m_Type = Data.m_Type;
+		Map.m_pTeleLayer->m_pTiles[Index].m_Index = Data.m_Index;
+	});
 
 	// Process switch tiles
-	for(auto const &SwitchChange : m_SwitchTileChanges)
-	{
-		int y = SwitchChange.first;
-		auto Line = SwitchChange.second;
-		for(auto &Tile : Line)
-		{
-			int x = Tile.first;
-			int Index = y * Map.m_pSwitchLayer->m_Width + x;
-			SSwitchTileStateChange State = Tile.second;
-			SSwitchTileStateChange::SData Data = Undo ? State.m_Previous : State.m_Current;
-
-			Map.m_pSwitchLayer->m_pSwitchTile[Index].m_Number = Data.m_Number;
-			Map.m_pSwitchLayer->m_pSwitchTile[Index].m_Type = Data.m_Type;
-			Map.m_pSwitchLayer->m_pSwitchTile[Index].m_Flags = Data.m_Flags;
-			Map.m_pSwitchLayer->m_pSwitchTile[Index].m_Delay = Data.m_Delay;
-			Map.m_pSwitchLayer->m_pTiles[Index].m_Index = Data.m_Index;
-		}
-	}
+	m_SwitchTileChanges.ForEach([&](int x, int y, const SSwitchTileStateChange &State) {
+		int Index = y * Map.m_pSwitchLayer->m_Width + x;
+		SSwitchTileStateChange::SData Data = Undo ? State.m_Previous : State.m_Current;
+
+		Map.m_pSwitchLayer->m_pSwitchTile[Index].m_Number = Data.m_Number;
+		Map.m_pSwitchLayer->m_pSwitchTile[Index].m_Type = Data.m_Type;
+		Map.m_pSwitchLayer->m_pSwitchTile[Index].m_Flags = Data.m_Flags;
+		Map.m_pSwitchLayer->m_pSwitchTile[Index].m_Delay = Data.m_Delay;
+		Map.m_pSwitchLayer->m_pTiles[Index].m_Index = Data.m_Index;
+	});
 
 	// Process tune tiles
-	for(auto const &TuneChange : m_TuneTileChanges)
-	{
-		int y = TuneChange.first;
-		auto Line = TuneChange.second;
-		for(auto &Tile : Line)
-		{
-			int x = Tile.first;
-			int Index = y * Map.m_pTuneLayer->m_Width + x;
-			STuneTileStateChange State = Tile.second;
-			STuneTileStateChange::SData Data = Undo ? State.m_Previous : State.m_Current;
-
-			Map.m_pTuneLayer->m_pTuneTile[Index].m_Number = Data.m_Number;
-			Map.m_pTuneLayer->m_pTuneTile[Index].m_Type = Data.m_Type;
-			Map.m_pTuneLayer->m_pTiles[Index].m_Index = Data.m_Index;
-		}
-	}
+	m_TuneTileChanges.ForEach([&](int x, int y, const STuneTileStateChange &State) {
+		int Index = y * Map.m_pTuneLayer->m_Width + x;
+		STuneTileStateChange::SData Data = Undo ? State.m_Previous : State.m_Current;
+
+		Map.m_pTuneLayer->m_pTuneTile[Index].m_Number = Data.m_Number;
+		Map.m_pTuneLayer->m_pTuneTile[Index].m_Type = Data.m_Type;
+		Map.m_pTuneLayer->m_pTiles[Index].m_Index = Data.m_Index;
+	});
 }
 
 // -------------------------------------------
@@ -474,6 +412,14 @@ void CEditorActionBulk::Redo()
 	}
 }
 
+size_t CEditorActionBulk::MemoryUsage() const
+{
+	size_t Usage = 0;
+	for(const auto &pAction : m_vpActions)
+		Usage += pAction->MemoryUsage();
+	return Usage;
+}
+
 // ---------
 
 CEditorActionTileChanges::CEditorActionTileChanges(CEditor *pEditor, int GroupIndex, int LayerIndex, const char *pAction, const EditorTileStateChangeHistory<STileStateChange> &Changes) :
@@ -497,26 +443,21 @@ void CEditorActionTileChanges::Apply(bool Undo)
 {
 	auto &Map = m_pEditor->m_Map;
 	std::shared_ptr<CLayerTiles> pLayerTiles = std::static_pointer_cast<CLayerTiles>(m_pLayer);
-	for(auto &Change : m_Changes)
-	{
-		int y = Change.first;
-		auto Line = Change.second;
-		for(auto &Tile : Line)
-		{
-			int x = Tile.first;
-			STileStateChange State = Tile.second;
-			pLayerTiles->SetTileIgnoreHistory(x, y, Undo ? State.m_Previous : State.m_Current);
-		}
-	}
+	m_Changes.ForEach([&](int x, int y, const STileStateChange &State) {
+		pLayerTiles->SetTileIgnoreHistory(x, y, Undo ? State.m_Previous : State.m_Current);
+	});
 
 	Map.OnModify();
 }
 
+size_t CEditorActionTileChanges::MemoryUsage() const
+{
+	return m_Changes.MemoryUsage();
+}
+
 void CEditorActionTileChanges::ComputeInfos()
 {
-	m_TotalChanges = 0;
-	for(auto &Line : m_Changes)
-		m_TotalChanges += Line.second.size();
+	m_TotalChanges = m_Changes.NumChanges();
 }
 
 // ---------
@@ -866,6 +807,29 @@ void CEditorActionEditLayerTilesProp::SetSavedLayers(const std::map<int, std::sh
 	m_SavedLayers = std::map(SavedLayers);
 }
 
+size_t CEditorActionEditLayerTilesProp::MemoryUsage() const
+{
+	// the saved layers are full copies of the layers before resizing or shifting
+	size_t Usage = 0;
+	for(const auto &[Layer, pSavedLayer] : m_SavedLayers)
+	{
+		if(pSavedLayer == nullptr)
+			continue;
+		std::shared_ptr<CLayerTiles> pSavedLayerTiles = std::static_pointer_cast<CLayerTiles>(pSavedLayer);
+		size_t TileSize = sizeof(CTile);
+		if(pSavedLayerTiles->m_Tele)
+			TileSize += sizeof(CTeleTile);
+		else if(pSavedLayerTiles->m_Speedup)
+			TileSize += sizeof(CSpeedupTile);
+		else if(pSavedLayerTiles->m_Switch)
+			TileSize += sizeof(CSwitchTile);
+		else if(pSavedLayerTiles->m_Tune)
+			TileSize += sizeof(CTuneTile);
+		Usage += (size_t)pSavedLayerTiles->m_Width * pSavedLayerTiles->m_Height * TileSize;
+	}
+	return Usage;
+}
+
 void CEditorActionEditLayerTilesProp::Undo()
 {
 	std::shared_ptr<CLayerTiles> pLayerTiles = std::static_pointer_cast<CLayerTiles>(m_pLayer);
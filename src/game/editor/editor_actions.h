@@ -26,17 +26,17 @@ public:
 	void Undo() override;
 	void Redo() override;
 	bool IsEmpty() override;
+	size_t MemoryUsage() const override;
 
 private:
 	int m_Group;
 	// m_vTileChanges is a list of changes for each layer that was modified.
-	// The std::pair is used to pair one layer (index) with its history (2D map).
-	// EditorTileStateChangeHistory<T> is a 2D map, storing a change item at a specific y,x position.
-	std::vector<std::pair<int, EditorTileStateChangeHistory<STileStateChange>>> m_vTileChanges;
-	EditorTileStateChangeHistory<STeleTileStateChange> m_TeleTileChanges;
-	EditorTileStateChangeHistory<SSpeedupTileStateChange> m_SpeedupTileChanges;
-	EditorTileStateChangeHistory<SSwitchTileStateChange> m_SwitchTileChanges;
-	EditorTileStateChangeHistory<STuneTileStateChange> m_TuneTileChanges;
+	// The std::pair is used to pair one layer (index) with its compressed history.
+	std::vector<std::pair<int, CCompressedTileChanges<STileStateChange>>> m_vTileChanges;
+	CCompressedTileChanges<STeleTileStateChange> m_TeleTileChanges;
+	CCompressedTileChanges<SSpeedupTileStateChange> m_SpeedupTileChanges;
+	CCompressedTileChanges<SSwitchTileStateChange> m_SwitchTileChanges;
+	CCompressedTileChanges<STuneTileStateChange> m_TuneTileChanges;
 
 	int m_TotalTilesDrawn;
 	int m_TotalLayers;
@@ -146,6 +146,7 @@ public:
 
 	void Undo() override;
 	void Redo() override;
+	size_t MemoryUsage() const override;
 
 private:
 	std::vector<std::shared_ptr<IEditorAction>> m_vpActions;
@@ -162,9 +163,10 @@ public:
 
 	void Undo() override;
 	void Redo() override;
+	size_t MemoryUsage() const override;
 
 private:
-	EditorTileStateChangeHistory<STileStateChange> m_Changes;
+	CCompressedTileChanges<STileStateChange> m_Changes;
 	int m_TotalChanges;
 
 	void ComputeInfos();
@@ -259,6 +261,7 @@ public:
 
 	void Undo() override;
 	void Redo() override;
+	size_t MemoryUsage() const override;
 
 	void SetSavedLayers(const std::map<int, std::shared_ptr<CLayer>> &SavedLayers);
 
@@ -27,13 +27,27 @@ void CEditorHistory::RecordAction(const std::shared_ptr<IEditorAction> &pAction,
 
 	if((int)m_vpUndoActions.size() >= g_Config.m_ClEditorMaxHistory)
 	{
-		m_vpUndoActions.pop_front();
+		PopUndoFront();
 	}
 
 	if(pDisplay == nullptr)
 		m_vpUndoActions.emplace_back(pAction);
 	else
 		m_vpUndoActions.emplace_back(std::make_shared<CEditorActionBulk>(m_pEditor, std::vector<std::shared_ptr<IEditorAction>>{pAction}, pDisplay));
+	m_UndoMemoryUsage += m_vpUndoActions.back()->MemoryUsage();
+
+	// Drop the oldest actions while the history uses too much memory, the newest one is always kept
+	const size_t MaxMemoryUsage = (size_t)g_Config.m_ClEditorMaxHistoryMemory * 1024 * 1024;
+	while(m_UndoMemoryUsage > MaxMemoryUsage && m_vpUndoActions.size() > 1)
+	{
+		PopUndoFront();
+	}
+}
+
+void CEditorHistory::PopUndoFront()
+{
+	m_UndoMemoryUsage -= m_vpUndoActions.front()->MemoryUsage();
+	m_vpUndoActions.pop_front();
 }
 
 bool CEditorHistory::Undo()
@@ -43,6 +57,7 @@ bool CEditorHistory::Undo()
 
 	auto pLastAction = m_vpUndoActions.back();
 	m_vpUndoActions.pop_back();
+	m_UndoMemoryUsage -= pLastAction->MemoryUsage();
 
 	pLastAction->Undo();
 
@@ -61,6 +76,7 @@ bool CEditorHistory::Redo()
 	pLastAction->Redo();
 
 	m_vpUndoActions.emplace_back(pLastAction);
+	m_UndoMemoryUsage += pLastAction->MemoryUsage();
 	return true;
 }
 
@@ -68,6 +84,7 @@ void CEditorHistory::Clear()
 {
 	m_vpUndoActions.clear();
 	m_vpRedoActions.clear();
+	m_UndoMemoryUsage = 0;
 }
 
 void CEditorHistory::BeginBulk()
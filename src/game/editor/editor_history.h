@@ -14,6 +14,7 @@ public:
 	{
 		m_pEditor = nullptr;
 		m_IsBulk = false;
+		m_UndoMemoryUsage = 0;
 	}
 
 	~CEditorHistory()
@@ -41,8 +42,12 @@ public:
 	std::deque<std::shared_ptr<IEditorAction>> m_vpRedoActions;
 
 private:
+	void PopUndoFront();
+
 	std::vector<std::shared_ptr<IEditorAction>> m_vpBulkActions;
 	bool m_IsBulk;
+	// sum of the memory usage of all undo actions
+	size_t m_UndoMemoryUsage;
 };
 
 #endif
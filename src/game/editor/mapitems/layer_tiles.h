@@ -3,7 +3,7 @@
 
 #include <game/editor/editor_trackers.h>
 #include <game/editor/enums.h>
-#include <map>
+#include <game/editor/tile_changes.h>
 
 #include "layer.h"
 
@@ -14,9 +14,6 @@ struct STileStateChange
 	CTile m_Current;
 };
 
-template<typename T>
-using EditorTileStateChangeHistory = std::map<int, std::map<int, T>>;
-
 enum
 {
 	DIRECTION_LEFT = 0,
@@ -0,0 +1,26 @@
+#include "tile_changes.h"
+
+#include <zlib.h>
+
+void CompressTileChanges(const std::vector<unsigned char> &vData, std::vector<unsigned char> &vCompressed)
+{
+	// undo steps are recorded while drawing, so favor speed over size
+	uLongf CompressedSize = compressBound(vData.size());
+	vCompressed.resize(CompressedSize);
+	const int Result = compress2(vCompressed.data(), &CompressedSize, vData.data(), vData.size(), Z_BEST_SPEED);
+	dbg_assert(Result == Z_OK, "failed to compress tile changes");
+	vCompressed.resize(CompressedSize);
+	vCompressed.shrink_to_fit();
+}
+
+bool DecompressTileChanges(const std::vector<unsigned char> &vCompressed, size_t Size, std::vector<unsigned char> &vData)
+{
+	vData.resize(Size);
+	uLongf UncompressedSize = Size;
+	if(uncompress(vData.data(), &UncompressedSize, vCompressed.data(), vCompressed.size()) != Z_OK || UncompressedSize != Size)
+	{
+		dbg_msg("editor", "failed to decompress tile changes");
+		return false;
+	}
+	return true;
+}
@@ -0,0 +1,101 @@
+#ifndef GAME_EDITOR_TILE_CHANGES_H
+#define GAME_EDITOR_TILE_CHANGES_H
+
+#include <base/system.h>
+
+#include <cstddef>
+#include <map>
+#include <vector>
+
+// A 2D map, storing a change item at a specific y,x position.
+template<typename T>
+using EditorTileStateChangeHistory = std::map<int, std::map<int, T>>;
+
+void CompressTileChanges(const std::vector<unsigned char> &vData, std::vector<unsigned char> &vCompressed);
+bool DecompressTileChanges(const std::vector<unsigned char> &vCompressed, size_t Size, std::vector<unsigned char> &vData);
+
+/**
+ * Compact storage for the tile changes kept by undo actions.
+ *
+ * The changes are stored as runs of adjacent changed tiles per row and compressed
+ * with zlib. An @link EditorTileStateChangeHistory @endlink takes a map node per
+ * changed tile, this only takes a few bytes for large fills or automapper runs.
+ */
+template<typename T>
+class CCompressedTileChanges
+{
+	struct SRun
+	{
+		int m_Y;
+		int m_X;
+		int m_Num;
+	};
+
+	std::vector<unsigned char> m_vData;
+	size_t m_Size = 0;
+	int m_NumChanges = 0;
+
+	static void Append(std::vector<unsigned char> &vData, const void *pData, size_t Size)
+	{
+		const unsigned char *pBytes = static_cast<const unsigned char *>(pData);
+		vData.insert(vData.end(), pBytes, pBytes + Size);
+	}
+
+public:
+	CCompressedTileChanges() = default;
+
+	explicit CCompressedTileChanges(const EditorTileStateChangeHistory<T> &Changes)
+	{
+		std::vector<unsigned char> vData;
+		for(const auto &[y, Line] : Changes)
+		{
+			for(auto It = Line.begin(); It != Line.end();)
+			{
+				SRun Run = {y, It->first, 0};
+				auto End = It;
+				while(End != Line.end() && End->first == Run.m_X + Run.m_Num)
+				{
+					++End;
+					++Run.m_Num;
+				}
+				Append(vData, &Run, sizeof(Run));
+				for(; It != End; ++It)
+					Append(vData, &It->second, sizeof(T));
+				m_NumChanges += Run.m_Num;
+			}
+		}
+		m_Size = vData.size();
+		if(m_Size > 0)
+			CompressTileChanges(vData, m_vData);
+	}
+
+	bool Empty() const { return m_NumChanges == 0; }
+	int NumChanges() const { return m_NumChanges; }
+	size_t MemoryUsage() const { return m_vData.capacity(); }
+
+	/**
+	 * Calls `Function(x, y, Change)` for every stored change, row by row.
+	 */
+	template<typename F>
+	void ForEach(F &&Function) const
+	{
+		std::vector<unsigned char> vData;
+		if(Empty() || !DecompressTileChanges(m_vData, m_Size, vData))
+			return;
+
+		for(size_t Pos = 0; Pos + sizeof(SRun) <= vData.size();)
+		{
+			SRun Run;
+			mem_copy(&Run, &vData[Pos], sizeof(Run));
+			Pos += sizeof(Run);
+			for(int i = 0; i < Run.m_Num; i++, Pos += sizeof(T))
+			{
+				T Change;
+				mem_copy(&Change, &vData[Pos], sizeof(T));
+				Function(Run.m_X + i, Run.m_Y, Change);
+			}
+		}
+	}
+};
+
+#endif
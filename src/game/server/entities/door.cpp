@@ -9,6 +9,8 @@
 #include <game/server/gamecontext.h>
 #include <game/server/player.h>
 
+MACRO_ALLOC_POOL_SLAB_IMPL(CDoor, 64)
+
 CDoor::CDoor(CGameWorld *pGameWorld, vec2 Pos, float Rotation, int Length,
 	int Number) :
 	CEntity(pGameWorld, CGameWorld::ENTTYPE_LASER)
@@ -13,6 +13,8 @@
 #include <game/server/player.h>
 #include <game/server/teams.h>
 
+MACRO_ALLOC_POOL_SLAB_IMPL(CDragger, 64)
+
 CDragger::CDragger(CGameWorld *pGameWorld, vec2 Pos, float Strength, bool IgnoreWalls, int Layer, int Number) :
 	CEntity(pGameWorld, CGameWorld::ENTTYPE_LASER)
 {
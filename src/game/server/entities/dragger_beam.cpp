@@ -12,6 +12,8 @@
 #include <game/server/gamecontext.h>
 #include <game/server/save.h>
 
+MACRO_ALLOC_POOL_SLAB_IMPL(CDraggerBeam, 64)
+
 CDraggerBeam::CDraggerBeam(CGameWorld *pGameWorld, CDragger *pDragger, vec2 Pos, float Strength, bool IgnoreWalls,
 	int ForClientId, int Layer, int Number) :
 	CEntity(pGameWorld, CGameWorld::ENTTYPE_LASER)
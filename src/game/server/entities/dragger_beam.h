@@ -23,6 +23,8 @@ class CGameWorld;
  */
 class CDraggerBeam : public CEntity
 {
+	MACRO_ALLOC_POOL_SLAB()
+
 	CDragger *m_pDragger;
 	float m_Strength;
 	bool m_IgnoreWalls;
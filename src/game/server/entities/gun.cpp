@@ -13,6 +13,8 @@
 #include <game/server/player.h>
 #include <game/server/teams.h>
 
+MACRO_ALLOC_POOL_SLAB_IMPL(CGun, 64)
+
 CGun::CGun(CGameWorld *pGameWorld, vec2 Pos, bool Freeze, bool Explosive, int Layer, int Number) :
 	CEntity(pGameWorld, CGameWorld::ENTTYPE_LASER)
 {
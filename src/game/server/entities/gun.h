@@ -21,6 +21,8 @@
  */
 class CGun : public CEntity
 {
+	MACRO_ALLOC_POOL_SLAB()
+
 	vec2 m_Core;
 	bool m_Freeze;
 	bool m_Explosive;
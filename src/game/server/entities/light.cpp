@@ -11,6 +11,8 @@
 #include <game/server/gamecontext.h>
 #include <game/server/player.h>
 
+MACRO_ALLOC_POOL_SLAB_IMPL(CLight, 64)
+
 CLight::CLight(CGameWorld *pGameWorld, vec2 Pos, float Rotation, int Length,
 	int Layer, int Number) :
 	CEntity(pGameWorld, CGameWorld::ENTTYPE_LASER)
@@ -12,6 +12,8 @@
 
 static constexpr int gs_PickupPhysSize = 14;
 
+MACRO_ALLOC_POOL_SLAB_IMPL(CPickup, 256)
+
 CPickup::CPickup(CGameWorld *pGameWorld, int Type, int SubType, int Layer, int Number) :
 	CEntity(pGameWorld, CGameWorld::ENTTYPE_PICKUP, vec2(0, 0), gs_PickupPhysSize)
 {
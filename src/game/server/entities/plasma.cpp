@@ -11,6 +11,8 @@
 
 const float PLASMA_ACCEL = 1.1f;
 
+MACRO_ALLOC_POOL_SLAB_IMPL(CPlasma, 256)
+
 CPlasma::CPlasma(CGameWorld *pGameWorld, vec2 Pos, vec2 Dir, bool Freeze,
 	bool Explosive, int ForClientId) :
 	CEntity(pGameWorld, CGameWorld::ENTTYPE_LASER)
@@ -11,6 +11,8 @@
 #include <game/server/gamecontext.h>
 #include <game/server/gamemodes/DDRace.h>
 
+MACRO_ALLOC_POOL_SLAB_IMPL(CProjectile, 256)
+
 CProjectile::CProjectile(
 	CGameWorld *pGameWorld,
 	int Type,
@@ -7,6 +7,8 @@
 
 class CProjectile : public CEntity
 {
+	MACRO_ALLOC_POOL_SLAB()
+
 public:
 	CProjectile(
 		CGameWorld *pGameWorld,
@@ -224,37 +224,41 @@ void CGameContext::FillAntibot(CAntibotRoundData *pData)
 		Collision()->FillAntibot(&pData->m_Map);
 	}
 	pData->m_Tick = Server()->Tick();
-	mem_zero(pData->m_aCharacters, sizeof(pData->m_aCharacters));
 	for(int i = 0; i < MAX_CLIENTS; i++)
 	{
-		CAntibotCharacterData *pChar = &pData->m_aCharacters[i];
-		for(auto &LatestInput : pChar->m_aLatestInputs)
-		{
-			LatestInput.m_TargetX = -1;
-			LatestInput.m_TargetY = -1;
-		}
-		pChar->m_Alive = false;
-		pChar->m_Pause = false;
-		pChar->m_Team = -1;
+		FillAntibotCharacter(i, &pData->m_aCharacters[i]);
+	}
+}
 
-		pChar->m_Pos = vec2(-1, -1);
-		pChar->m_Vel = vec2(0, 0);
-		pChar->m_Angle = -1;
-		pChar->m_HookedPlayer = -1;
-		pChar->m_SpawnTick = -1;
-		pChar->m_WeaponChangeTick = -1;
+void CGameContext::FillAntibotCharacter(int ClientId, CAntibotCharacterData *pChar)
+{
+	mem_zero(pChar, sizeof(*pChar));
+	for(auto &LatestInput : pChar->m_aLatestInputs)
+	{
+		LatestInput.m_TargetX = -1;
+		LatestInput.m_TargetY = -1;
+	}
+	pChar->m_Alive = false;
+	pChar->m_Pause = false;
+	pChar->m_Team = -1;
 
-		if(m_apPlayers[i])
+	pChar->m_Pos = vec2(-1, -1);
+	pChar->m_Vel = vec2(0, 0);
+	pChar->m_Angle = -1;
+	pChar->m_HookedPlayer = -1;
+	pChar->m_SpawnTick = -1;
+	pChar->m_WeaponChangeTick = -1;
+
+	if(m_apPlayers[ClientId])
+	{
+		str_copy(pChar->m_aName, Server()->ClientName(ClientId), sizeof(pChar->m_aName));
+		CCharacter *pGameChar = m_apPlayers[ClientId]->GetCharacter();
+		pChar->m_Alive = (bool)pGameChar;
+		pChar->m_Pause = m_apPlayers[ClientId]->IsPaused();
+		pChar->m_Team = m_apPlayers[ClientId]->GetTeam();
+		if(pGameChar)
 		{
-			str_copy(pChar->m_aName, Server()->ClientName(i), sizeof(pChar->m_aName));
-			CCharacter *pGameChar = m_apPlayers[i]->GetCharacter();
-			pChar->m_Alive = (bool)pGameChar;
-			pChar->m_Pause = m_apPlayers[i]->IsPaused();
-			pChar->m_Team = m_apPlayers[i]->GetTeam();
-			if(pGameChar)
-			{
-				pGameChar->FillAntibot(pChar);
-			}
+			pGameChar->FillAntibot(pChar);
 		}
 	}
 }
@@ -346,6 +346,7 @@ public:
 	void OnPreTickTeehistorian() override;
 	bool OnClientDDNetVersionKnown(int ClientId);
 	void FillAntibot(CAntibotRoundData *pData) override;
+	void FillAntibotCharacter(int ClientId, CAntibotCharacterData *pData) override;
 	bool ProcessSpamProtection(int ClientId, bool RespectChatInitialDelay = true);
 	int GetDDRaceTeam(int ClientId) const;
 	// Describes the time when the first player joined the server.
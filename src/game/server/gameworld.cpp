@@ -215,6 +215,12 @@ void CGameWorld::Tick()
 			GameServer()->SendChat(-1, TEAM_ALL, "Teams have been balanced");
 
 		// update all objects
+		// Entities are ticked serially, even when they are in different DDRace teams
+		// and cannot collide. Ticks have side effects outside of the team: events and
+		// sounds, chat and broadcast messages, score and teehistorian hooks, snap id
+		// allocation and CGameTeams state changes from tiles. Running teams concurrently
+		// would require buffering all of these and replaying them in list order to keep
+		// the results deterministic.
 		for(int i = 0; i < NUM_ENTTYPES; i++)
 		{
 			// It's important to call PreTick() and Tick() after each other.
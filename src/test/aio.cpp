@@ -144,3 +144,62 @@ TEST_F(Async, Transaction)
 	}
 	Expect(aText);
 }
+
+TEST(AsyncShared, ManyHandles)
+{
+	// all handles are written by the same worker thread
+	static const int NUM_HANDLES = 16;
+	CTestInfo Info;
+	char aaFilenames[NUM_HANDLES][IO_MAX_PATH_LENGTH];
+	ASYNCIO *apAio[NUM_HANDLES];
+	for(int i = 0; i < NUM_HANDLES; i++)
+	{
+		char aSuffix[16];
+		str_format(aSuffix, sizeof(aSuffix), ".%d", i);
+		Info.Filename(aaFilenames[i], sizeof(aaFilenames[i]), aSuffix);
+		IOHANDLE File = io_open(aaFilenames[i], IOFLAG_WRITE);
+		ASSERT_TRUE(File);
+		apAio[i] = aio_new(File);
+		ASSERT_TRUE(apAio[i]);
+	}
+
+	for(int Line = 0; Line < 1000; Line++)
+	{
+		for(int i = 0; i < NUM_HANDLES; i++)
+		{
+			char aLine[32];
+			str_format(aLine, sizeof(aLine), "%d %d", i, Line);
+			aio_lock(apAio[i]);
+			aio_write_unlocked(apAio[i], aLine, str_length(aLine));
+			aio_write_newline_unlocked(apAio[i]);
+			aio_unlock(apAio[i]);
+		}
+	}
+
+	for(int i = 0; i < NUM_HANDLES; i++)
+	{
+		aio_close(apAio[i]);
+		aio_wait(apAio[i]);
+		EXPECT_EQ(aio_error(apAio[i]), 0);
+		aio_free(apAio[i]);
+
+		IOHANDLE File = io_open(aaFilenames[i], IOFLAG_READ);
+		ASSERT_TRUE(File);
+		char *pContents = io_read_all_str(File);
+		io_close(File);
+		ASSERT_TRUE(pContents);
+		const char *pLine = pContents;
+		for(int Line = 0; Line < 1000; Line++)
+		{
+			char aExpected[32];
+			str_format(aExpected, sizeof(aExpected), "%d %d", i, Line);
+			ASSERT_TRUE(str_startswith(pLine, aExpected)) << aaFilenames[i];
+			pLine = str_find(pLine, "\n");
+			ASSERT_TRUE(pLine);
+			pLine++;
+		}
+		EXPECT_EQ(*pLine, '\0');
+		free(pContents);
+		fs_remove(aaFilenames[i]);
+	}
+}
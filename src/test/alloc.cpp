@@ -0,0 +1,36 @@
+#include <gtest/gtest.h>
+
+#include <game/alloc.h>
+
+TEST(SlabAllocator, Contiguous)
+{
+	CSlabAllocator Allocator(24, 4);
+	EXPECT_EQ(Allocator.SlotSize() % alignof(std::max_align_t), 0u);
+	char *apSlots[4];
+	for(auto &pSlot : apSlots)
+		pSlot = (char *)Allocator.Allocate(24);
+	for(int i = 1; i < 4; i++)
+		EXPECT_EQ(apSlots[i] - apSlots[i - 1], (ptrdiff_t)Allocator.SlotSize());
+	EXPECT_EQ(Allocator.NumChunks(), 1u);
+	EXPECT_EQ(Allocator.NumUsed(), 4u);
+
+	Allocator.Allocate(24);
+	EXPECT_EQ(Allocator.NumChunks(), 2u);
+	EXPECT_EQ(Allocator.NumUsed(), 5u);
+}
+
+TEST(SlabAllocator, Reuse)
+{
+	CSlabAllocator Allocator(sizeof(int), 8);
+	int *pFirst = (int *)Allocator.Allocate(sizeof(int));
+	*pFirst = 123;
+	Allocator.Free(pFirst);
+	EXPECT_EQ(Allocator.NumUsed(), 0u);
+
+	int *pSecond = (int *)Allocator.Allocate(sizeof(int));
+	EXPECT_EQ(pFirst, pSecond);
+	EXPECT_EQ(*pSecond, 0);
+	Allocator.Free(pSecond);
+	Allocator.Free(nullptr);
+	EXPECT_EQ(Allocator.NumChunks(), 1u);
+}
@@ -0,0 +1,82 @@
+#include <gtest/gtest.h>
+
+#include <antibot/antibot_data.h>
+
+#include <thread>
+#include <vector>
+
+static void InitRing(CAntibotEventRing *pRing, std::vector<CAntibotEvent> &vEvents)
+{
+	pRing->m_pEvents = vEvents.data();
+	pRing->m_Size = vEvents.size();
+	pRing->m_Published = 0;
+	pRing->m_Consumed = 0;
+	pRing->m_NumDropped = 0;
+	pRing->m_Pending = 0;
+}
+
+TEST(AntibotEventRing, PublishAndDrop)
+{
+	std::vector<CAntibotEvent> vEvents(4);
+	CAntibotEventRing Ring;
+	InitRing(&Ring, vEvents);
+
+	for(int i = 0; i < 3; i++)
+		Ring.Push()->m_ClientId = i;
+
+	// nothing is visible before publishing
+	EXPECT_EQ(Ring.Consume([](const CAntibotEvent &Event) { ADD_FAILURE(); }), 0u);
+	Ring.Publish();
+
+	Ring.Push()->m_ClientId = 3;
+	EXPECT_FALSE(Ring.Push());
+	EXPECT_EQ(Ring.m_NumDropped.load(), 1u);
+	Ring.Publish();
+
+	std::vector<int> vClientIds;
+	EXPECT_EQ(Ring.Consume([&](const CAntibotEvent &Event) { vClientIds.push_back(Event.m_ClientId); }), 4u);
+	EXPECT_EQ(vClientIds, (std::vector<int>{0, 1, 2, 3}));
+
+	// wraps around once consumed
+	EXPECT_TRUE(Ring.Push());
+}
+
+TEST(AntibotEventRing, Threaded)
+{
+	static const int NUM_TICKS = 2000;
+	static const int EVENTS_PER_TICK = 50;
+	std::vector<CAntibotEvent> vEvents(256);
+	CAntibotEventRing Ring;
+	InitRing(&Ring, vEvents);
+
+	std::atomic<bool> Done = false;
+	int NumConsumed = 0;
+	int LastTick = -1;
+	bool Ordered = true;
+	std::thread Consumer([&]() {
+		auto Check = [&](const CAntibotEvent &Event) {
+			Ordered = Ordered && Event.m_Tick >= LastTick;
+			LastTick = Event.m_Tick;
+			NumConsumed++;
+		};
+		while(!Done.load())
+			Ring.Consume(Check);
+		Ring.Consume(Check);
+	});
+
+	for(int Tick = 0; Tick < NUM_TICKS; Tick++)
+	{
+		for(int i = 0; i < EVENTS_PER_TICK; i++)
+		{
+			CAntibotEvent *pEvent = Ring.Push();
+			if(pEvent)
+				pEvent->m_Tick = Tick;
+		}
+		Ring.Publish();
+	}
+	Done = true;
+	Consumer.join();
+
+	EXPECT_TRUE(Ordered);
+	EXPECT_EQ(NumConsumed + (int)Ring.m_NumDropped.load(), NUM_TICKS * EVENTS_PER_TICK);
+}
@@ -0,0 +1,63 @@
+#include <gtest/gtest.h>
+
+#include <engine/client/graphics_threaded.h>
+
+TEST(CommandBuffer, Grow)
+{
+	CCommandBuffer::CBuffer Buffer(64, 1024);
+	EXPECT_EQ(Buffer.NumSegments(), 1u);
+	void *pFirst = Buffer.Alloc(48);
+	ASSERT_TRUE(pFirst);
+	mem_zero(pFirst, 48);
+
+	// does not fit into the first segment anymore
+	void *pSecond = Buffer.Alloc(48);
+	ASSERT_TRUE(pSecond);
+	mem_zero(pSecond, 48);
+	EXPECT_EQ(Buffer.NumSegments(), 2u);
+	EXPECT_EQ((uintptr_t)pSecond % alignof(std::max_align_t), 0u);
+	EXPECT_GE(Buffer.DataUsed(), 96u);
+	EXPECT_EQ(Buffer.HighWaterMark(), Buffer.DataUsed());
+
+	// additional segments are released on reset
+	Buffer.Reset();
+	EXPECT_EQ(Buffer.NumSegments(), 1u);
+	EXPECT_EQ(Buffer.DataSize(), 64u);
+	EXPECT_EQ(Buffer.DataUsed(), 0u);
+	EXPECT_GE(Buffer.HighWaterMark(), 96u);
+	EXPECT_TRUE(Buffer.Alloc(48));
+	EXPECT_EQ(Buffer.NumSegments(), 1u);
+	EXPECT_TRUE(Buffer.Alloc(48));
+	EXPECT_EQ(Buffer.NumSegments(), 2u);
+}
+
+TEST(CommandBuffer, MaxSize)
+{
+	CCommandBuffer::CBuffer Buffer(64, 256);
+	EXPECT_TRUE(Buffer.Alloc(64));
+	EXPECT_FALSE(Buffer.Alloc(512));
+	EXPECT_TRUE(Buffer.Alloc(128));
+	EXPECT_LE(Buffer.DataSize(), 256u);
+	EXPECT_FALSE(Buffer.Alloc(128));
+}
+
+TEST(CommandBuffer, Commands)
+{
+	CCommandBuffer CommandBuffer(sizeof(CCommandBuffer::SCommand_Clear), 1024);
+	CCommandBuffer::SCommand_Clear Cmd;
+	for(int i = 0; i < 8; i++)
+	{
+		Cmd.m_Color.r = i;
+		EXPECT_TRUE(CommandBuffer.AddCommandUnsafe(Cmd));
+	}
+	EXPECT_EQ(CommandBuffer.m_CommandCount, 8u);
+
+	int Count = 0;
+	for(const CCommandBuffer::SCommand *pCmd = CommandBuffer.Head(); pCmd; pCmd = pCmd->m_pNext)
+	{
+		EXPECT_EQ(pCmd->m_Cmd, CCommandBuffer::CMD_CLEAR);
+		EXPECT_EQ(static_cast<const CCommandBuffer::SCommand_Clear *>(pCmd)->m_Color.r, Count);
+		Count++;
+	}
+	EXPECT_EQ(Count, 8);
+}
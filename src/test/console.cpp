@@ -0,0 +1,46 @@
+#include <gtest/gtest.h>
+
+#include <engine/console.h>
+#include <engine/shared/config.h>
+
+static void CountCallback(IConsole::IResult *pResult, void *pUserData)
+{
+	(*static_cast<int *>(pUserData))++;
+}
+
+TEST(Console, FindCommand)
+{
+	auto pConsole = CreateConsole(CFGFLAG_SERVER);
+	int Count = 0;
+	pConsole->Register("test_command", "", CFGFLAG_SERVER, CountCallback, &Count, "");
+	pConsole->ExecuteLine("test_command");
+	pConsole->ExecuteLine("TEST_Command");
+	pConsole->ExecuteLine("test_command_missing");
+	EXPECT_EQ(Count, 2);
+
+	EXPECT_NE(pConsole->GetCommandInfo("Test_Command", CFGFLAG_SERVER, false), nullptr);
+	EXPECT_EQ(pConsole->GetCommandInfo("test_command", CFGFLAG_CLIENT, false), nullptr);
+	EXPECT_EQ(pConsole->GetCommandInfo("test_command", CFGFLAG_SERVER, true), nullptr);
+}
+
+TEST(Console, TempCommands)
+{
+	auto pConsole = CreateConsole(CFGFLAG_SERVER);
+	pConsole->RegisterTemp("temp_a", "", CFGFLAG_SERVER, "");
+	pConsole->RegisterTemp("temp_b", "", CFGFLAG_SERVER, "");
+	EXPECT_NE(pConsole->GetCommandInfo("temp_a", CFGFLAG_SERVER, true), nullptr);
+	EXPECT_NE(pConsole->GetCommandInfo("TEMP_B", CFGFLAG_SERVER, true), nullptr);
+
+	pConsole->DeregisterTemp("temp_a");
+	EXPECT_EQ(pConsole->GetCommandInfo("temp_a", CFGFLAG_SERVER, true), nullptr);
+	EXPECT_NE(pConsole->GetCommandInfo("temp_b", CFGFLAG_SERVER, true), nullptr);
+
+	// reuses the removed command
+	pConsole->RegisterTemp("temp_c", "", CFGFLAG_SERVER, "");
+	EXPECT_NE(pConsole->GetCommandInfo("temp_c", CFGFLAG_SERVER, true), nullptr);
+
+	pConsole->DeregisterTempAll();
+	EXPECT_EQ(pConsole->GetCommandInfo("temp_b", CFGFLAG_SERVER, true), nullptr);
+	EXPECT_EQ(pConsole->GetCommandInfo("temp_c", CFGFLAG_SERVER, true), nullptr);
+	EXPECT_NE(pConsole->GetCommandInfo("echo", CFGFLAG_SERVER, false), nullptr);
+}
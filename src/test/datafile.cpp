@@ -1,11 +1,15 @@
 #include "test.h"
 #include <gtest/gtest.h>
 #include <memory>
+#include <vector>
 
+#include <base/system.h>
 #include <engine/shared/datafile.h>
 #include <engine/storage.h>
 #include <game/mapitems_ex.h>
 
+#include <zlib.h>
+
 TEST(Datafile, ExtendedType)
 {
 	auto pStorage = std::unique_ptr<IStorage>(CreateLocalStorage());
@@ -105,3 +109,84 @@ TEST(Datafile, StringData)
 		pStorage->RemoveFile(Info.m_aFilename, IStorage::TYPE_SAVE);
 	}
 }
+
+TEST(Datafile, LargeData)
+{
+	auto pStorage = std::unique_ptr<IStorage>(CreateLocalStorage());
+	CTestInfo Info;
+
+	// tile-like data that compresses well, split into several chunks
+	unsigned Seed = 1;
+	std::vector<std::vector<int>> vvData;
+	for(size_t Size : {(size_t)3 * 1024 * 1024 + 12, (size_t)1024 * 1024, (size_t)100, (size_t)2 * 1024 * 1024 + 4})
+	{
+		std::vector<int> vData(Size / sizeof(int));
+		for(int &Value : vData)
+		{
+			Seed = Seed * 1103515245 + 12345;
+			Value = (Seed >> 16) % 8 == 0 ? (Seed >> 8) % 256 : 0;
+		}
+		vvData.push_back(std::move(vData));
+	}
+	const CDataFileWriter::ECompressionLevel aLevels[] = {CDataFileWriter::COMPRESSION_DEFAULT, CDataFileWriter::COMPRESSION_BEST, CDataFileWriter::COMPRESSION_FAST, CDataFileWriter::COMPRESSION_DEFAULT};
+	const int aZlibLevels[] = {Z_DEFAULT_COMPRESSION, Z_BEST_COMPRESSION, Z_BEST_SPEED, Z_DEFAULT_COMPRESSION};
+
+	{
+		CDataFileWriter Writer;
+		Writer.Open(pStorage.get(), Info.m_aFilename);
+		for(size_t i = 0; i < vvData.size(); i++)
+			EXPECT_EQ(Writer.AddData(vvData[i].size() * sizeof(int), vvData[i].data(), aLevels[i]), (int)i);
+		Writer.Finish();
+	}
+
+	{
+		CDataFileReader Reader;
+		ASSERT_TRUE(Reader.Open(pStorage.get(), Info.m_aFilename, IStorage::TYPE_ALL));
+		ASSERT_EQ(Reader.NumData(), (int)vvData.size());
+		for(size_t i = 0; i < vvData.size(); i++)
+		{
+			ASSERT_EQ(Reader.GetDataSize(i), (int)(vvData[i].size() * sizeof(int)));
+			EXPECT_EQ(mem_comp(Reader.GetData(i), vvData[i].data(), vvData[i].size() * sizeof(int)), 0) << i;
+		}
+
+		// joining independently compressed chunks costs almost nothing
+		unsigned long SerialSize = 0;
+		for(size_t i = 0; i < vvData.size(); i++)
+		{
+			unsigned long CompressedSize = compressBound(vvData[i].size() * sizeof(int));
+			std::vector<Bytef> vCompressed(CompressedSize);
+			EXPECT_EQ(compress2(vCompressed.data(), &CompressedSize, (const Bytef *)vvData[i].data(), vvData[i].size() * sizeof(int), aZlibLevels[i]), Z_OK);
+			SerialSize += CompressedSize;
+		}
+		EXPECT_LT(Reader.MapSize(), (int)(SerialSize * 1.01));
+		Reader.Close();
+	}
+
+	// the output does not depend on the number of compression threads
+	char aSingleFilename[IO_MAX_PATH_LENGTH];
+	str_format(aSingleFilename, sizeof(aSingleFilename), "%s.single", Info.m_aFilename);
+	{
+		CDataFileWriter Writer;
+		Writer.SetMaxCompressionThreads(1);
+		Writer.Open(pStorage.get(), aSingleFilename);
+		for(size_t i = 0; i < vvData.size(); i++)
+			Writer.AddData(vvData[i].size() * sizeof(int), vvData[i].data(), aLevels[i]);
+		Writer.Finish();
+	}
+	{
+		void *pParallel, *pSingle;
+		unsigned ParallelSize, SingleSize;
+		ASSERT_TRUE(pStorage->ReadFile(Info.m_aFilename, IStorage::TYPE_SAVE, &pParallel, &ParallelSize));
+		ASSERT_TRUE(pStorage->ReadFile(aSingleFilename, IStorage::TYPE_SAVE, &pSingle, &SingleSize));
+		ASSERT_EQ(ParallelSize, SingleSize);
+		EXPECT_EQ(mem_comp(pParallel, pSingle, ParallelSize), 0);
+		free(pParallel);
+		free(pSingle);
+	}
+
+	if(!HasFailure())
+	{
+		pStorage->RemoveFile(Info.m_aFilename, IStorage::TYPE_SAVE);
+		pStorage->RemoveFile(aSingleFilename, IStorage::TYPE_SAVE);
+	}
+}
@@ -0,0 +1,81 @@
+#include <gtest/gtest.h>
+
+#include <game/editor/tile_changes.h>
+#include <game/mapitems.h>
+
+#include <tuple>
+#include <vector>
+
+// same layout as STileStateChange, which needs the whole editor
+struct STestChange
+{
+	bool m_Changed;
+	CTile m_Previous;
+	CTile m_Current;
+};
+
+static std::vector<std::tuple<int, int, int, int>> Flatten(const EditorTileStateChangeHistory<STestChange> &Changes)
+{
+	std::vector<std::tuple<int, int, int, int>> vResult;
+	for(const auto &[y, Line] : Changes)
+		for(const auto &[x, Change] : Line)
+			vResult.emplace_back(x, y, Change.m_Previous.m_Index, Change.m_Current.m_Flags);
+	return vResult;
+}
+
+static void RoundTrip(int Width, int Height, int Percent, unsigned Seed)
+{
+	auto Random = [&Seed]() {
+		Seed = Seed * 1103515245 + 12345;
+		return Seed >> 8;
+	};
+
+	EditorTileStateChangeHistory<STestChange> Changes;
+	int NumChanges = 0;
+	for(int y = 0; y < Height; y++)
+	{
+		for(int x = 0; x < Width; x++)
+		{
+			if((int)(Random() % 100) >= Percent)
+				continue;
+			STestChange Change = {true, {(unsigned char)Random(), 0, 0, 0}, {0, (unsigned char)Random(), 0, 0}};
+			Changes[y][x] = Change;
+			NumChanges++;
+		}
+	}
+
+	CCompressedTileChanges<STestChange> Compressed(Changes);
+	EXPECT_EQ(Compressed.NumChanges(), NumChanges);
+	EXPECT_EQ(Compressed.Empty(), NumChanges == 0);
+
+	std::vector<std::tuple<int, int, int, int>> vActual;
+	Compressed.ForEach([&](int x, int y, const STestChange &Change) {
+		EXPECT_TRUE(Change.m_Changed);
+		vActual.emplace_back(x, y, Change.m_Previous.m_Index, Change.m_Current.m_Flags);
+	});
+	EXPECT_EQ(vActual, Flatten(Changes));
+}
+
+TEST(EditorTileChanges, Empty)
+{
+	CCompressedTileChanges<STestChange> Compressed(EditorTileStateChangeHistory<STestChange>{});
+	EXPECT_TRUE(Compressed.Empty());
+	EXPECT_EQ(Compressed.NumChanges(), 0);
+	int Calls = 0;
+	Compressed.ForEach([&](int, int, const STestChange &) { Calls++; });
+	EXPECT_EQ(Calls, 0);
+}
+
+TEST(EditorTileChanges, Sparse)
+{
+	for(unsigned Seed = 1; Seed <= 10; Seed++)
+		RoundTrip(200, 100, 2, Seed);
+}
+
+TEST(EditorTileChanges, Dense)
+{
+	for(unsigned Seed = 1; Seed <= 10; Seed++)
+		RoundTrip(200, 100, 90, Seed);
+	// a full fill is a single run per row
+	RoundTrip(300, 300, 100, 1);
+}
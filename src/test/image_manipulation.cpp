@@ -0,0 +1,254 @@
+#include <gtest/gtest.h>
+
+#include <base/math.h>
+#include <base/system.h>
+#include <engine/gfx/image_loader.h>
+#include <engine/gfx/image_manipulation.h>
+#include <engine/storage.h>
+
+#include <cmath>
+#include <memory>
+#include <vector>
+
+// the straightforward per-pixel implementations the optimized ones must match
+
+static void RefConvertToRgba(uint8_t *pDest, const CImageInfo &SourceImage)
+{
+	const size_t SrcChannelCount = CImageInfo::PixelSize(SourceImage.m_Format);
+	for(size_t i = 0; i < SourceImage.m_Width * SourceImage.m_Height; ++i)
+	{
+		const uint8_t *pSrc = &SourceImage.m_pData[i * SrcChannelCount];
+		uint8_t *pDst = &pDest[i * 4];
+		if(SourceImage.m_Format == CImageInfo::FORMAT_RGB)
+		{
+			mem_copy(pDst, pSrc, 3);
+			pDst[3] = 255;
+		}
+		else if(SourceImage.m_Format == CImageInfo::FORMAT_RA)
+		{
+			pDst[0] = pDst[1] = pDst[2] = pSrc[0];
+			pDst[3] = pSrc[1];
+		}
+		else
+		{
+			pDst[0] = pDst[1] = pDst[2] = 255;
+			pDst[3] = pSrc[0];
+		}
+	}
+}
+
+static void RefDilate(int w, int h, const uint8_t *pSrc, uint8_t *pDest)
+{
+	const int aDirX[] = {0, -1, 1, 0};
+	const int aDirY[] = {-1, 0, 0, 1};
+	for(int y = 0; y < h; y++)
+	{
+		for(int x = 0; x < w; x++)
+		{
+			const int m = (y * w + x) * 4;
+			mem_copy(&pDest[m], &pSrc[m], 4);
+			if(pSrc[m + 3] > 10)
+				continue;
+			for(int c = 0; c < 4; c++)
+			{
+				const int SrcIndex = (clamp(y + aDirY[c], 0, h - 1) * w + clamp(x + aDirX[c], 0, w - 1)) * 4;
+				if(pSrc[SrcIndex + 3] > 10)
+				{
+					mem_copy(&pDest[m], &pSrc[SrcIndex], 3);
+					pDest[m + 3] = 255;
+					break;
+				}
+			}
+		}
+	}
+}
+
+static void RefDilateImage(uint8_t *pImage, int w, int h)
+{
+	const size_t Size = (size_t)w * h * 4;
+	std::vector<uint8_t> vBuffer0(Size), vBuffer1(Size);
+	RefDilate(w, h, pImage, vBuffer0.data());
+	for(int i = 0; i < 5; i++)
+	{
+		RefDilate(w, h, vBuffer0.data(), vBuffer1.data());
+		RefDilate(w, h, vBuffer1.data(), vBuffer0.data());
+	}
+	for(size_t m = 0; m < Size; m += 4)
+	{
+		if(pImage[m + 3] == 0)
+			mem_copy(&pImage[m], &vBuffer0[m], 3);
+	}
+}
+
+static float RefCubicHermite(float A, float B, float C, float D, float t)
+{
+	float a = -A / 2.0f + (3.0f * B) / 2.0f - (3.0f * C) / 2.0f + D / 2.0f;
+	float b = A - (5.0f * B) / 2.0f + 2.0f * C - D / 2.0f;
+	float c = -A / 2.0f + C / 2.0f;
+	float d = B;
+	return (a * t * t * t) + (b * t * t) + (c * t) + d;
+}
+
+static void RefResizeImage(const uint8_t *pSrc, int SW, int SH, uint8_t *pDest, int W, int H, int BPP)
+{
+	for(int y = 0; y < H; ++y)
+	{
+		float Y = ((float)y / (float)(H - 1) * SH) - 0.5f;
+		int yInt = (int)Y;
+		float yFract = Y - std::floor(Y);
+		for(int x = 0; x < W; ++x)
+		{
+			float X = ((float)x / (float)(W - 1) * SW) - 0.5f;
+			int xInt = (int)X;
+			float xFract = X - std::floor(X);
+			for(int i = 0; i < BPP; i++)
+			{
+				float aRows[4];
+				for(int r = 0; r < 4; ++r)
+				{
+					float aColumns[4];
+					for(int c = 0; c < 4; ++c)
+						aColumns[c] = pSrc[(clamp(yInt + r - 1, 0, SH - 1) * SW + clamp(xInt + c - 1, 0, SW - 1)) * BPP + i];
+					aRows[r] = RefCubicHermite(aColumns[0], aColumns[1], aColumns[2], aColumns[3], xFract);
+				}
+				pDest[(y * W + x) * BPP + i] = (uint8_t)clamp<float>(RefCubicHermite(aRows[0], aRows[1], aRows[2], aRows[3], yFract), 0.0f, 255.0f);
+			}
+		}
+	}
+}
+
+static std::vector<uint8_t> RandomImage(int w, int h, int BPP, unsigned &Seed, int TransparentPercent = -1)
+{
+	std::vector<uint8_t> vData((size_t)w * h * BPP);
+	for(size_t i = 0; i < vData.size(); i++)
+	{
+		Seed = Seed * 1103515245 + 12345;
+		vData[i] = Seed >> 16;
+		// mostly transparent images with a few opaque spots to dilate
+		if(TransparentPercent >= 0 && i % BPP == (size_t)BPP - 1)
+			vData[i] = (int)((Seed >> 8) % 100) < TransparentPercent ? (Seed >> 24) % 11 : 255;
+	}
+	return vData;
+}
+
+TEST(ImageManipulation, ConvertToRgba)
+{
+	unsigned Seed = 1;
+	const CImageInfo::EImageFormat aFormats[] = {CImageInfo::FORMAT_RGB, CImageInfo::FORMAT_RA, CImageInfo::FORMAT_R};
+	for(auto Format : aFormats)
+	{
+		std::vector<uint8_t> vData = RandomImage(37, 11, CImageInfo::PixelSize(Format), Seed);
+		CImageInfo Image;
+		Image.m_Width = 37;
+		Image.m_Height = 11;
+		Image.m_Format = Format;
+		Image.m_pData = vData.data();
+
+		std::vector<uint8_t> vExpected(37 * 11 * 4), vActual(37 * 11 * 4);
+		RefConvertToRgba(vExpected.data(), Image);
+		EXPECT_FALSE(ConvertToRgba(vActual.data(), Image));
+		EXPECT_EQ(vActual, vExpected) << Image.FormatName();
+	}
+}
+
+TEST(ImageManipulation, ConvertToGrayscale)
+{
+	unsigned Seed = 2;
+	for(int BPP = 3; BPP <= 4; BPP++)
+	{
+		std::vector<uint8_t> vData = RandomImage(13, 7, BPP, Seed);
+		std::vector<uint8_t> vExpected = vData;
+		for(size_t i = 0; i < vExpected.size(); i += BPP)
+		{
+			const uint8_t Average = (vExpected[i] + vExpected[i + 1] + vExpected[i + 2]) / 3;
+			vExpected[i] = vExpected[i + 1] = vExpected[i + 2] = Average;
+		}
+
+		CImageInfo Image;
+		Image.m_Width = 13;
+		Image.m_Height = 7;
+		Image.m_Format = BPP == 3 ? CImageInfo::FORMAT_RGB : CImageInfo::FORMAT_RGBA;
+		Image.m_pData = vData.data();
+		ConvertToGrayscale(Image);
+		EXPECT_EQ(vData, vExpected);
+	}
+}
+
+TEST(ImageManipulation, Dilate)
+{
+	unsigned Seed = 3;
+	const int aSizes[][2] = {{1, 1}, {1, 9}, {9, 1}, {64, 64}, {97, 31}};
+	const int aTransparentPercents[] = {0, 50, 97, 100};
+	for(const auto &Size : aSizes)
+	{
+		for(int TransparentPercent : aTransparentPercents)
+		{
+			std::vector<uint8_t> vActual = RandomImage(Size[0], Size[1], 4, Seed, TransparentPercent);
+			std::vector<uint8_t> vExpected = vActual;
+			RefDilateImage(vExpected.data(), Size[0], Size[1]);
+			DilateImage(vActual.data(), Size[0], Size[1]);
+			EXPECT_EQ(vActual, vExpected) << Size[0] << "x" << Size[1] << " " << TransparentPercent << "%";
+		}
+	}
+
+	// only the given part is dilated, as if it was a separate image
+	std::vector<uint8_t> vActual = RandomImage(40, 30, 4, Seed, 90);
+	std::vector<uint8_t> vExpected = vActual;
+	std::vector<uint8_t> vSub(16 * 12 * 4);
+	for(int y = 0; y < 12; y++)
+		mem_copy(&vSub[y * 16 * 4], &vExpected[((y + 8) * 40 + 4) * 4], 16 * 4);
+	RefDilateImage(vSub.data(), 16, 12);
+	for(int y = 0; y < 12; y++)
+		mem_copy(&vExpected[((y + 8) * 40 + 4) * 4], &vSub[y * 16 * 4], 16 * 4);
+	DilateImageSub(vActual.data(), 40, 30, 4, 8, 16, 12);
+	EXPECT_EQ(vActual, vExpected);
+}
+
+TEST(ImageManipulation, Resize)
+{
+	unsigned Seed = 4;
+	const int aSizes[][4] = {{16, 16, 16, 16}, {64, 32, 16, 8}, {7, 5, 31, 17}, {100, 3, 33, 9}, {2, 2, 5, 5}};
+	for(const auto &Size : aSizes)
+	{
+		for(int BPP : {1, 3, 4})
+		{
+			std::vector<uint8_t> vSource = RandomImage(Size[0], Size[1], BPP, Seed);
+			std::vector<uint8_t> vExpected((size_t)Size[2] * Size[3] * BPP);
+			RefResizeImage(vSource.data(), Size[0], Size[1], vExpected.data(), Size[2], Size[3], BPP);
+			uint8_t *pActual = ResizeImage(vSource.data(), Size[0], Size[1], Size[2], Size[3], BPP);
+			EXPECT_EQ(std::vector<uint8_t>(pActual, pActual + vExpected.size()), vExpected) << Size[0] << "x" << Size[1] << " -> " << Size[2] << "x" << Size[3] << " bpp=" << BPP;
+			free(pActual);
+		}
+	}
+}
+
+TEST(ImageManipulation, MatchesReferenceOnMapres)
+{
+	auto pStorage = std::unique_ptr<IStorage>(CreateLocalStorage());
+	ASSERT_TRUE(pStorage);
+	const char *apImages[] = {"data/mapres/grass_main.png", "data/mapres/jungle_doodads.png", "data/mapres/desert_mountains.png"};
+	for(const char *pImage : apImages)
+	{
+		CImageInfo Image;
+		int PngliteIncompatible;
+		if(!CImageLoader::LoadPng(pStorage->OpenFile(pImage, IOFLAG_READ, IStorage::TYPE_ALL), pImage, Image, PngliteIncompatible))
+			continue;
+		ConvertToRgba(Image);
+		const int w = Image.m_Width;
+		const int h = Image.m_Height;
+
+		std::vector<uint8_t> vExpected(Image.m_pData, Image.m_pData + Image.DataSize());
+		std::vector<uint8_t> vActual = vExpected;
+		RefDilateImage(vExpected.data(), w, h);
+		DilateImage(vActual.data(), w, h);
+		EXPECT_EQ(vActual, vExpected) << pImage;
+
+		std::vector<uint8_t> vResized((size_t)w / 2 * h / 2 * 4);
+		RefResizeImage(Image.m_pData, w, h, vResized.data(), w / 2, h / 2, 4);
+		uint8_t *pResized = ResizeImage(Image.m_pData, w, h, w / 2, h / 2, 4);
+		EXPECT_EQ(mem_comp(pResized, vResized.data(), vResized.size()), 0) << pImage;
+		free(pResized);
+
+		Image.Free();
+	}
+}
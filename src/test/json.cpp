@@ -1,7 +1,12 @@
 #include <gtest/gtest.h>
 
+#include <base/system.h>
+
 #include <engine/shared/json.h>
 
+#include <string>
+#include <vector>
+
 TEST(Json, Escape)
 {
 	char aBuf[128];
@@ -20,3 +25,103 @@ TEST(Json, Escape)
 	EXPECT_STREQ(EscapeJson(aSix, sizeof(aSix), "\x01"), "");
 	EXPECT_STREQ(EscapeJson(aSix, sizeof(aSix), "aaaaaa"), "aaaaa");
 }
+
+TEST(Json, ParseArrayElements)
+{
+	const char *pJson = "{\"a\": {\"x\": [1, \"]}\"]}, \"servers\": [{\"n\": 1}, {\"n\": 2}], \"b\": \"\\\"}\"}";
+	std::vector<int> vValues;
+	const auto &&Collect = [&](const json_value &Element) {
+		vValues.push_back(json_int_get(&Element["n"]));
+		return true;
+	};
+	EXPECT_TRUE(JsonParseArrayElements(pJson, str_length(pJson), "servers", Collect));
+	ASSERT_EQ(vValues.size(), 2u);
+	EXPECT_EQ(vValues[0], 1);
+	EXPECT_EQ(vValues[1], 2);
+
+	vValues.clear();
+	const char *pEmpty = " { \"servers\" : [ ] } ";
+	EXPECT_TRUE(JsonParseArrayElements(pEmpty, str_length(pEmpty), "servers", Collect));
+	EXPECT_TRUE(vValues.empty());
+
+	// values of other keys are validated while skipping them
+	const char *pScalars = "{\"b\": -0.5e+3, \"c\": [true, false, null, 0, {\"d\": 1E-2}], \"servers\": []}";
+	EXPECT_TRUE(JsonParseArrayElements(pScalars, str_length(pScalars), "servers", Collect));
+
+	EXPECT_FALSE(JsonParseArrayElements(pJson, str_length(pJson), "missing", Collect));
+	EXPECT_FALSE(JsonParseArrayElements(pJson, str_length(pJson) - 1, "servers", Collect));
+	EXPECT_FALSE(JsonParseArrayElements(pJson, str_length(pJson), "servers", [](const json_value &) { return false; }));
+
+	const char *apMalformed[] = {
+		"",
+		"[]",
+		"{}",
+		"{\"servers\": [{\"n\": 1}",
+		"{\"servers\": [{\"n\": 1]}",
+		"{\"servers\": [{\"n\": }]}",
+		"{\"servers\": []} x",
+		"{\"servers\": [], \"b\": [}",
+		"{\"servers\": [], \"b\": tru}",
+		"{\"servers\": [], \"b\": nulll}",
+		"{\"servers\": [], \"b\": 01}",
+		"{\"servers\": [], \"b\": 1.}",
+		"{\"servers\": [], \"b\": -}",
+		"{\"servers\": [], \"b\": 1e}",
+		"{\"servers\": [], \"b\": abc}",
+		"{\"servers\": [], \"b\": [1 2]}",
+		"{\"servers\": [], \"b\": {\"c\" 1}}",
+		"{\"servers\": [], \"b\": {1: 2}}",
+	};
+	for(const char *pMalformed : apMalformed)
+	{
+		EXPECT_FALSE(JsonParseArrayElements(pMalformed, str_length(pMalformed), "servers", Collect)) << pMalformed;
+	}
+}
+
+TEST(Json, ParseArrayElementsMatchesTree)
+{
+	// roughly the shape of a server list from the master server
+	std::string Json = "{\"version\": 1.5e2, \"servers\": [";
+	for(int i = 0; i < 200; i++)
+	{
+		char aServer[256];
+		str_format(aServer, sizeof(aServer), "%s{\"addresses\": [\"tw-0.6+udp://1.2.3.4:%d\"], \"location\": %s, \"info\": {\"name\": \"Server \\\"%d\\\"\", \"passworded\": %s, \"clients\": [",
+			i == 0 ? "" : ", ", 8303 + i, i % 3 == 0 ? "null" : "\"eu:de\"", i, i % 2 ? "true" : "false");
+		Json += aServer;
+		for(int c = 0; c < i % 5; c++)
+		{
+			str_format(aServer, sizeof(aServer), "%s{\"name\": \"player %d\", \"country\": -1, \"score\": %d, \"afk\": %s}", c == 0 ? "" : ", ", c, (i - 100) * c, c % 2 ? "true" : "false");
+			Json += aServer;
+		}
+		Json += "]}}";
+	}
+	Json += "], \"communities\": [{\"id\": \"ddnet\", \"ratio\": -0.25}]}";
+
+	const auto &&Describe = [](const json_value &Server) {
+		const json_value &Info = Server["info"];
+		std::string Description = json_string_get(&Info["name"]);
+		Description += json_string_get(&Server["addresses"][0]);
+		Description += Server["location"].type == json_null ? "null" : json_string_get(&Server["location"]);
+		Description += json_boolean_get(&Info["passworded"]) ? "p" : "";
+		const json_value &Clients = Info["clients"];
+		for(int c = 0; c < json_array_length(&Clients); c++)
+			Description += " " + std::to_string(json_int_get(&Clients[c]["score"]));
+		return Description;
+	};
+
+	json_value *pTree = json_parse(Json.c_str(), Json.size());
+	ASSERT_TRUE(pTree);
+	std::vector<std::string> vExpected;
+	const json_value &Servers = (*pTree)["servers"];
+	for(int i = 0; i < json_array_length(&Servers); i++)
+		vExpected.push_back(Describe(Servers[i]));
+	json_value_free(pTree);
+
+	std::vector<std::string> vActual;
+	EXPECT_TRUE(JsonParseArrayElements(Json.c_str(), Json.size(), "servers", [&](const json_value &Server) {
+		vActual.push_back(Describe(Server));
+		return true;
+	}));
+	EXPECT_EQ(vExpected.size(), 200u);
+	EXPECT_EQ(vActual, vExpected);
+}
@@ -1,7 +1,11 @@
 #include <gtest/gtest.h>
 
+#include <base/system.h>
+
 #include <engine/server/name_ban.h>
 
+#include <algorithm>
+
 TEST(NameBan, Empty)
 {
 	CNameBans Bans;
@@ -78,3 +82,87 @@ TEST(NameBan, UnbanNotFound)
 	CNameBans Bans;
 	Bans.Unban("abc");
 }
+
+TEST(NameBan, SubstringOverlap)
+{
+	CNameBans Bans;
+	Bans.Ban("abce", "", 0, true);
+	Bans.Ban("bcd", "", 0, true);
+	Bans.Ban("XyZ", "", 0, true);
+	EXPECT_TRUE(Bans.IsBanned("abcd"));
+	EXPECT_TRUE(Bans.IsBanned("aabcabce"));
+	EXPECT_TRUE(Bans.IsBanned("fooxYzbar"));
+	EXPECT_FALSE(Bans.IsBanned("abcabc"));
+}
+
+TEST(NameBan, LastBanWins)
+{
+	CNameBans Bans;
+	Bans.Ban("abc", "first", 1, false);
+	Bans.Ban("abd", "second", 1, false);
+	Bans.Ban("zzz", "third", 0, true);
+	const CNameBan *pBan = Bans.IsBanned("abc");
+	ASSERT_TRUE(pBan);
+	EXPECT_STREQ(pBan->m_aReason, "second");
+	pBan = Bans.IsBanned("abczzz");
+	ASSERT_TRUE(pBan);
+	EXPECT_STREQ(pBan->m_aReason, "third");
+	Bans.Unban("abd");
+	pBan = Bans.IsBanned("abc");
+	ASSERT_TRUE(pBan);
+	EXPECT_STREQ(pBan->m_aReason, "first");
+}
+
+TEST(NameBan, ManyBans)
+{
+	// compare against checking every ban
+	CNameBans Bans;
+	std::vector<CNameBan> vReference;
+	unsigned Seed = 1;
+	auto Random = [&Seed](int Max) {
+		Seed = Seed * 1103515245 + 12345;
+		return (int)((Seed >> 16) % Max);
+	};
+	auto RandomName = [&Random](char *pBuf, int Length) {
+		for(int i = 0; i < Length; i++)
+			pBuf[i] = "abcdeABO0l1"[Random(11)];
+		pBuf[Length] = '\0';
+	};
+	for(int i = 0; i < 500; i++)
+	{
+		char aName[16];
+		RandomName(aName, 2 + Random(8));
+		const int Distance = Random(4) - 1;
+		const bool IsSubstring = Random(8) == 0;
+		char aReason[16];
+		str_format(aReason, sizeof(aReason), "%d", i);
+		Bans.Ban(aName, aReason, Distance, IsSubstring);
+		auto Existing = std::find_if(vReference.begin(), vReference.end(), [&](const CNameBan &Ban) { return str_comp(Ban.m_aName, aName) == 0; });
+		if(Existing != vReference.end())
+			*Existing = CNameBan(aName, aReason, Distance, IsSubstring);
+		else
+			vReference.emplace_back(aName, aReason, Distance, IsSubstring);
+	}
+
+	for(int i = 0; i < 500; i++)
+	{
+		char aName[16];
+		RandomName(aName, 1 + Random(12));
+		int aSkeleton[MAX_NAME_SKELETON_LENGTH];
+		const int SkeletonLength = str_utf8_to_skeleton(aName, aSkeleton, std::size(aSkeleton));
+		int aBuffer[MAX_NAME_SKELETON_LENGTH * 2 + 2];
+		const CNameBan *pExpected = nullptr;
+		for(const CNameBan &Ban : vReference)
+		{
+			const int Distance = str_utf32_dist_buffer(aSkeleton, SkeletonLength, Ban.m_aSkeleton, Ban.m_SkeletonLength, aBuffer, std::size(aBuffer));
+			if(Distance <= Ban.m_Distance || (Ban.m_IsSubstring && str_utf8_find_nocase(aName, Ban.m_aName)))
+				pExpected = &Ban;
+		}
+		const CNameBan *pBan = Bans.IsBanned(aName);
+		ASSERT_EQ(pBan != nullptr, pExpected != nullptr) << aName;
+		if(pBan)
+		{
+			EXPECT_STREQ(pBan->m_aReason, pExpected->m_aReason) << aName;
+		}
+	}
+}
@@ -48,3 +48,50 @@ TEST(Net, Ipv4AndIpv6Work)
 	net_udp_close(Socket1);
 	net_udp_close(Socket2);
 }
+
+TEST(Net, Wait)
+{
+	NETADDR Bindaddr = {};
+	NETSOCKET Socket1;
+	NETSOCKET Socket2;
+
+	Bindaddr.type = NETTYPE_IPV4;
+	Socket2 = net_udp_create(Bindaddr);
+	do
+	{
+		Bindaddr.port = secure_rand() % 64511 + 1024;
+	} while(!(Socket1 = net_udp_create(Bindaddr)));
+
+	NETADDR Target;
+	ASSERT_FALSE(net_addr_from_str(&Target, "127.0.0.1"));
+	Target.port = Bindaddr.port;
+
+	NETWAIT *pWait = net_wait_create();
+
+	// nothing to read, wait until the deadline
+	const int64_t Deadline = time_get_impl() + time_freq() / 50;
+	net_wait_add_socket(pWait, Socket1);
+	EXPECT_EQ(net_wait(pWait, Deadline), 0);
+	EXPECT_GE(time_get_impl(), Deadline);
+
+	// deadline in the past only polls
+	net_wait_add_socket(pWait, Socket1);
+	EXPECT_EQ(net_wait(pWait, 0), 0);
+
+	EXPECT_EQ(net_udp_send(Socket2, &Target, "abc", 3), 3);
+	net_wait_add_socket(pWait, Socket1);
+	EXPECT_EQ(net_wait(pWait, time_get_impl() + time_freq() * 10), 1);
+
+	// sockets that aren't added again are not waited for
+	net_wait_add_socket(pWait, Socket2);
+	EXPECT_EQ(net_wait(pWait, 0), 0);
+
+	NETADDR Addr;
+	unsigned char *pData;
+	ASSERT_EQ(net_udp_recv(Socket1, &Addr, &pData), 3);
+	EXPECT_EQ(mem_comp(pData, "abc", 3), 0);
+
+	net_wait_free(pWait);
+	net_udp_close(Socket1);
+	net_udp_close(Socket2);
+}
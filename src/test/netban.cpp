@@ -0,0 +1,235 @@
+#include <gtest/gtest.h>
+
+#include <base/system.h>
+#include <engine/console.h>
+#include <engine/shared/config.h>
+#include <engine/shared/linereader.h>
+#include <engine/shared/netban.h>
+
+#include <string>
+#include <vector>
+
+class CTestNetBan : public CNetBan
+{
+public:
+	int NumTrieNodes() const { return m_BanRangePool.Trie().NumNodes(); }
+	bool MatchesRange(const CNetRange *pRange, const NETADDR *pAddr) const { return NetMatch(pRange, pAddr); }
+};
+
+static NETADDR Addr(const char *pStr)
+{
+	NETADDR Addr;
+	EXPECT_EQ(net_addr_from_str(&Addr, pStr), 0) << pStr;
+	return Addr;
+}
+
+static bool AddrEqual(const NETADDR &Address, const char *pStr)
+{
+	NETADDR Expected = Addr(pStr);
+	return NetComp(&Address, &Expected) == 0;
+}
+
+static bool Banned(const CNetBan &NetBan, const char *pStr)
+{
+	NETADDR Address = Addr(pStr);
+	char aBuf[256];
+	return NetBan.IsBanned(&Address, aBuf, sizeof(aBuf));
+}
+
+static int Import(CNetBan &NetBan, const char *pList)
+{
+	const int Size = str_length(pList) + 1;
+	char *pBuffer = static_cast<char *>(malloc(Size));
+	str_copy(pBuffer, pList, Size);
+	CLineReader LineReader;
+	LineReader.OpenBuffer(pBuffer);
+	return NetBan.ImportBans(&LineReader, 0, "test");
+}
+
+TEST(NetBan, RangeFromStr)
+{
+	CNetRange Range;
+	ASSERT_TRUE(CNetBan::NetRangeFromStr(&Range, "10.1.2.3/8"));
+	EXPECT_TRUE(AddrEqual(Range.m_LB, "10.0.0.0"));
+	EXPECT_TRUE(AddrEqual(Range.m_UB, "10.255.255.255"));
+
+	ASSERT_TRUE(CNetBan::NetRangeFromStr(&Range, "2001:db8::/33"));
+	EXPECT_TRUE(AddrEqual(Range.m_LB, "[2001:db8::]"));
+	EXPECT_TRUE(AddrEqual(Range.m_UB, "[2001:db8:7fff:ffff:ffff:ffff:ffff:ffff]"));
+
+	ASSERT_TRUE(CNetBan::NetRangeFromStr(&Range, " 1.2.3.4 - 1.2.3.10 "));
+	EXPECT_TRUE(AddrEqual(Range.m_LB, "1.2.3.4"));
+	EXPECT_TRUE(AddrEqual(Range.m_UB, "1.2.3.10"));
+
+	ASSERT_TRUE(CNetBan::NetRangeFromStr(&Range, "1.2.3.4"));
+	EXPECT_EQ(NetComp(&Range.m_LB, &Range.m_UB), 0);
+
+	EXPECT_FALSE(CNetBan::NetRangeFromStr(&Range, "1.2.3.4/33"));
+	EXPECT_FALSE(CNetBan::NetRangeFromStr(&Range, "1.2.3.4/"));
+	EXPECT_FALSE(CNetBan::NetRangeFromStr(&Range, "1.2.3.10 - 1.2.3.4"));
+	EXPECT_FALSE(CNetBan::NetRangeFromStr(&Range, "1.2.3.4 - ::1"));
+	EXPECT_FALSE(CNetBan::NetRangeFromStr(&Range, "example.com"));
+}
+
+TEST(NetBan, Ranges)
+{
+	auto pConsole = CreateConsole(CFGFLAG_SERVER);
+	CTestNetBan NetBan;
+	NetBan.Init(pConsole.get(), nullptr);
+
+	CNetRange Range;
+	ASSERT_TRUE(CNetBan::NetRangeFromStr(&Range, "1.2.3.5 - 1.2.4.1"));
+	EXPECT_EQ(NetBan.BanRange(&Range, 0, "test"), 0);
+	CNetRange Prefix;
+	ASSERT_TRUE(CNetBan::NetRangeFromStr(&Prefix, "2001:db8::/32"));
+	EXPECT_EQ(NetBan.BanRange(&Prefix, 0, "test"), 0);
+
+	EXPECT_FALSE(Banned(NetBan, "1.2.3.4"));
+	EXPECT_TRUE(Banned(NetBan, "1.2.3.5"));
+	EXPECT_TRUE(Banned(NetBan, "1.2.3.255"));
+	EXPECT_TRUE(Banned(NetBan, "1.2.4.1"));
+	EXPECT_FALSE(Banned(NetBan, "1.2.4.2"));
+	EXPECT_TRUE(Banned(NetBan, "[2001:db8:1234::1]:8303"));
+	EXPECT_FALSE(Banned(NetBan, "[2001:db9::1]"));
+
+	EXPECT_EQ(NetBan.UnbanByRange(&Range), 0);
+	EXPECT_FALSE(Banned(NetBan, "1.2.3.5"));
+	EXPECT_TRUE(Banned(NetBan, "[2001:db8::]"));
+	NetBan.UnbanAll();
+	EXPECT_FALSE(Banned(NetBan, "[2001:db8::]"));
+	EXPECT_EQ(NetBan.NumTrieNodes(), 2);
+}
+
+TEST(NetBan, RandomRanges)
+{
+	auto pConsole = CreateConsole(CFGFLAG_SERVER);
+	CTestNetBan NetBan;
+	NetBan.Init(pConsole.get(), nullptr);
+
+	unsigned Seed = 1;
+	auto Random = [&Seed]() {
+		Seed = Seed * 1103515245 + 12345;
+		return Seed >> 8;
+	};
+	// keep everything in a small part of the address space so ranges overlap
+	auto RandomAddr = [&](NETADDR *pAddr) {
+		*pAddr = Addr("10.0.0.0");
+		const unsigned Value = Random() % 0x10000;
+		pAddr->ip[2] = Value >> 8;
+		pAddr->ip[3] = Value & 0xff;
+	};
+
+	std::vector<CNetRange> vRanges;
+	for(int i = 0; i < 300; i++)
+	{
+		CNetRange Range;
+		RandomAddr(&Range.m_LB);
+		RandomAddr(&Range.m_UB);
+		if(NetComp(&Range.m_LB, &Range.m_UB) > 0)
+			std::swap(Range.m_LB, Range.m_UB);
+		if(Range.IsValid() && NetBan.BanRange(&Range, 0, "test") == 0)
+			vRanges.push_back(Range);
+	}
+
+	for(int Pass = 0; Pass < 2; Pass++)
+	{
+		for(int i = 0; i < 2000; i++)
+		{
+			NETADDR Address;
+			RandomAddr(&Address);
+			bool Expected = false;
+			for(const auto &Range : vRanges)
+				Expected = Expected || NetBan.MatchesRange(&Range, &Address);
+			char aBuf[256];
+			ASSERT_EQ(NetBan.IsBanned(&Address, aBuf, sizeof(aBuf)), Expected);
+		}
+
+		// remove every second range and check again
+		for(size_t i = 0; i < vRanges.size(); i++)
+			EXPECT_EQ(NetBan.UnbanByRange(&vRanges[i]), 0);
+		std::vector<CNetRange> vKept;
+		for(size_t i = 0; i < vRanges.size(); i += 2)
+		{
+			EXPECT_EQ(NetBan.BanRange(&vRanges[i], 0, "test"), 0);
+			vKept.push_back(vRanges[i]);
+		}
+		vRanges = vKept;
+	}
+
+	for(const auto &Range : vRanges)
+		EXPECT_EQ(NetBan.UnbanByRange(&Range), 0);
+	EXPECT_EQ(NetBan.NumTrieNodes(), 2);
+}
+
+TEST(NetBan, Import)
+{
+	auto pConsole = CreateConsole(CFGFLAG_SERVER);
+	CNetBan NetBan;
+	NetBan.Init(pConsole.get(), nullptr);
+
+	EXPECT_EQ(Import(NetBan, "# hosting provider\n"
+				 "5.6.0.0/16\n"
+				 "\n"
+				 "  7.7.7.7\n"
+				 "8.8.8.0 - 8.8.8.127\n"
+				 "2a01:4f8::/29\r\n"
+				 "invalid\n"
+				 "127.0.0.0/8\n"),
+		4);
+	EXPECT_TRUE(Banned(NetBan, "5.6.255.1"));
+	EXPECT_TRUE(Banned(NetBan, "7.7.7.7"));
+	EXPECT_FALSE(Banned(NetBan, "7.7.7.8"));
+	EXPECT_TRUE(Banned(NetBan, "8.8.8.127"));
+	EXPECT_FALSE(Banned(NetBan, "8.8.8.128"));
+	EXPECT_TRUE(Banned(NetBan, "[2a01:4ff:ffff::1]"));
+	EXPECT_FALSE(Banned(NetBan, "[2a01:500::1]"));
+	EXPECT_FALSE(Banned(NetBan, "127.0.0.1"));
+}
+
+TEST(NetBan, ImportedLookups)
+{
+	auto pConsole = CreateConsole(CFGFLAG_SERVER);
+	CTestNetBan NetBan;
+	NetBan.Init(pConsole.get(), nullptr);
+
+	unsigned Seed = 1;
+	auto Random = [&Seed]() {
+		Seed = Seed * 1103515245 + 12345;
+		return Seed >> 8;
+	};
+
+	// prefixes of different lengths in 20.0.0.0/8, like a vpn and hosting list
+	std::string List;
+	std::vector<CNetRange> vRanges;
+	for(int i = 0; i < 1000; i++)
+	{
+		char aLine[64];
+		str_format(aLine, sizeof(aLine), "20.%d.%d.%d/%d", Random() % 16, Random() % 256, Random() % 256, 12 + Random() % 21);
+		CNetRange Range;
+		ASSERT_TRUE(CNetBan::NetRangeFromStr(&Range, aLine)) << aLine;
+		vRanges.push_back(Range);
+		List += aLine;
+		List += '\n';
+	}
+	EXPECT_GT(Import(NetBan, List.c_str()), 0);
+
+	int NumBanned = 0;
+	const int NumLookups = 5000;
+	for(int i = 0; i < NumLookups; i++)
+	{
+		NETADDR Address = NETADDR_ZEROED;
+		Address.type = NETTYPE_IPV4;
+		Address.ip[0] = 20;
+		Address.ip[1] = Random() % 32;
+		Address.ip[2] = Random();
+		Address.ip[3] = Random();
+		bool Expected = false;
+		for(const auto &Range : vRanges)
+			Expected = Expected || NetBan.MatchesRange(&Range, &Address);
+		char aBuf[256];
+		ASSERT_EQ(NetBan.IsBanned(&Address, aBuf, sizeof(aBuf)), Expected);
+		NumBanned += Expected;
+	}
+	EXPECT_GT(NumBanned, 0);
+	EXPECT_LT(NumBanned, NumLookups);
+}
@@ -0,0 +1,105 @@
+#include "test.h"
+#include <gtest/gtest.h>
+
+#include <base/system.h>
+#include <engine/shared/profiler.h>
+
+#include <iterator> // std::size
+#include <limits>
+
+static const char *const s_apScopes[] = {"first", "second"};
+
+static int64_t Microseconds(int64_t Us)
+{
+	return Us * time_freq() / 1000000;
+}
+
+TEST(Profiler, BucketIndex)
+{
+	EXPECT_EQ(CProfiler::BucketIndex(0), 0);
+	EXPECT_EQ(CProfiler::BucketIndex(1), 0);
+	EXPECT_EQ(CProfiler::BucketIndex(2), 1);
+	EXPECT_EQ(CProfiler::BucketIndex(3), 1);
+	EXPECT_EQ(CProfiler::BucketIndex(4), 2);
+	EXPECT_EQ(CProfiler::BucketIndex(1023), 9);
+	EXPECT_EQ(CProfiler::BucketIndex(1024), 10);
+	EXPECT_EQ(CProfiler::BucketIndex(std::numeric_limits<int64_t>::max()), CProfiler::NUM_BUCKETS - 1);
+	EXPECT_EQ(CProfiler::BucketUpperBound(0), 2);
+	EXPECT_EQ(CProfiler::BucketUpperBound(9), 1024);
+}
+
+TEST(Profiler, Sampling)
+{
+	CProfiler Profiler;
+	Profiler.Init(s_apScopes, std::size(s_apScopes));
+	EXPECT_FALSE(Profiler.BeginSample());
+
+	Profiler.SetSampleInterval(3);
+	int NumSampled = 0;
+	for(int i = 0; i < 9; i++)
+	{
+		if(Profiler.BeginSample())
+		{
+			NumSampled++;
+			CProfileScope Scope(&Profiler, 0);
+		}
+		Profiler.EndSample();
+		CProfileScope Scope(&Profiler, 1);
+	}
+	EXPECT_EQ(NumSampled, 3);
+	EXPECT_EQ(Profiler.NumSamples(), 3);
+	EXPECT_EQ(Profiler.Stats(0).m_NumSamples, 3);
+	EXPECT_EQ(Profiler.Stats(1).m_NumSamples, 0);
+
+	Profiler.SetSampleInterval(0);
+	EXPECT_FALSE(Profiler.BeginSample());
+}
+
+TEST(Profiler, Histogram)
+{
+	CProfiler Profiler;
+	Profiler.Init(s_apScopes, std::size(s_apScopes));
+	for(int i = 0; i < 98; i++)
+		Profiler.Record(0, Microseconds(100));
+	Profiler.Record(0, Microseconds(5000));
+	Profiler.Record(0, Microseconds(20000));
+
+	const CProfiler::CScopeStats &Stats = Profiler.Stats(0);
+	EXPECT_STREQ(Stats.m_pName, "first");
+	EXPECT_EQ(Stats.m_NumSamples, 100);
+	EXPECT_EQ(Stats.m_MaxTime, 20000);
+	EXPECT_EQ(Stats.Average(), (98 * 100 + 5000 + 20000) / 100);
+	EXPECT_EQ(Stats.m_aBuckets[CProfiler::BucketIndex(100)], 98);
+	EXPECT_EQ(Stats.Percentile(50.0f), 128);
+	EXPECT_EQ(Stats.Percentile(99.0f), 8192);
+	EXPECT_EQ(Stats.Percentile(100.0f), 20000);
+
+	Profiler.Reset();
+	EXPECT_EQ(Profiler.Stats(0).m_NumSamples, 0);
+	EXPECT_EQ(Profiler.Stats(0).Percentile(50.0f), 0);
+}
+
+TEST(Profiler, Csv)
+{
+	CTestInfo Info;
+	CProfiler Profiler;
+	Profiler.Init(s_apScopes, std::size(s_apScopes));
+	Profiler.Record(1, Microseconds(3));
+
+	IOHANDLE File = io_open(Info.m_aFilename, IOFLAG_WRITE);
+	ASSERT_TRUE(File);
+	Profiler.WriteCsv(File, "map,name");
+	io_close(File);
+
+	File = io_open(Info.m_aFilename, IOFLAG_READ);
+	ASSERT_TRUE(File);
+	char *pData = io_read_all_str(File);
+	io_close(File);
+	fs_remove(Info.m_aFilename);
+	ASSERT_TRUE(pData);
+
+	EXPECT_TRUE(str_startswith(pData, "tag,scope,bucket_upper_us,count"));
+	EXPECT_TRUE(str_find(pData, "\"map,name\",second,4,1"));
+	EXPECT_TRUE(str_find(pData, "\"map,name\",first,inf,0"));
+	free(pData);
+}
@@ -0,0 +1,111 @@
+#include <gtest/gtest.h>
+
+#include <engine/shared/json.h>
+#include <engine/shared/jsonwriter.h>
+#include <engine/shared/trace.h>
+
+TEST(Trace, Disabled)
+{
+	CTraceRecorder Recorder;
+	{
+		CTraceScope Scope(&Recorder, "a");
+	}
+	EXPECT_EQ(Recorder.NumEvents(), 0u);
+}
+
+TEST(Trace, Order)
+{
+	CTraceRecorder Recorder;
+	Recorder.SetEnabled(true, 16);
+	{
+		CTraceScope Outer(&Recorder, "outer");
+		CTraceScope Inner(&Recorder, "inner");
+	}
+	ASSERT_EQ(Recorder.NumEvents(), 4u);
+	EXPECT_STREQ(Recorder.Event(0).m_pName, "outer");
+	EXPECT_EQ(Recorder.Event(0).m_Phase, CTraceRecorder::PHASE_BEGIN);
+	EXPECT_STREQ(Recorder.Event(1).m_pName, "inner");
+	EXPECT_STREQ(Recorder.Event(2).m_pName, "inner");
+	EXPECT_EQ(Recorder.Event(2).m_Phase, CTraceRecorder::PHASE_END);
+	EXPECT_STREQ(Recorder.Event(3).m_pName, "outer");
+	for(size_t i = 1; i < Recorder.NumEvents(); i++)
+		EXPECT_LE(Recorder.Event(i - 1).m_Time, Recorder.Event(i).m_Time);
+
+	Recorder.SetEnabled(false, 16);
+	Recorder.Begin("ignored");
+	EXPECT_EQ(Recorder.NumEvents(), 4u);
+	Recorder.Clear();
+	EXPECT_EQ(Recorder.NumEvents(), 0u);
+}
+
+TEST(Trace, RingBuffer)
+{
+	CTraceRecorder Recorder;
+	Recorder.SetEnabled(true, 3);
+	Recorder.Begin("a");
+	Recorder.End("a");
+	Recorder.Begin("b");
+	Recorder.End("b");
+	ASSERT_EQ(Recorder.NumEvents(), 3u);
+	EXPECT_STREQ(Recorder.Event(0).m_pName, "a");
+	EXPECT_EQ(Recorder.Event(0).m_Phase, CTraceRecorder::PHASE_END);
+	EXPECT_STREQ(Recorder.Event(2).m_pName, "b");
+	EXPECT_EQ(Recorder.Event(2).m_Phase, CTraceRecorder::PHASE_END);
+}
+
+TEST(Trace, ChromeTrace)
+{
+	CTraceRecorder Recorder;
+	Recorder.SetEnabled(true, 3);
+	Recorder.Begin("a");
+	Recorder.End("a");
+	Recorder.Begin("b \"quoted\"");
+	Recorder.End("b \"quoted\"");
+
+	CJsonStringWriter Writer;
+	Recorder.WriteChromeTrace(&Writer);
+	std::string Output = Writer.GetOutputString();
+
+	json_value *pJson = json_parse(Output.c_str(), Output.size());
+	ASSERT_TRUE(pJson);
+	const json_value &Events = (*pJson)["traceEvents"];
+	ASSERT_EQ(Events.type, json_array);
+	// the end event of "a" lost its begin event and is skipped
+	ASSERT_EQ(json_array_length(&Events), 2);
+	EXPECT_STREQ(json_string_get(&Events[0]["name"]), "b \"quoted\"");
+	EXPECT_STREQ(json_string_get(&Events[0]["ph"]), "B");
+	EXPECT_STREQ(json_string_get(&Events[1]["ph"]), "E");
+	EXPECT_EQ(Events[1]["pid"].type, json_integer);
+	EXPECT_GE(json_int_get(&Events[1]["ts"]), json_int_get(&Events[0]["ts"]));
+	json_value_free(pJson);
+}
+
+TEST(Trace, Summary)
+{
+	CTraceRecorder Recorder;
+	Recorder.SetEnabled(true, 16);
+	CTraceSummary Summary;
+	for(int i = 0; i < 2; i++)
+	{
+		{
+			CTraceScope Outer(&Recorder, "outer");
+			CTraceScope Inner(&Recorder, "inner");
+		}
+		Recorder.End("unmatched");
+		Summary.Add(Recorder);
+		Recorder.Clear();
+	}
+
+	ASSERT_EQ(Summary.Scopes().size(), 2u);
+	const CTraceSummary::CScope &Inner = Summary.Scopes()[0];
+	const CTraceSummary::CScope &Outer = Summary.Scopes()[1];
+	EXPECT_STREQ(Inner.m_pName, "inner");
+	EXPECT_STREQ(Outer.m_pName, "outer");
+	EXPECT_EQ(Inner.m_Count, 2);
+	EXPECT_EQ(Outer.m_Count, 2);
+	EXPECT_GE(Outer.m_TotalTime, Inner.m_TotalTime);
+	EXPECT_LE(Outer.m_MaxTime, Outer.m_TotalTime);
+
+	Summary.Reset();
+	EXPECT_TRUE(Summary.Scopes().empty());
+}
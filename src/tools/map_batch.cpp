@@ -0,0 +1,260 @@
+#include "map_batch.h"
+
+#include <base/hash_ctxt.h>
+#include <base/logger.h>
+#include <base/math.h>
+#include <base/system.h>
+
+#include <engine/shared/jobs.h>
+#include <engine/shared/linereader.h>
+#include <engine/storage.h>
+
+#include <algorithm>
+#include <map>
+#include <memory>
+#include <thread>
+
+bool CMapBatchOptions::Parse(int argc, const char **argv)
+{
+	for(int i = 1; i < argc; i++)
+	{
+		if(str_comp(argv[i], "-j") == 0 && i + 1 < argc)
+		{
+			if(!str_toint(argv[++i], &m_NumThreads) || m_NumThreads < 1)
+				return false;
+		}
+		else if(str_comp(argv[i], "-c") == 0 && i + 1 < argc)
+			m_pCacheFile = argv[++i];
+		else if(str_comp(argv[i], "-l") == 0)
+			m_MapList = true;
+		else
+			m_vpArgs.push_back(argv[i]);
+	}
+	return true;
+}
+
+bool CMapBatchOptions::IsBatch() const
+{
+	return m_NumThreads > 0 || m_pCacheFile || m_MapList || (!m_vpArgs.empty() && fs_is_dir(m_vpArgs[0]));
+}
+
+class CMapBatchJob : public IJob
+{
+	IStorage *m_pStorage;
+	const FMapBatchProcess &m_Process;
+
+	void Run() override
+	{
+		fs_makedir_rec_for(m_Map.m_Destination.c_str());
+		m_Success = m_Process(m_pStorage, m_Map);
+	}
+
+public:
+	CMapBatchMap m_Map;
+	bool m_Success = false;
+
+	CMapBatchJob(IStorage *pStorage, const FMapBatchProcess &Process, const CMapBatchMap &Map) :
+		m_pStorage(pStorage), m_Process(Process), m_Map(Map) {}
+};
+
+struct SMapBatchListContext
+{
+	std::string m_Root;
+	std::string m_Relative;
+	std::vector<std::string> *m_pvMaps;
+};
+
+static int MapBatchListdirCallback(const char *pName, int IsDir, int DirType, void *pUser)
+{
+	SMapBatchListContext *pContext = static_cast<SMapBatchListContext *>(pUser);
+	if(str_comp(pName, ".") == 0 || str_comp(pName, "..") == 0)
+		return 0;
+
+	const std::string Relative = pContext->m_Relative.empty() ? pName : pContext->m_Relative + "/" + pName;
+	if(IsDir)
+	{
+		SMapBatchListContext SubContext = {pContext->m_Root, Relative, pContext->m_pvMaps};
+		fs_listdir((pContext->m_Root + "/" + Relative).c_str(), MapBatchListdirCallback, DirType, &SubContext);
+	}
+	else if(str_endswith(pName, ".map"))
+	{
+		pContext->m_pvMaps->push_back(Relative);
+	}
+	return 0;
+}
+
+// Hashes the source map and all additional inputs of a map, missing files hash differently from empty ones.
+static SHA256_DIGEST MapBatchHash(IStorage *pStorage, const CMapBatchMap &Map)
+{
+	SHA256_CTX Ctx;
+	sha256_init(&Ctx);
+	auto AddFile = [&](const std::string &Filename) {
+		sha256_update(&Ctx, Filename.c_str(), Filename.size() + 1);
+		SHA256_DIGEST Sha256;
+		if(pStorage->CalculateHashes(Filename.c_str(), IStorage::TYPE_ABSOLUTE, &Sha256))
+			sha256_update(&Ctx, Sha256.data, sizeof(Sha256.data));
+	};
+	AddFile(Map.m_Source);
+	for(const std::string &Input : Map.m_vInputs)
+		AddFile(Input);
+	return sha256_finish(&Ctx);
+}
+
+// cache lines are "<sha256>\t<source>[\t<input>...]"
+static void MapBatchLoadCache(const char *pCacheFile, std::map<std::string, std::pair<SHA256_DIGEST, std::vector<std::string>>> &Cache)
+{
+	CLineReader LineReader;
+	if(!LineReader.OpenFile(io_open(pCacheFile, IOFLAG_READ)))
+		return;
+
+	while(const char *pLine = LineReader.Get())
+	{
+		std::vector<std::string> vFields;
+		for(const char *pField = pLine;;)
+		{
+			const char *pEnd = str_find(pField, "\t");
+			vFields.emplace_back(pField, pEnd ? pEnd - pField : str_length(pField));
+			if(!pEnd)
+				break;
+			pField = pEnd + 1;
+		}
+		SHA256_DIGEST Sha256;
+		if(vFields.size() < 2 || sha256_from_str(&Sha256, vFields[0].c_str()) != 0)
+			continue;
+		Cache[vFields[1]] = {Sha256, std::vector<std::string>(vFields.begin() + 2, vFields.end())};
+	}
+}
+
+static bool MapBatchSaveCache(const char *pCacheFile, const std::map<std::string, std::pair<SHA256_DIGEST, std::vector<std::string>>> &Cache)
+{
+	IOHANDLE File = io_open(pCacheFile, IOFLAG_WRITE);
+	if(!File)
+		return false;
+
+	for(const auto &[Source, Entry] : Cache)
+	{
+		char aSha256[SHA256_MAXSTRSIZE];
+		sha256_str(Entry.first, aSha256, sizeof(aSha256));
+		io_write(File, aSha256, str_length(aSha256));
+		io_write(File, "\t", 1);
+		io_write(File, Source.c_str(), Source.size());
+		for(const std::string &Input : Entry.second)
+		{
+			io_write(File, "\t", 1);
+			io_write(File, Input.c_str(), Input.size());
+		}
+		io_write_newline(File);
+	}
+	io_close(File);
+	return true;
+}
+
+int RunMapBatch(const char *pToolName, IStorage *pStorage, const CMapBatchOptions &Options, const char *pDefaultDestination, const FMapBatchProcess &Process)
+{
+	if(Options.m_vpArgs.empty() || Options.m_vpArgs.size() > 2 || (Options.m_vpArgs.size() == 1 && !pDefaultDestination))
+	{
+		log_error(pToolName, "Usage: %s [-j <threads>] [-c <cache file>] [-l] <source directory|map list|map> %s", pToolName, pDefaultDestination ? "[<destination directory>]" : "<destination directory>");
+		return -1;
+	}
+
+	const char *pSource = Options.m_vpArgs[0];
+	const char *pDestination = Options.m_vpArgs.size() == 2 ? Options.m_vpArgs[1] : pDefaultDestination;
+
+	// collect the maps, keeping the directory structure below the source directory
+	std::vector<CMapBatchMap> vMaps;
+	if(Options.m_MapList)
+	{
+		CLineReader LineReader;
+		if(!LineReader.OpenFile(io_open(pSource, IOFLAG_READ)))
+		{
+			log_error(pToolName, "Failed to open map list '%s'", pSource);
+			return -1;
+		}
+		while(const char *pLine = LineReader.Get())
+		{
+			char aLine[IO_MAX_PATH_LENGTH];
+			str_copy(aLine, str_utf8_skip_whitespaces(pLine));
+			str_utf8_trim_right(aLine);
+			if(aLine[0] == '\0' || aLine[0] == '#')
+				continue;
+			vMaps.push_back({aLine, std::string(pDestination) + "/" + fs_filename(aLine), {}});
+		}
+	}
+	else if(fs_is_dir(pSource))
+	{
+		std::vector<std::string> vRelative;
+		SMapBatchListContext Context = {pSource, "", &vRelative};
+		fs_listdir(pSource, MapBatchListdirCallback, 0, &Context);
+		std::sort(vRelative.begin(), vRelative.end());
+		for(const std::string &Relative : vRelative)
+			vMaps.push_back({std::string(pSource) + "/" + Relative, std::string(pDestination) + "/" + Relative, {}});
+	}
+	else
+	{
+		// a single map, e.g. when only -j or -c was given
+		vMaps.push_back({pSource, std::string(pDestination) + "/" + fs_filename(pSource), {}});
+	}
+
+	std::map<std::string, std::pair<SHA256_DIGEST, std::vector<std::string>>> Cache;
+	if(Options.m_pCacheFile)
+		MapBatchLoadCache(Options.m_pCacheFile, Cache);
+
+	const int NumThreads = Options.m_NumThreads > 0 ? Options.m_NumThreads : maximum<int>(std::thread::hardware_concurrency(), 1);
+	CJobPool Pool;
+	Pool.Init(minimum<int>(NumThreads, maximum<int>(vMaps.size(), 1)));
+
+	// list entries are flattened to their file name, maps with the same name would overwrite each other
+	std::map<std::string, int> DestinationCount;
+	for(const CMapBatchMap &Map : vMaps)
+		DestinationCount[Map.m_Destination]++;
+
+	std::vector<std::shared_ptr<CMapBatchJob>> vpJobs;
+	int NumSkipped = 0;
+	int NumFailed = 0;
+	for(CMapBatchMap &Map : vMaps)
+	{
+		if(DestinationCount[Map.m_Destination] > 1)
+		{
+			log_error(pToolName, "Not processing '%s', several maps would be written to '%s'", Map.m_Source.c_str(), Map.m_Destination.c_str());
+			Cache.erase(Map.m_Source);
+			NumFailed++;
+			continue;
+		}
+
+		auto Cached = Cache.find(Map.m_Source);
+		if(Cached != Cache.end() && fs_is_file(Map.m_Destination.c_str()))
+		{
+			Map.m_vInputs = Cached->second.second;
+			if(MapBatchHash(pStorage, Map) == Cached->second.first)
+			{
+				NumSkipped++;
+				continue;
+			}
+			Map.m_vInputs.clear();
+		}
+		vpJobs.push_back(std::make_shared<CMapBatchJob>(pStorage, Process, Map));
+		Pool.Add(vpJobs.back());
+	}
+	// waits for all jobs to finish
+	Pool.Shutdown();
+
+	for(const auto &pJob : vpJobs)
+	{
+		if(pJob->m_Success)
+		{
+			Cache[pJob->m_Map.m_Source] = {MapBatchHash(pStorage, pJob->m_Map), pJob->m_Map.m_vInputs};
+		}
+		else
+		{
+			log_error(pToolName, "Failed to process '%s'", pJob->m_Map.m_Source.c_str());
+			Cache.erase(pJob->m_Map.m_Source);
+			NumFailed++;
+		}
+	}
+
+	if(Options.m_pCacheFile && !MapBatchSaveCache(Options.m_pCacheFile, Cache))
+		log_error(pToolName, "Failed to write cache file '%s'", Options.m_pCacheFile);
+
+	log_info(pToolName, "Processed %d maps on %d threads, %d unchanged, %d failed", (int)vpJobs.size(), NumThreads, NumSkipped, NumFailed);
+	return NumFailed == 0 ? 0 : -1;
+}
@@ -0,0 +1,59 @@
+#ifndef TOOLS_MAP_BATCH_H
+#define TOOLS_MAP_BATCH_H
+
+#include <functional>
+#include <string>
+#include <vector>
+
+class IStorage;
+
+/*
+	Batch mode shared by the map tools: processes all maps of a directory
+	(recursively), of a text file listing one map per line or a single map,
+	on several threads. With a cache file, maps whose inputs did not change since the
+	last run are skipped.
+
+	Usage: <tool> [-j <threads>] [-c <cache file>] [-l] <source directory|map list|map> [<destination directory>]
+
+	-l reads the source as a map list, a single map is only processed in batch
+	mode if -j or -c is given.
+*/
+
+class CMapBatchMap
+{
+public:
+	std::string m_Source;
+	std::string m_Destination;
+	// additional files the result depends on, e.g. embedded mapres
+	std::vector<std::string> m_vInputs;
+};
+
+typedef std::function<bool(IStorage *pStorage, CMapBatchMap &Map)> FMapBatchProcess;
+
+class CMapBatchOptions
+{
+public:
+	int m_NumThreads = 0; // one per core
+	const char *m_pCacheFile = nullptr;
+	bool m_MapList = false;
+	std::vector<const char *> m_vpArgs;
+
+	bool Parse(int argc, const char **argv);
+	// single maps are processed the way the tools always did
+	bool IsBatch() const;
+};
+
+/**
+ * Processes all maps of a directory or map list in parallel.
+ *
+ * @param pToolName Name used for log messages.
+ * @param pStorage Storage passed to the process function, must be usable from several threads.
+ * @param Options Parsed command line, the first argument is the source, the optional second one the destination directory.
+ * @param pDefaultDestination Destination directory if none was given, `nullptr` if it is required.
+ * @param Process Processes a single map, called from the worker threads. The maps already run in parallel, so it should write with a single compression thread.
+ *
+ * @return `0` if all maps were processed successfully, `-1` otherwise.
+ */
+int RunMapBatch(const char *pToolName, IStorage *pStorage, const CMapBatchOptions &Options, const char *pDefaultDestination, const FMapBatchProcess &Process);
+
+#endif
@@ -8,6 +8,8 @@
 #include <game/mapitems.h>
 #include <vector>
 
+#include "map_batch.h"
+
 void ClearTransparentPixels(uint8_t *pImg, int Width, int Height)
 {
 	for(int y = 0; y < Height; ++y)
@@ -73,46 +75,22 @@ void GetImageSHA256(uint8_t *pImgBuff, int ImgSize, int Width, int Height, char
 	free(pNewImgBuff);
 }
 
-int main(int argc, const char **argv)
+static bool OptimizeMap(IStorage *pStorage, const char *pSourceFileName, const char *pDestFileName, int MaxCompressionThreads = 0)
 {
-	CCmdlineFix CmdlineFix(&argc, &argv);
-	log_set_global_logger_default();
-
-	IStorage *pStorage = CreateStorage(IStorage::STORAGETYPE_BASIC, argc, argv);
-	if(!pStorage || argc <= 1 || argc > 3)
-	{
-		dbg_msg("map_optimize", "Invalid parameters or other unknown error.");
-		dbg_msg("map_optimize", "Usage: map_optimize <source map filepath> [<dest map filepath>]");
-		return -1;
-	}
-
-	char aFileName[IO_MAX_PATH_LENGTH];
-	if(argc == 3)
-	{
-		str_format(aFileName, sizeof(aFileName), "out/%s", argv[2]);
-
-		fs_makedir_rec_for(aFileName);
-	}
-	else
-	{
-		fs_makedir("out");
-		char aBuff[IO_MAX_PATH_LENGTH];
-		IStorage::StripPathAndExtension(argv[1], aBuff, sizeof(aBuff));
-		str_format(aFileName, sizeof(aFileName), "out/%s.map", aBuff);
-	}
-
 	CDataFileReader Reader;
-	if(!Reader.Open(pStorage, argv[1], IStorage::TYPE_ABSOLUTE))
+	if(!Reader.Open(pStorage, pSourceFileName, IStorage::TYPE_ABSOLUTE))
 	{
-		dbg_msg("map_optimize", "Failed to open source file.");
-		return -1;
+		dbg_msg("map_optimize", "Failed to open source file '%s'.", pSourceFileName);
+		return false;
 	}
 
 	CDataFileWriter Writer;
-	if(!Writer.Open(pStorage, aFileName, IStorage::TYPE_ABSOLUTE))
+	Writer.SetMaxCompressionThreads(MaxCompressionThreads);
+	if(!Writer.Open(pStorage, pDestFileName, IStorage::TYPE_ABSOLUTE))
 	{
-		dbg_msg("map_optimize", "Failed to open target file.");
-		return -1;
+		dbg_msg("map_optimize", "Failed to open target file '%s'.", pDestFileName);
+		Reader.Close();
+		return false;
 	}
 
 	int aImageFlags[MAX_MAPIMAGES] = {
@@ -317,5 +295,45 @@ int main(int argc, const char **argv)
 	Reader.Close();
 	Writer.Finish();
 
-	return 0;
+	return true;
+}
+
+int main(int argc, const char **argv)
+{
+	CCmdlineFix CmdlineFix(&argc, &argv);
+	log_set_global_logger_default();
+
+	CMapBatchOptions Options;
+	IStorage *pStorage = CreateStorage(IStorage::STORAGETYPE_BASIC, argc, argv);
+	if(!pStorage || !Options.Parse(argc, argv) || Options.m_vpArgs.empty() || Options.m_vpArgs.size() > 2)
+	{
+		dbg_msg("map_optimize", "Invalid parameters or other unknown error.");
+		dbg_msg("map_optimize", "Usage: map_optimize <source map filepath> [<dest map filepath>]");
+		dbg_msg("map_optimize", "Usage: map_optimize [-j <threads>] [-c <cache file>] [-l] <source directory|map list|map> [<dest directory>]");
+		return -1;
+	}
+
+	if(Options.IsBatch())
+	{
+		return RunMapBatch("map_optimize", pStorage, Options, "out", [](IStorage *pBatchStorage, CMapBatchMap &Map) {
+			return OptimizeMap(pBatchStorage, Map.m_Source.c_str(), Map.m_Destination.c_str(), 1);
+		});
+	}
+
+	char aFileName[IO_MAX_PATH_LENGTH];
+	if(Options.m_vpArgs.size() == 2)
+	{
+		str_format(aFileName, sizeof(aFileName), "out/%s", Options.m_vpArgs[1]);
+
+		fs_makedir_rec_for(aFileName);
+	}
+	else
+	{
+		fs_makedir("out");
+		char aBuff[IO_MAX_PATH_LENGTH];
+		IStorage::StripPathAndExtension(Options.m_vpArgs[0], aBuff, sizeof(aBuff));
+		str_format(aFileName, sizeof(aFileName), "out/%s.map", aBuff);
+	}
+
+	return OptimizeMap(pStorage, Options.m_vpArgs[0], aFileName) ? 0 : -1;
 }
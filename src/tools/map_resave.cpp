@@ -7,9 +7,11 @@
 #include <engine/shared/datafile.h>
 #include <engine/storage.h>
 
+#include "map_batch.h"
+
 static const char *TOOL_NAME = "map_resave";
 
-static int ResaveMap(const char *pSourceMap, const char *pDestinationMap, IStorage *pStorage)
+static int ResaveMap(const char *pSourceMap, const char *pDestinationMap, IStorage *pStorage, int DestinationStorageType = IStorage::TYPE_SAVE, int MaxCompressionThreads = 0)
 {
 	CDataFileReader Reader;
 	if(!Reader.Open(pStorage, pSourceMap, IStorage::TYPE_ABSOLUTE))
@@ -19,7 +21,8 @@ static int ResaveMap(const char *pSourceMap, const char *pDestinationMap, IStora
 	}
 
 	CDataFileWriter Writer;
-	if(!Writer.Open(pStorage, pDestinationMap))
+	Writer.SetMaxCompressionThreads(MaxCompressionThreads);
+	if(!Writer.Open(pStorage, pDestinationMap, DestinationStorageType))
 	{
 		log_error(TOOL_NAME, "Failed to open destination map '%s' for writing", pDestinationMap);
 		Reader.Close();
@@ -62,9 +65,11 @@ int main(int argc, const char **argv)
 	CCmdlineFix CmdlineFix(&argc, &argv);
 	log_set_global_logger_default();
 
-	if(argc != 3)
+	CMapBatchOptions Options;
+	if(!Options.Parse(argc, argv) || (!Options.IsBatch() && Options.m_vpArgs.size() != 2))
 	{
 		log_error(TOOL_NAME, "Usage: %s <source map> <destination map>", TOOL_NAME);
+		log_error(TOOL_NAME, "Usage: %s [-j <threads>] [-c <cache file>] [-l] <source directory|map list|map> <destination directory>", TOOL_NAME);
 		return -1;
 	}
 
@@ -75,5 +80,12 @@ int main(int argc, const char **argv)
 		return -1;
 	}
 
-	return ResaveMap(argv[1], argv[2], pStorage);
+	if(Options.IsBatch())
+	{
+		return RunMapBatch(TOOL_NAME, pStorage, Options, nullptr, [](IStorage *pBatchStorage, CMapBatchMap &Map) {
+			return ResaveMap(Map.m_Source.c_str(), Map.m_Destination.c_str(), pBatchStorage, IStorage::TYPE_ABSOLUTE, 1) == 0;
+		});
+	}
+
+	return ResaveMap(Options.m_vpArgs[0], Options.m_vpArgs[1], pStorage);
 }